@@ -0,0 +1,312 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dictionary_private.h"
+
+static void *arenaAllocAligned(Arena *arena, size_t size, size_t align)
+{
+    ArenaBlock *block = arena->head;
+    size_t offset = block ? (block->used + align - 1) & ~(align - 1) : 0;
+    if(!block || offset + size > block->size)
+    {
+        size_t blockSize = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        block = (ArenaBlock *)malloc(sizeof(ArenaBlock) + blockSize);
+        if(!block) return NULL;
+
+        block->size = blockSize;
+        block->used = 0;
+        block->next = arena->head;
+        arena->head = block;
+        arena->blockCount++;
+        arena->reserved += blockSize;
+        offset = 0;
+        STATS_COUNT(STATS_ARENA_BLOCKS, 1);
+    }
+    STATS_COUNT(STATS_ARENA_ALLOCS, 1);
+
+    block->used = offset + size;
+    return block->data + offset;
+}
+
+void *arenaAlloc(Arena *arena, size_t size)
+{
+    return arenaAllocAligned(arena, size, sizeof(void *));
+}
+
+// Lepas semua blok sekaligus, O(jumlah blok)
+void arenaFree(Arena *arena)
+{
+    ArenaBlock *block = arena->head;
+    while(block)
+    {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->blockCount = 0;
+    arena->reserved = 0;
+}
+
+// Node yang sudah dihapus dipakai ulang lewat free list sebelum minta ke arena
+void *slabAlloc(Slab *slab)
+{
+    if(slab->freeList)
+    {
+        void *ptr = slab->freeList;
+        slab->freeList = *(void **)ptr;
+        STATS_COUNT(STATS_SLAB_REUSES, 1);
+        return ptr;
+    }
+    return arenaAlloc(slab->arena, slab->objectSize);
+}
+
+void slabFree(Slab *slab, void *ptr)
+{
+    if(!ptr) return;
+    *(void **)ptr = slab->freeList;
+    slab->freeList = ptr;
+}
+
+void slabInit(Slab *slab, size_t objectSize, Arena *arena)
+{
+    slab->freeList = NULL;
+    slab->objectSize = objectSize;
+    slab->arena = arena;
+}
+
+void slabReset(Slab *slab)
+{
+    slab->freeList = NULL;
+}
+
+static int resizeStringPool(StringPool *pool, size_t newSize)
+{
+    PoolSlot *slots = (PoolSlot *)calloc(newSize, sizeof(PoolSlot));
+    if(!slots) return 0;
+
+    for(size_t i = 0; i < pool->size; i++)
+    {
+        if(!pool->slots[i].str) continue;
+        size_t j = mixHash(pool->slots[i].hash) & (newSize - 1);
+        while(slots[j].str) j = (j + 1) & (newSize - 1);
+        slots[j] = pool->slots[i];
+    }
+
+    free(pool->slots);
+    pool->slots = slots;
+    pool->size = newSize;
+    return 1;
+}
+
+static int growStringPool(StringPool *pool)
+{
+    return resizeStringPool(pool, pool->size ? pool->size << 1 : STRING_POOL_INITIAL_SIZE);
+}
+
+// Ukuran pool untuk count string, sama dengan hasil internReserve pada pool kosong
+size_t stringPoolSizeFor(size_t count)
+{
+    size_t size = STRING_POOL_INITIAL_SIZE;
+    while(count > size / 2) size <<= 1;
+    return size;
+}
+
+// Perbesar pool sekali di awal untuk count string tambahan (mis. saat load snapshot)
+void internReserve(Dictionary *dict, size_t count)
+{
+    StringPool *pool = &dict->strings;
+    size_t size = stringPoolSizeFor(pool->count + count);
+    if(size > pool->size) resizeStringPool(pool, size);
+}
+
+// Simpan string sekali saja; string yang sama selalu dapat pointer yang sama.
+// Pemanggil memegang string itu sampai melepasnya dengan internRelease.
+const char *internString(Dictionary *dict, const char *str)
+{
+    if(!str) return NULL;
+    return internStringHashed(dict, str, hash(str));
+}
+
+// Cari slot untuk str; *found = 1 jika string yang sama sudah ada
+static PoolSlot *findPoolSlot(StringPool *pool, const char *str, unsigned int h, int *found)
+{
+    size_t mask = pool->size - 1;
+    size_t i = mixHash(h) & mask;
+    while(pool->slots[i].str)
+    {
+        if(pool->slots[i].hash == h && strcmp(pool->slots[i].str, str) == 0)
+        {
+            *found = 1;
+            return &pool->slots[i];
+        }
+        i = (i + 1) & mask;
+    }
+    *found = 0;
+    return &pool->slots[i];
+}
+
+// String ter-intern diambil dari slab per kelas panjang (8, 16, ..., 128
+// byte termasuk '\0'), jadi string yang dilepas bisa dipakai ulang oleh
+// string lain sepanjang itu. String yang lebih panjang memakai malloc.
+static int stringClass(size_t size)
+{
+    return size <= STRING_CLASSES * STRING_CLASS_BYTES ? (int)((size - 1) / STRING_CLASS_BYTES) : -1;
+}
+
+static char *allocString(Dictionary *dict, size_t size)
+{
+    int k = stringClass(size);
+    if(k < 0) return (char *)malloc(size);
+
+    Slab *slab = &dict->stringSlabs[k];
+    if(!slab->arena) slabInit(slab, (size_t)(k + 1) * STRING_CLASS_BYTES, &dict->wordArena);
+    return (char *)slabAlloc(slab);
+}
+
+// Sama seperti internString, untuk pemanggil yang sudah punya hash(str).
+// Setiap panggilan menambah satu pegangan yang nanti dilepas internRelease.
+const char *internStringHashed(Dictionary *dict, const char *str, unsigned int h)
+{
+    StringPool *pool = &dict->strings;
+    if(pool->count + 1 > pool->size / 2 && !growStringPool(pool)) return NULL;
+
+    int found;
+    PoolSlot *slot = findPoolSlot(pool, str, h, &found);
+    if(found)
+    {
+        if(!(slot->refs & POOL_PINNED)) slot->refs++;
+        return slot->str;
+    }
+
+    // string yang ada di snapshot yang dilayani dipakai dari sana (pin)
+    const char *mapped = snapshotFindString(dict, str, h);
+    if(mapped)
+    {
+        slot->str = mapped;
+        slot->hash = h;
+        slot->refs = POOL_PINNED;
+        pool->count++;
+        return mapped;
+    }
+
+    size_t len = strlen(str) + 1;
+    char *copy = allocString(dict, len);
+    if(!copy) return NULL;
+    memcpy(copy, str, len);
+
+    slot->str = copy;
+    slot->hash = h;
+    slot->refs = 1;
+    pool->count++;
+    return copy;
+}
+
+// Daftarkan string yang hidup di luar pool (mis. di snapshot yang di-mmap)
+// tanpa menyalinnya. str harus tetap ada sampai freeStringPool. String ini
+// tidak dihitung pemegangnya dan tidak pernah dilepas; string yang sama yang
+// sudah ada di pool ikut ditahan, karena snapshot bisa memakainya berkali-kali.
+const char *internAdopt(Dictionary *dict, const char *str, unsigned int h)
+{
+    StringPool *pool = &dict->strings;
+    if(pool->count + 1 > pool->size / 2 && !growStringPool(pool)) return NULL;
+
+    int found;
+    PoolSlot *slot = findPoolSlot(pool, str, h, &found);
+    if(found)
+    {
+        slot->refs = POOL_PINNED;
+        return slot->str;
+    }
+
+    slot->str = str;
+    slot->hash = h;
+    slot->refs = POOL_PINNED;
+    pool->count++;
+    return str;
+}
+
+// Kosongkan slot i tanpa tombstone: slot sesudahnya yang rantai probe-nya
+// melewati i digeser mundur, jadi pencarian tetap berhenti di slot kosong
+static void removePoolSlot(StringPool *pool, size_t i)
+{
+    size_t mask = pool->size - 1;
+    for(size_t j = (i + 1) & mask; pool->slots[j].str; j = (j + 1) & mask)
+    {
+        size_t home = mixHash(pool->slots[j].hash) & mask;
+        if(((j - home) & mask) >= ((j - i) & mask))
+        {
+            pool->slots[i] = pool->slots[j];
+            i = j;
+        }
+    }
+    memset(&pool->slots[i], 0, sizeof(PoolSlot));
+    pool->count--;
+}
+
+// Lepas satu pegangan pada string ter-intern. String yang tidak dipegang
+// lagi keluar dari pool dan dipensiunkan lewat epoch, karena pembaca tanpa
+// lock mungkin masih membacanya. Dipanggil dengan dictWriteBegin dipegang.
+void internRelease(Dictionary *dict, const char *interned)
+{
+    PoolSlot *slot = internSlot(dict, interned);
+    if(!slot || (slot->refs & POOL_PINNED) || --slot->refs > 0) return;
+
+    int k = stringClass(strlen(interned) + 1);
+    free(slot->listedBy);
+    removePoolSlot(&dict->strings, (size_t)(slot - dict->strings.slots));
+    retireNode(dict, k < 0 ? NULL : &dict->stringSlabs[k], (void *)interned);
+}
+
+// Cari string tanpa menambahkannya; NULL jika belum pernah di-intern dan
+// tidak ada di snapshot yang dilayani
+const char *internFind(Dictionary *dict, const char *str)
+{
+    if(!str) return NULL;
+
+    StringPool *pool = &dict->strings;
+    unsigned int h = hash(str);
+    int found = 0;
+    PoolSlot *slot = pool->slots ? findPoolSlot(pool, str, h, &found) : NULL;
+    return found ? slot->str : snapshotFindString(dict, str, h);
+}
+
+// Slot milik string yang sudah ter-intern, dicari lewat pointernya saja.
+// Pointer slot hanya berlaku sampai string berikutnya di-intern atau dilepas.
+PoolSlot *internSlot(Dictionary *dict, const char *interned)
+{
+    StringPool *pool = &dict->strings;
+    if(!pool->slots || !interned) return NULL;
+
+    size_t mask = pool->size - 1;
+    for(size_t i = mixHash(hash(interned)) & mask; pool->slots[i].str; i = (i + 1) & mask)
+        if(pool->slots[i].str == interned) return &pool->slots[i];
+    return NULL;
+}
+
+// Hash untuk pointer string ter-intern (set sinonim, graf), tanpa membaca isinya
+size_t pointerHash(const void *p)
+{
+    uint64_t x = (uint64_t)(uintptr_t)p;
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    return (size_t)x;
+}
+
+// Dipanggil sebelum closeSnapshot dan arenaFree(wordArena). String dari
+// slab ikut arena; hanya string panjang dari malloc yang dilepas satu-satu.
+void freeStringPool(Dictionary *dict)
+{
+    StringPool *pool = &dict->strings;
+    for(size_t i = 0; i < pool->size; i++)
+    {
+        const char *str = pool->slots[i].str;
+        if(str && !snapshotOwnsString(dict, str) && stringClass(strlen(str) + 1) < 0) free((void *)str);
+    }
+    for(int k = 0; k < STRING_CLASSES; k++) slabReset(&dict->stringSlabs[k]);
+    free(pool->slots);
+    pool->slots = NULL;
+    pool->size = 0;
+    pool->count = 0;
+}
@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dictionary_private.h"
+
+// Mode batch: perintah dibaca dari file atau stdin, satu per baris, dan
+// dijalankan per batch di bawah satu dictWriteBegin. Tidak ada sleep, clear
+// atau pause seperti di menu. Hasil get ditulis ke out, waktu tiap batch ke
+// stderr.
+//
+//   add <kata>                 tambah kata utama
+//   syn <kata> <sinonim>       tambah sinonim
+//   del <kata>                 hapus kata utama
+//   delsyn <kata> <sinonim>    hapus sinonim
+//   get <kata>                 tulis "Kata: sinonim1, sinonim2"
+//   stats                      tulis laporan printStats (lihat stats.c)
+//
+// Kolom dipisah tab; baris tanpa tab dipisah spasi (kata dengan spasi harus
+// memakai tab). Setiap kata dinormalisasi dengan trim_and_tocapital seperti
+// di menu. Baris kosong dan baris yang diawali '#' dilewati.
+
+enum { BATCH_ADD, BATCH_SYNONYM, BATCH_DELETE, BATCH_DELETE_SYNONYM, BATCH_GET, BATCH_STATS };
+
+static const struct
+{
+    const char *name;
+    int fields;             // jumlah kata setelah nama perintah
+} batchOps[] = {
+    {"add", 1}, {"syn", 2}, {"del", 1}, {"delsyn", 2}, {"get", 1}, {"stats", 0},
+};
+
+typedef struct BatchCommand
+{
+    int op;
+    size_t word, synonym;   // posisi di text
+} BatchCommand;
+
+typedef struct CommandBatch
+{
+    char *text;             // kata yang sudah dinormalisasi, dipisah '\0'
+    size_t textLen, textCap;
+    BatchCommand *commands;
+    size_t count, cap;
+} CommandBatch;
+
+typedef struct BatchStats
+{
+    size_t commands;
+    size_t results[EDIT_FAILED + 1];    // jumlah perintah per hasil EDIT_*
+} BatchStats;
+
+static int reserveBytes(char **buffer, size_t *cap, size_t needed)
+{
+    if(needed <= *cap) return 1;
+
+    size_t newCap = *cap ? *cap : 256;
+    while(newCap < needed) newCap *= 2;
+    char *grown = (char *)realloc(*buffer, newCap);
+    if(!grown) return 0;
+    *buffer = grown;
+    *cap = newCap;
+    return 1;
+}
+
+// Baca satu baris utuh berapa pun panjangnya, tanpa '\n'. 0 di akhir file,
+// -1 jika alokasi gagal. Dipakai juga oleh menu.
+int readLine(FILE *in, char **line, size_t *cap)
+{
+    size_t len = 0;
+    for(;;)
+    {
+        if(!reserveBytes(line, cap, len + 256)) return -1;
+        if(!fgets(*line + len, (int)(*cap - len), in)) return len > 0;
+        len += strlen(*line + len);
+        if(len > 0 && (*line)[len - 1] == '\n')
+        {
+            (*line)[--len] = '\0';
+            if(len > 0 && (*line)[len - 1] == '\r') (*line)[--len] = '\0';
+            return 1;
+        }
+    }
+}
+
+// Potong field berikutnya dari *cursor (in place); NULL jika habis
+static char *nextField(char **cursor, char separator)
+{
+    char *p = *cursor;
+    if(separator == ' ')
+        while(*p == ' ') p++;
+    if(*p == '\0') return NULL;
+
+    char *field = p;
+    while(*p && *p != separator) p++;
+    if(*p) *p++ = '\0';
+    *cursor = p;
+    return field;
+}
+
+static size_t pushText(CommandBatch *batch, const char *word)
+{
+    size_t len = strlen(word) + 1;
+    if(!reserveBytes(&batch->text, &batch->textCap, batch->textLen + len)) return (size_t)-1;
+    memcpy(batch->text + batch->textLen, word, len);
+    batch->textLen += len;
+    return batch->textLen - len;
+}
+
+// Ubah satu baris menjadi perintah di batch. Mengembalikan 0 jika barisnya
+// salah (sudah dilaporkan), -1 jika alokasi gagal.
+static int parseCommand(CommandBatch *batch, char *line, size_t lineNo)
+{
+    char separator = strchr(line, '\t') ? '\t' : ' ';
+    char *cursor = line;
+    char *name = nextField(&cursor, separator);
+    trim(name);
+
+    int op = -1;
+    for(size_t i = 0; i < sizeof(batchOps) / sizeof(batchOps[0]); i++)
+        if(strcmp(name, batchOps[i].name) == 0) op = (int)i;
+    if(op < 0)
+    {
+        fprintf(stderr, "line %zu: unknown command '%s'\n", lineNo, name);
+        return 0;
+    }
+
+    char *fields[2] = {NULL, NULL};
+    int count = 0;
+    for(char *field; (field = nextField(&cursor, separator));)
+    {
+        trim_and_tocapital(field);
+        if(field[0] == '\0') continue;
+        if(count == batchOps[op].fields)
+        {
+            count++;
+            break;
+        }
+        fields[count++] = field;
+    }
+    if(count != batchOps[op].fields)
+    {
+        fprintf(stderr, "line %zu: '%s' takes %d word%s\n", lineNo, name, batchOps[op].fields,
+                batchOps[op].fields != 1 ? "s" : "");
+        return 0;
+    }
+
+    if(batch->count == batch->cap)
+    {
+        size_t cap = batch->cap ? batch->cap * 2 : 1024;
+        BatchCommand *commands = (BatchCommand *)realloc(batch->commands, cap * sizeof(BatchCommand));
+        if(!commands) return -1;
+        batch->commands = commands;
+        batch->cap = cap;
+    }
+
+    BatchCommand *command = &batch->commands[batch->count];
+    command->op = op;
+    command->word = fields[0] ? pushText(batch, fields[0]) : 0;
+    command->synonym = fields[1] ? pushText(batch, fields[1]) : 0;
+    if(command->word == (size_t)-1 || command->synonym == (size_t)-1) return -1;
+    batch->count++;
+    return 1;
+}
+
+// get dijalankan di dalam batch, jadi melihat perubahan dari baris sebelumnya
+static void printQuery(Dictionary *dict, const char *word, FILE *out)
+{
+    WordEntry *entry = findWord(dict, word);
+    if(!entry)
+    {
+        fprintf(out, "%s: not found\n", word);
+        return;
+    }
+
+    fprintf(out, "%s:", word);
+    SynonymIter syn;
+    synonymIterInit(entry, &syn);
+    const char *separator = " ";
+    for(const char *synonym; (synonym = synonymNext(&syn)); separator = ", ")
+        fprintf(out, "%s%s", separator, synonym);
+    fputc('\n', out);
+}
+
+static void applyBatch(Dictionary *dict, CommandBatch *batch, FILE *out, BatchStats *stats)
+{
+    dictWriteBegin(dict);
+    // tabel langsung dibesarkan untuk semua kata baru, bukan berkali-kali dua kali lipat
+    size_t adds = 0;
+    for(size_t i = 0; i < batch->count; i++)
+        if(batch->commands[i].op == BATCH_ADD) adds++;
+    if(adds) hashTableReserve(dict, dict->index.count + adds);
+
+    for(size_t i = 0; i < batch->count; i++)
+    {
+        const BatchCommand *command = &batch->commands[i];
+        const char *word = batch->text + command->word;
+        const char *synonym = batch->text + command->synonym;
+        int status = EDIT_OK;
+        switch(command->op)
+        {
+        case BATCH_ADD:
+            status = addWordLocked(dict, word, 1);
+            break;
+        case BATCH_SYNONYM:
+            status = addSynonymLocked(dict, word, synonym, 1);
+            break;
+        case BATCH_DELETE:
+            status = deleteWordLocked(dict, word);
+            break;
+        case BATCH_DELETE_SYNONYM:
+            status = deleteSynonymLocked(dict, word, synonym);
+            break;
+        case BATCH_GET:
+            printQuery(dict, word, out);
+            break;
+        default:
+            // printStats menahan penulis sendiri, jadi batch dilepas sebentar
+            dictWriteEnd(dict);
+            printStats(dict, out);
+            dictWriteBegin(dict);
+            break;
+        }
+        stats->results[status]++;
+    }
+    dictWriteEnd(dict);
+    stats->commands += batch->count;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void printBatchStats(const char *label, const BatchStats *stats, double seconds)
+{
+    fprintf(stderr, "%s: %zu commands in %.1f ms (%.0f/s)", label, stats->commands, seconds * 1e3,
+            seconds > 0 ? stats->commands / seconds : 0.0);
+    size_t skipped = stats->results[EDIT_EXISTS] + stats->results[EDIT_NO_ENTRY] + stats->results[EDIT_NOT_FOUND];
+    if(skipped)
+        fprintf(stderr, ", %zu skipped (%zu already there, %zu without entry, %zu not found)", skipped,
+                stats->results[EDIT_EXISTS], stats->results[EDIT_NO_ENTRY], stats->results[EDIT_NOT_FOUND]);
+    if(stats->results[EDIT_FAILED]) fprintf(stderr, ", %zu out of memory", stats->results[EDIT_FAILED]);
+    fputc('\n', stderr);
+}
+
+// Jalankan perintah dari in sampai habis, batchSize perintah sekaligus
+// (0 = BATCH_COMMANDS). Semua perubahan masuk write-ahead log dan history
+// seperti dari menu, dan log di-sync sebelum kembali. Mengembalikan 1 jika
+// semua baris bisa dibaca dan log berhasil ditulis.
+int runBatch(Dictionary *dict, FILE *in, FILE *out, size_t batchSize)
+{
+    if(batchSize == 0) batchSize = BATCH_COMMANDS;
+
+    CommandBatch batch;
+    memset(&batch, 0, sizeof(batch));
+    BatchStats total;
+    memset(&total, 0, sizeof(total));
+    char *line = NULL;
+    size_t lineCap = 0, lineNo = 0, batchNo = 0;
+    int ok = 1, more = 1;
+    double start = now();
+
+    while(more && ok)
+    {
+        batch.count = 0;
+        batch.textLen = 0;
+        while(batch.count < batchSize && (more = readLine(in, &line, &lineCap)) > 0)
+        {
+            lineNo++;
+            char *text = line;
+            while(*text == ' ' || *text == '\t') text++;
+            if(*text == '\0' || *text == '#') continue;
+            if(parseCommand(&batch, text, lineNo) < 0)
+            {
+                ok = 0;
+                break;
+            }
+        }
+        if(more < 0 || ferror(in)) ok = 0;
+        if(batch.count == 0) continue;
+
+        BatchStats stats;
+        memset(&stats, 0, sizeof(stats));
+        double batchStart = now();
+        applyBatch(dict, &batch, out, &stats);
+        double elapsed = now() - batchStart;
+
+        char label[32];
+        snprintf(label, sizeof(label), "batch %zu", ++batchNo);
+        printBatchStats(label, &stats, elapsed);
+        total.commands += stats.commands;
+        for(int i = 0; i <= EDIT_FAILED; i++) total.results[i] += stats.results[i];
+    }
+
+    if(!walSync(dict))
+    {
+        fprintf(stderr, "Failed to write %s.\n", dict->walFile);
+        ok = 0;
+    }
+    printBatchStats("total", &total, now() - start);
+    if(fflush(out) != 0) ok = 0;
+
+    free(line);
+    free(batch.text);
+    free(batch.commands);
+    return ok;
+}
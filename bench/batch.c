@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../dictionary.h"
+
+/*
+    Benchmark lookup satu per satu (findWord) dibanding lookup batch (findWords).
+
+    gcc -O2 bench/batch.c arena.c dictionary.c epoch.c history.c hashtable.c trie.c loader.c snapshot.c wal.c text.c graph.c synonymset.c stream.c batch.c stats.c synonym.c -o bench_batch -pthread
+    ./bench_batch [jumlah kata] [jumlah lookup] [persen ketemu]
+
+    Kata yang dicari diambil acak dari kamus (plus kata yang tidak ada sesuai
+    persen ketemu), seperti kata-kata satu dokumen. Kamus dibuat cukup besar
+    supaya bucket dan entry tidak muat di cache.
+*/
+
+#define BENCH_ROUNDS 5      // diambil yang tercepat
+
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    // xorshift64*
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+// Kata ke-i: huruf kapital lalu huruf kecil, sama seperti bench/concurrency.c
+static char *makeWord(size_t i)
+{
+    char buffer[16];
+    size_t len = 0;
+    buffer[len++] = 'A' + (char)(i % 26);
+    i /= 26;
+    do
+    {
+        buffer[len++] = 'a' + (char)(i % 26);
+        i /= 26;
+    } while(i);
+    buffer[len] = '\0';
+    return strdup(buffer);
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+    size_t wordCount = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t lookups = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000000;
+    int hitPercent = argc > 3 ? atoi(argv[3]) : 90;
+    if(wordCount < 1 || lookups < 1 || hitPercent < 0 || hitPercent > 100)
+    {
+        fprintf(stderr, "usage: %s [words>=1] [lookups>=1] [hit percent 0-100]\n", argv[0]);
+        return 1;
+    }
+
+    // kata di atas wordCount tidak dimasukkan ke kamus
+    size_t totalWords = wordCount * 2;
+    char **words = (char **)malloc(totalWords * sizeof(char *));
+    const char **queries = (const char **)malloc(lookups * sizeof(char *));
+    WordEntry **single = (WordEntry **)malloc(lookups * sizeof(WordEntry *));
+    WordEntry **batch = (WordEntry **)malloc(lookups * sizeof(WordEntry *));
+    if(!words || !queries || !single || !batch) return 1;
+    for(size_t i = 0; i < totalWords; i++)
+        if(!(words[i] = makeWord(i))) return 1;
+
+    Dictionary *dict = dictionaryCreate(NULL, NULL);
+    if(!dict) return 1;
+    hashTableReserve(dict, wordCount);
+    for(size_t i = 0; i < wordCount; i++) insertWordEntry(dict, words[i]);
+
+    unsigned long long state = 88172645463325252ULL;
+    for(size_t i = 0; i < lookups; i++)
+    {
+        unsigned long long r = nextRandom(&state);
+        size_t base = (int)(r % 100) < hitPercent ? 0 : wordCount;
+        queries[i] = words[base + (r >> 8) % wordCount];
+    }
+
+    double bestSingle = 0, bestBatch = 0;
+    size_t foundSingle = 0, foundBatch = 0;
+    for(int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        dictReadBegin();
+        double start = now();
+        foundSingle = 0;
+        for(size_t i = 0; i < lookups; i++)
+            if((single[i] = findWord(dict, queries[i]))) foundSingle++;
+        double elapsed = now() - start;
+        if(!bestSingle || elapsed < bestSingle) bestSingle = elapsed;
+
+        start = now();
+        foundBatch = findWords(dict, queries, lookups, batch);
+        elapsed = now() - start;
+        if(!bestBatch || elapsed < bestBatch) bestBatch = elapsed;
+        dictReadEnd();
+    }
+
+    if(foundSingle != foundBatch || memcmp(single, batch, lookups * sizeof(WordEntry *)) != 0)
+    {
+        fprintf(stderr, "findWords and findWord disagree.\n");
+        return 1;
+    }
+
+    printf("%zu kata, %zu lookup, %zu ketemu, batch %d\n", wordCount, lookups, foundBatch, LOOKUP_BATCH);
+    printf("%-10s %14s\n", "", "lookups/s");
+    printf("%-10s %14.0f\n", "findWord", lookups / bestSingle);
+    printf("%-10s %14.0f %8.2fx\n", "findWords", lookups / bestBatch, bestSingle / bestBatch);
+
+    dictionaryFree(dict);
+    for(size_t i = 0; i < totalWords; i++) free(words[i]);
+    free(words);
+    free(queries);
+    free(single);
+    free(batch);
+    return 0;
+}
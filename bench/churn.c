@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../dictionary.h"
+
+/*
+    Benchmark churn: jutaan siklus tambah lalu hapus kata yang selalu baru,
+    untuk memastikan memori kamus tidak terus bertambah di proses yang
+    berjalan lama.
+
+    gcc -O2 bench/churn.c arena.c dictionary.c epoch.c history.c hashtable.c trie.c loader.c snapshot.c wal.c text.c graph.c synonymset.c stream.c batch.c stats.c synonym.c -o bench_churn -pthread
+    ./bench_churn [siklus] [kata tetap] [kata hidup] [sinonim per kata]
+
+    Kamus diisi dulu dengan kata tetap. Lalu setiap siklus menambah satu kata
+    baru beserta sinonimnya (juga string baru) lewat addWordLocked dan
+    addSynonymLocked, dan menghapus kata yang ditambahkan "kata hidup" siklus
+    sebelumnya lewat deleteWordLocked, jadi isi kamus tetap sama besar.
+    Riwayat ikut dicatat; ring-nya dibatasi HISTORY_CAPACITY.
+
+    RSS dicatat setiap sepersepuluh siklus. Setelah sepersepuluh pertama
+    (ring riwayat dan semua free list sudah terisi), RSS tidak boleh naik
+    lebih dari CHURN_RSS_SLACK; jika naik, program keluar dengan status 1.
+*/
+
+#define CHURN_RSS_SLACK (8 * 1024 * 1024)   // byte, untuk fragmentasi malloc
+#define CHURN_CHECKPOINTS 10
+
+// Kata ke-i dalam huruf kecil, diawali huruf kapital seperti kata utama
+static void makeWord(char *buffer, unsigned long long i, const char *suffix)
+{
+    size_t len = 0;
+    buffer[len++] = 'A' + (char)(i % 26);
+    i /= 26;
+    do
+    {
+        buffer[len++] = 'a' + (char)(i % 26);
+        i /= 26;
+    } while(i);
+    strcpy(buffer + len, suffix);
+}
+
+// RSS saat ini dari /proc; 0 jika tidak tersedia
+static long long currentRss(void)
+{
+    long long pages = 0, resident = 0;
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if(!fp) return 0;
+    if(fscanf(fp, "%lld %lld", &pages, &resident) != 2) resident = 0;
+    fclose(fp);
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Tambah kata ke-i beserta sinonimnya; 0 jika gagal
+static int addChurnWord(Dictionary *dict, unsigned long long i, int synonyms)
+{
+    char word[32], synonym[40];
+    makeWord(word, i, "");
+    if(addWordLocked(dict, word, 1) != EDIT_OK) return 0;
+    for(int s = 0; s < synonyms; s++)
+    {
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "syn%d", s);
+        makeWord(synonym, i, suffix);
+        if(addSynonymLocked(dict, word, synonym, 1) != EDIT_OK) return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long long cycles = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000ULL;
+    unsigned long long fixed = argc > 2 ? strtoull(argv[2], NULL, 10) : 100000;
+    unsigned long long live = argc > 3 ? strtoull(argv[3], NULL, 10) : 1000;
+    int synonyms = argc > 4 ? atoi(argv[4]) : 3;
+    if(cycles < CHURN_CHECKPOINTS || live < 1 || synonyms < 0)
+    {
+        fprintf(stderr, "usage: %s [cycles>=%d] [fixed words] [live words>=1] [synonyms per word]\n",
+                argv[0], CHURN_CHECKPOINTS);
+        return 1;
+    }
+
+    Dictionary *dict = dictionaryCreate(NULL, NULL);
+    if(!dict) return 1;
+
+    // kata tetap dan kata churn diambil dari rentang nomor yang berbeda
+    unsigned long long churnBase = fixed;
+    dictWriteBegin(dict);
+    for(unsigned long long i = 0; i < fixed; i++)
+        if(!addChurnWord(dict, i, synonyms)) return 1;
+    dictWriteEnd(dict);
+
+    long long rss[CHURN_CHECKPOINTS + 1];
+    rss[0] = currentRss();
+    printf("%llu siklus, %llu kata tetap, %llu kata hidup, %d sinonim per kata\n",
+           cycles, fixed, live, synonyms);
+    printf("%12s %12s %10s %10s\n", "siklus", "entry", "RSS MB", "ns/siklus");
+
+    double start = now();
+    unsigned long long done = 0;
+    for(int checkpoint = 1; checkpoint <= CHURN_CHECKPOINTS; checkpoint++)
+    {
+        unsigned long long until = cycles / CHURN_CHECKPOINTS * checkpoint;
+        double phase = now();
+        dictWriteBegin(dict);
+        for(; done < until; done++)
+        {
+            char word[32];
+            if(!addChurnWord(dict, churnBase + done, synonyms)) return 1;
+            if(done >= live)
+            {
+                makeWord(word, churnBase + done - live, "");
+                if(deleteWordLocked(dict, word) != EDIT_OK) return 1;
+            }
+        }
+        size_t entries = dictionaryWordCount(dict);
+        dictWriteEnd(dict);
+
+        rss[checkpoint] = currentRss();
+        printf("%12llu %12zu %10.1f %10.1f\n", done, entries, rss[checkpoint] / 1e6,
+               (now() - phase) * 1e9 / (cycles / CHURN_CHECKPOINTS));
+    }
+    double elapsed = now() - start;
+
+    // setelah checkpoint pertama ukuran kamus sudah tetap
+    long long growth = rss[CHURN_CHECKPOINTS] - rss[1];
+    printf("%.1f ns per siklus, RSS naik %.1f MB sejak checkpoint pertama\n",
+           elapsed * 1e9 / cycles, growth / 1e6);
+
+    dictionaryFree(dict);
+    if(rss[1] && growth > CHURN_RSS_SLACK)
+    {
+        fprintf(stderr, "Memory grew by %lld bytes over %llu cycles.\n", growth,
+                cycles - cycles / CHURN_CHECKPOINTS);
+        return 1;
+    }
+    return 0;
+}
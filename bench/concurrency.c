@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "../dictionary.h"
+
+/*
+    Benchmark baca/tulis campuran untuk kamus yang dipakai banyak thread.
+
+    gcc -O2 bench/concurrency.c arena.c dictionary.c epoch.c history.c hashtable.c trie.c loader.c snapshot.c wal.c text.c graph.c synonymset.c stream.c batch.c stats.c synonym.c -o bench_concurrency -pthread
+    ./bench_concurrency [jumlah kata] [detik per putaran] [persen tulis]
+
+    Setiap putaran (1, 2, 4, ..., 64 thread) menjalankan lookup findWord plus
+    penelusuran sinonim di dalam dictReadBegin/End, diselingi tambah/hapus
+    kata dan sinonim di dalam dictWriteBegin/End. WAL tidak dibuka, jadi yang
+    diukur hanya struktur data di memori.
+*/
+
+#define BENCH_MAX_THREADS 64
+#define BENCH_SYNONYMS 4    // sinonim awal per kata
+
+static Dictionary *dict;
+static char **words;
+static size_t baseWords, totalWords;    // kata di atas baseWords keluar-masuk selama benchmark
+static int writePercent = 5;
+static int stop;
+
+typedef struct BenchThread
+{
+    pthread_t thread;
+    unsigned long long seed;
+    unsigned long long reads, writes, found;
+} BenchThread;
+
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    // xorshift64*
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+// Kata ke-i: huruf kapital lalu huruf kecil, tanpa angka supaya trie menerimanya
+static char *makeWord(size_t i)
+{
+    char buffer[16];
+    size_t len = 0;
+    buffer[len++] = 'A' + (char)(i % 26);
+    i /= 26;
+    do
+    {
+        buffer[len++] = 'a' + (char)(i % 26);
+        i /= 26;
+    } while(i);
+    buffer[len] = '\0';
+    return strdup(buffer);
+}
+
+static void readOne(BenchThread *self, const char *word)
+{
+    dictReadBegin();
+    WordEntry *entry = findWord(dict, word);
+    if(entry)
+    {
+        self->found++;
+        SynonymIter syn;
+        synonymIterInit(entry, &syn);
+        for(const char *synonym; (synonym = synonymNext(&syn));)
+            if(synonym[0] == '\0') self->found++;    // paksa sinonim benar-benar dibaca
+    }
+    dictReadEnd();
+}
+
+static void writeOne(unsigned long long *state)
+{
+    unsigned long long r = nextRandom(state);
+    dictWriteBegin(dict);
+    if(r & 1)
+    {
+        // kata keluar-masuk: menguji rehash dan pensiun entry
+        const char *word = words[baseWords + (r >> 8) % (totalWords - baseWords)];
+        if(findWord(dict, word)) removeWordEntry(dict, word);
+        else insertWordEntry(dict, word);
+    }
+    else
+    {
+        WordEntry *entry = findWord(dict, words[(r >> 8) % baseWords]);
+        const char *synonym = words[(r >> 32) % baseWords];
+        if(entry && !removeSynonym(dict, entry, synonym))
+            appendSynonym(dict, entry, internString(dict, synonym));
+    }
+    dictWriteEnd(dict);
+}
+
+static void *benchWorker(void *arg)
+{
+    BenchThread *self = (BenchThread *)arg;
+    while(!__atomic_load_n(&stop, __ATOMIC_RELAXED))
+    {
+        // satu cek stop per 64 operasi
+        for(int k = 0; k < 64; k++)
+        {
+            unsigned long long r = nextRandom(&self->seed);
+            if((int)(r % 100) < writePercent)
+            {
+                writeOne(&self->seed);
+                self->writes++;
+            }
+            else
+            {
+                readOne(self, words[(r >> 8) % totalWords]);
+                self->reads++;
+            }
+        }
+    }
+    return NULL;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void preload(void)
+{
+    for(size_t i = 0; i < baseWords; i++) insertWordEntry(dict, words[i]);
+
+    unsigned long long state = 88172645463325252ULL;
+    for(size_t i = 0; i < baseWords; i++)
+    {
+        WordEntry *entry = findWord(dict, words[i]);
+        for(int k = 0; k < BENCH_SYNONYMS; k++)
+            appendSynonym(dict, entry, internString(dict, words[nextRandom(&state) % baseWords]));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    baseWords = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+    double seconds = argc > 2 ? atof(argv[2]) : 1.0;
+    if(argc > 3) writePercent = atoi(argv[3]);
+    if(baseWords < 2 || seconds <= 0 || writePercent < 0 || writePercent > 100)
+    {
+        fprintf(stderr, "usage: %s [words>=2] [seconds] [write percent 0-100]\n", argv[0]);
+        return 1;
+    }
+    totalWords = baseWords + baseWords / 8 + 1;
+
+    words = (char **)malloc(totalWords * sizeof(char *));
+    if(!words) return 1;
+    for(size_t i = 0; i < totalWords; i++)
+        if(!(words[i] = makeWord(i))) return 1;
+
+    dict = dictionaryCreate(NULL, NULL);
+    if(!dict) return 1;
+    preload();
+
+    printf("%zu kata, %d%% tulis, %.1f detik per putaran\n", baseWords, writePercent, seconds);
+    printf("%8s %14s %14s %14s %9s\n", "threads", "ops/s", "reads/s", "writes/s", "scaling");
+
+    static BenchThread threads[BENCH_MAX_THREADS];
+    double base = 0;
+    for(int n = 1; n <= BENCH_MAX_THREADS; n *= 2)
+    {
+        __atomic_store_n(&stop, 0, __ATOMIC_RELAXED);
+        memset(threads, 0, sizeof(threads));
+
+        double start = now();
+        for(int t = 0; t < n; t++)
+        {
+            threads[t].seed = 0x9E3779B97F4A7C15ULL * (t + 1) + n;
+            if(pthread_create(&threads[t].thread, NULL, benchWorker, &threads[t]) != 0)
+            {
+                fprintf(stderr, "Failed to create thread %d.\n", t);
+                n = t;
+                break;
+            }
+        }
+
+        struct timespec pause = {(time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9)};
+        nanosleep(&pause, NULL);
+        __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+
+        unsigned long long reads = 0, writes = 0;
+        for(int t = 0; t < n; t++)
+        {
+            pthread_join(threads[t].thread, NULL);
+            reads += threads[t].reads;
+            writes += threads[t].writes;
+        }
+        double elapsed = now() - start;
+
+        double ops = (reads + writes) / elapsed;
+        if(n == 1) base = ops;
+        printf("%8d %14.0f %14.0f %14.0f %8.2fx\n", n, ops, reads / elapsed, writes / elapsed,
+               base > 0 ? ops / base : 0);
+    }
+
+    dictionaryFree(dict);
+    for(size_t i = 0; i < totalWords; i++) free(words[i]);
+    free(words);
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../dictionary.h"
+
+/*
+    Benchmark pencarian fuzzy (trieFuzzy) untuk setiap jarak edit sampai
+    TRIE_FUZZY_DISTANCE (k=1 dan k=2). Query jarak 2 pertama membangun
+    indeks akhiran trie dan diukur sendiri, di luar persentil.
+
+    gcc -O2 bench/fuzzy.c arena.c dictionary.c epoch.c history.c hashtable.c trie.c loader.c snapshot.c wal.c text.c graph.c synonymset.c stream.c batch.c stats.c synonym.c -o bench_fuzzy -pthread
+    ./bench_fuzzy [jumlah kata] [jumlah query]
+
+    Dua kamus: huruf acak (4-12 huruf), yang paling buruk untuk trie karena
+    tidak ada awalan yang lebih umum dari yang lain, dan kata dari 2-4 suku
+    kata acak yang awalannya lebih mirip bahasa sungguhan. Query diambil
+    dari kata di kamus lalu diberi 0-2 salah ketik acak (sisip, hapus,
+    ganti), jadi sebagian query sengaja tidak punya hasil. Sebagian query
+    pertama juga dicek dengan membandingkan ke semua kata satu per satu.
+*/
+
+#define VERIFY_QUERIES 20   // query yang hasilnya dicek dengan brute force
+#define RESULT_LIMIT 1000000
+
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    // xorshift64*
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+static char *makeRandomWord(unsigned long long *state)
+{
+    char buffer[16];
+    size_t len = 4 + nextRandom(state) % 9;
+    for(size_t i = 0; i < len; i++) buffer[i] = 'a' + (char)(nextRandom(state) % 26);
+    buffer[0] -= 'a' - 'A';
+    buffer[len] = '\0';
+    return strdup(buffer);
+}
+
+static char *makeSyllableWord(unsigned long long *state)
+{
+    static const char *onsets[] = {"b", "d", "g", "h", "j", "k", "l", "m", "n", "p", "r", "s", "t", "w",
+                                   "br", "kr", "pr", "tr", "st", "ng", "ny", "sy"};
+    static const char vowels[] = "aiueo";
+    static const char codas[] = "\0\0\0nrstlkm";
+    char buffer[24];
+    size_t len = 0, syllables = 2 + nextRandom(state) % 3;
+    for(size_t i = 0; i < syllables; i++)
+    {
+        const char *onset = onsets[nextRandom(state) % (sizeof(onsets) / sizeof(onsets[0]))];
+        while(*onset) buffer[len++] = *onset++;
+        buffer[len++] = vowels[nextRandom(state) % 5];
+        char coda = codas[nextRandom(state) % (sizeof(codas) - 1)];
+        if(coda) buffer[len++] = coda;
+    }
+    buffer[0] -= 'a' - 'A';
+    buffer[len] = '\0';
+    return strdup(buffer);
+}
+
+// Salinan word dengan beberapa salah ketik acak
+static void makeTypo(const char *word, int edits, unsigned long long *state, char *out)
+{
+    strcpy(out, word);
+    for(int e = 0; e < edits; e++)
+    {
+        size_t len = strlen(out);
+        size_t pos = 1 + nextRandom(state) % len;      // huruf pertama tidak diubah
+        char c = 'a' + (char)(nextRandom(state) % 26);
+        switch(nextRandom(state) % 3)
+        {
+        case 0:
+            memmove(out + pos + 1, out + pos, len - pos + 1);
+            out[pos] = c;
+            break;
+        case 1:
+            if(pos < len && len > 2) memmove(out + pos, out + pos + 1, len - pos);
+            break;
+        default:
+            if(pos < len) out[pos] = c;
+            break;
+        }
+    }
+}
+
+static int distance(const char *a, const char *b, int *row)
+{
+    size_t m = strlen(b);
+    for(size_t j = 0; j <= m; j++) row[j] = (int)j;
+    for(size_t i = 1; a[i - 1]; i++)
+    {
+        int diag = row[0];
+        row[0] = (int)i;
+        for(size_t j = 1; j <= m; j++)
+        {
+            int up = row[j];
+            int cost = diag + (a[i - 1] != b[j - 1]);
+            if(up + 1 < cost) cost = up + 1;
+            if(row[j - 1] + 1 < cost) cost = row[j - 1] + 1;
+            row[j] = cost;
+            diag = up;
+        }
+    }
+    return row[m];
+}
+
+static int countResult(const char *word, int d, void *ctx)
+{
+    (void)word;
+    (void)d;
+    (*(size_t *)ctx)++;
+    return 1;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int compareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static int runWorkload(const char *label, char *(*makeWord)(unsigned long long *),
+                       size_t wordCount, size_t queryCount)
+{
+    char **words = (char **)malloc(wordCount * sizeof(char *));
+    char **keys = (char **)malloc(wordCount * sizeof(char *));
+    char (*queries)[32] = malloc(queryCount * sizeof(*queries));
+    double *latency = (double *)malloc(queryCount * sizeof(double));
+    if(!words || !queries || !keys || !latency) return 0;
+
+    unsigned long long state = 88172645463325252ULL;
+    Dictionary *dict = dictionaryCreate(NULL, NULL);
+    if(!dict) return 0;
+    hashTableReserve(dict, wordCount);
+    for(size_t i = 0; i < wordCount; i++)
+    {
+        if(!(words[i] = makeWord(&state))) return 0;
+        if(findWord(dict, words[i])) words[i][0] = '\0';   // kembar, tidak ikut dicek
+        else insertWordEntry(dict, words[i]);
+    }
+
+    for(size_t i = 0; i < queryCount; i++)
+    {
+        const char *word;
+        do word = words[nextRandom(&state) % wordCount]; while(!word[0]);
+        makeTypo(word, (int)(nextRandom(&state) % 3), &state, queries[i]);
+    }
+
+    // kunci trie untuk brute force: huruf kecil semua
+    for(size_t i = 0; i < wordCount; i++)
+    {
+        keys[i] = strdup(words[i]);
+        if(!keys[i]) return 0;
+        if(keys[i][0]) keys[i][0] += 'a' - 'A';
+    }
+
+    // query jarak 2 pertama membangun indeks akhiran trie; diukur terpisah
+    size_t warm = 0;
+    double buildStart = now();
+    trieFuzzy(dict, queries[0], TRIE_FUZZY_DISTANCE, RESULT_LIMIT, countResult, &warm);
+    double buildTime = now() - buildStart;
+
+    printf("\n%s: %zu kata, %zu query, query jarak %d pertama %.1f ms\n", label, wordCount, queryCount,
+           TRIE_FUZZY_DISTANCE, buildTime * 1e3);
+    printf("%-4s %12s %12s %12s %12s %14s\n", "k", "p50 us", "p99 us", "max us", "hasil/query", "brute us");
+    int row[64];
+    int ok = 1;
+    for(int k = 1; k <= TRIE_FUZZY_DISTANCE && ok; k++)
+    {
+        size_t results = 0;
+        for(size_t i = 0; i < queryCount; i++)
+        {
+            double start = now();
+            trieFuzzy(dict, queries[i], k, RESULT_LIMIT, countResult, &results);
+            latency[i] = now() - start;
+        }
+
+        // cek beberapa query pertama dengan membandingkan ke semua kata
+        double bruteTime = 0;
+        size_t verify = queryCount < VERIFY_QUERIES ? queryCount : VERIFY_QUERIES;
+        for(size_t i = 0; i < verify && ok; i++)
+        {
+            char query[32];
+            strcpy(query, queries[i]);
+            query[0] += 'a' - 'A';
+
+            size_t expected = 0, found = 0;
+            double start = now();
+            for(size_t w = 0; w < wordCount; w++)
+                if(keys[w][0] && distance(keys[w], query, row) <= k) expected++;
+            bruteTime += now() - start;
+
+            trieFuzzy(dict, queries[i], k, RESULT_LIMIT, countResult, &found);
+            if(found != expected)
+            {
+                fprintf(stderr, "trieFuzzy and brute force disagree on '%s' (k=%d): %zu vs %zu\n",
+                        queries[i], k, found, expected);
+                ok = 0;
+            }
+        }
+
+        qsort(latency, queryCount, sizeof(double), compareDouble);
+        if(ok)
+            printf("%-4d %12.1f %12.1f %12.1f %12.2f %14.1f\n", k,
+                   latency[queryCount / 2] * 1e6, latency[queryCount * 99 / 100] * 1e6,
+                   latency[queryCount - 1] * 1e6, (double)results / queryCount, bruteTime / verify * 1e6);
+    }
+
+    dictionaryFree(dict);
+    for(size_t i = 0; i < wordCount; i++)
+    {
+        free(words[i]);
+        free(keys[i]);
+    }
+    free(words);
+    free(keys);
+    free(queries);
+    free(latency);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    size_t wordCount = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t queryCount = argc > 2 ? strtoul(argv[2], NULL, 10) : 10000;
+    if(wordCount < 1 || queryCount < 1)
+    {
+        fprintf(stderr, "usage: %s [words>=1] [queries>=1]\n", argv[0]);
+        return 1;
+    }
+
+    if(!runWorkload("huruf acak", makeRandomWord, wordCount, queryCount)) return 1;
+    if(!runWorkload("suku kata", makeSyllableWord, wordCount, queryCount)) return 1;
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../dictionary.h"
+
+/*
+    Microbenchmark index kata: insert, lookup kata yang ada, lookup kata yang
+    tidak ada, dan remove langsung lewat hashTable*, tanpa trie, sinonim, atau
+    riwayat. Backend dipilih saat kompilasi, jadi program ini dikompilasi dua
+    kali dan hasilnya dibandingkan:
+
+    gcc -O2 bench/index.c arena.c dictionary.c epoch.c history.c hashtable.c trie.c loader.c snapshot.c wal.c text.c graph.c synonymset.c stream.c batch.c stats.c synonym.c -o bench_index_chain -pthread
+    gcc -O2 -DWORD_INDEX_OPEN bench/index.c arena.c dictionary.c epoch.c history.c hashtable.c trie.c loader.c snapshot.c wal.c text.c graph.c synonymset.c stream.c batch.c stats.c synonym.c -o bench_index_open -pthread
+    ./bench_index_chain [jumlah kata] [jumlah lookup] [persen kata panjang]
+    ./bench_index_open  [jumlah kata] [jumlah lookup] [persen kata panjang]
+    ./bench_index_chain sweep [kata terbanyak] [jumlah lookup] [persen kata panjang]
+
+    Kata panjang (INDEX_INLINE_KEY byte atau lebih) tidak muat di slot open
+    addressing, jadi persentasenya mengatur seberapa sering lookup harus
+    membaca WordEntry.
+
+    Mode sweep mengulang pengukuran untuk 1k, 10k, ... sampai kata
+    terbanyak (default 10 juta) dengan jumlah lookup yang sama, satu baris
+    per ukuran, untuk melihat apakah waktu lookup tetap datar. Isi tabel
+    dan jarak probe rata-rata ikut dicetak: keduanya harus tetap, jadi
+    kenaikan waktu pada ukuran besar berasal dari miss cache, bukan dari
+    rantai atau probe yang makin panjang.
+*/
+
+#define BENCH_ROUNDS 5      // diambil yang tercepat
+
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    // xorshift64*
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+// Kata ke-i seperti bench/batch.c; kata panjang diberi akhiran tetap
+static char *makeWord(size_t i, int longWord)
+{
+    char buffer[48];
+    size_t len = 0;
+    buffer[len++] = 'A' + (char)(i % 26);
+    i /= 26;
+    do
+    {
+        buffer[len++] = 'a' + (char)(i % 26);
+        i /= 26;
+    } while(i);
+    if(longWord)
+    {
+        memcpy(buffer + len, "ationalization", 14);
+        len += 14;
+    }
+    buffer[len] = '\0';
+    return strdup(buffer);
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void keepBest(double *best, double elapsed)
+{
+    if(!*best || elapsed < *best) *best = elapsed;
+}
+
+// Hasil satu ukuran index; waktu dalam detik, yang tercepat dari BENCH_ROUNDS
+typedef struct IndexTiming
+{
+    double insert, hit, miss, remove;
+    IndexStats stats;
+} IndexTiming;
+
+static int measure(size_t wordCount, size_t lookups, int longPercent, IndexTiming *t)
+{
+    // kata di atas wordCount tidak dimasukkan ke index
+    unsigned long long state = 88172645463325252ULL;
+    size_t totalWords = wordCount * 2;
+    char **words = (char **)malloc(totalWords * sizeof(char *));
+    WordEntry *entries = (WordEntry *)calloc(wordCount, sizeof(WordEntry));
+    const char **hits = (const char **)malloc(lookups * sizeof(char *));
+    const char **misses = (const char **)malloc(lookups * sizeof(char *));
+    if(!words || !entries || !hits || !misses) return 0;
+    for(size_t i = 0; i < totalWords; i++)
+        if(!(words[i] = makeWord(i, (int)(nextRandom(&state) % 100) < longPercent))) return 0;
+    for(size_t i = 0; i < wordCount; i++) entries[i].word = words[i];
+    for(size_t i = 0; i < lookups; i++)
+    {
+        unsigned long long r = nextRandom(&state);
+        hits[i] = words[r % wordCount];
+        misses[i] = words[wordCount + (r >> 32) % wordCount];
+    }
+
+    Dictionary *dict = dictionaryCreate(NULL, NULL);
+    if(!dict) return 0;
+
+    memset(t, 0, sizeof(*t));
+    size_t found = 0, missed = 0, removed = 0;
+    for(int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        // mulai dari tabel kosong, jadi insert ikut membayar semua rehash
+        freeHashTable(dict);
+        dictWriteBegin(dict);
+        double start = now();
+        for(size_t i = 0; i < wordCount; i++)
+            if(!hashTableInsert(dict, &entries[i])) return 0;
+        keepBest(&t->insert, now() - start);
+        dictWriteEnd(dict);
+        hashTableStats(dict, &t->stats);
+
+        dictReadBegin();
+        start = now();
+        found = 0;
+        for(size_t i = 0; i < lookups; i++) found += hashTableFind(dict, hits[i]) != NULL;
+        keepBest(&t->hit, now() - start);
+
+        start = now();
+        missed = 0;
+        for(size_t i = 0; i < lookups; i++) missed += hashTableFind(dict, misses[i]) == NULL;
+        keepBest(&t->miss, now() - start);
+        dictReadEnd();
+
+        dictWriteBegin(dict);
+        start = now();
+        removed = 0;
+        for(size_t i = 0; i < wordCount; i++) removed += hashTableRemove(dict, words[i]) == &entries[i];
+        keepBest(&t->remove, now() - start);
+        dictWriteEnd(dict);
+    }
+
+    int ok = found == lookups && missed == lookups && removed == wordCount;
+    if(!ok)
+        fprintf(stderr, "Index lost or invented words (%zu/%zu hit, %zu/%zu miss, %zu/%zu removed).\n",
+                found, lookups, missed, lookups, removed, wordCount);
+
+    dictionaryFree(dict);
+    for(size_t i = 0; i < totalWords; i++) free(words[i]);
+    free(words);
+    free(entries);
+    free(hits);
+    free(misses);
+    return ok;
+}
+
+// Panjang rata-rata bucket yang tidak kosong (chaining) atau jarak probe
+// rata-rata dari slot awal (open addressing)
+static double averageProbe(const IndexStats *stats)
+{
+#ifdef WORD_INDEX_OPEN
+    return stats->entries ? (double)stats->total / stats->entries : 0;
+#else
+    return stats->used ? (double)stats->entries / stats->used : 0;
+#endif
+}
+
+// Ukuran 1k, 10k, ... sampai maxWords: lookup harus tetap sama cepat
+// berapa pun jumlah kata, selain miss cache yang bertambah
+static int sweep(size_t maxWords, size_t lookups, int longPercent, const char *backend)
+{
+    printf("%s: %zu lookup per ukuran, %d%% kata panjang\n", backend, lookups, longPercent);
+    // waktu dalam ns/op
+    printf("%10s %10s %8s %8s %8s %10s %10s %10s %10s\n", "kata", "MB", "isi", "probe", "terjauh",
+           "insert", "find hit", "find miss", "remove");
+    for(size_t words = 1000; words <= maxWords; words *= 10)
+    {
+        IndexTiming t;
+        if(!measure(words, lookups, longPercent, &t)) return 0;
+        printf("%10zu %10.1f %8.2f %8.2f %8zu %10.1f %10.1f %10.1f %10.1f\n", words, t.stats.bytes / 1e6,
+               (double)t.stats.entries / t.stats.slots, averageProbe(&t.stats),
+               t.stats.longest, t.insert * 1e9 / words, t.hit * 1e9 / lookups, t.miss * 1e9 / lookups, t.remove * 1e9 / words);
+        fflush(stdout);
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+#ifdef WORD_INDEX_OPEN
+    const char *backend = "open addressing";
+#else
+    const char *backend = "chaining";
+#endif
+
+    if(argc > 1 && strcmp(argv[1], "sweep") == 0)
+    {
+        size_t maxWords = argc > 2 ? strtoul(argv[2], NULL, 10) : 10000000;
+        size_t lookups = argc > 3 ? strtoul(argv[3], NULL, 10) : 1000000;
+        int longPercent = argc > 4 ? atoi(argv[4]) : 20;
+        if(maxWords < 1000 || lookups < 1 || longPercent < 0 || longPercent > 100)
+        {
+            fprintf(stderr, "usage: %s sweep [max words>=1000] [lookups>=1] [long word percent 0-100]\n", argv[0]);
+            return 1;
+        }
+        return sweep(maxWords, lookups, longPercent, backend) ? 0 : 1;
+    }
+
+    size_t wordCount = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t lookups = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000000;
+    int longPercent = argc > 3 ? atoi(argv[3]) : 20;
+    if(wordCount < 1 || lookups < 1 || longPercent < 0 || longPercent > 100)
+    {
+        fprintf(stderr, "usage: %s [words>=1] [lookups>=1] [long word percent 0-100]\n", argv[0]);
+        return 1;
+    }
+
+    IndexTiming t;
+    if(!measure(wordCount, lookups, longPercent, &t)) return 1;
+
+    printf("%s: %zu kata (%d%% panjang), %zu lookup, %zu slot, %.1f MB\n", backend, wordCount,
+           longPercent, lookups, t.stats.slots, t.stats.bytes / 1e6);
+    printf("%-10s %10s\n", "", "ns/op");
+    printf("%-10s %10.1f\n", "insert", t.insert * 1e9 / wordCount);
+    printf("%-10s %10.1f\n", "find hit", t.hit * 1e9 / lookups);
+    printf("%-10s %10.1f\n", "find miss", t.miss * 1e9 / lookups);
+    printf("%-10s %10.1f\n", "remove", t.remove * 1e9 / wordCount);
+    return 0;
+}
@@ -0,0 +1,367 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "../dictionary.h"
+
+/*
+    Benchmark penelusuran trie pada kata yang sangat panjang atau sangat dalam.
+
+    gcc -O2 bench/longwords.c arena.c dictionary.c epoch.c history.c hashtable.c trie.c loader.c snapshot.c wal.c text.c graph.c synonymset.c stream.c batch.c stats.c synonym.c -o bench_longwords -pthread
+    ./bench_longwords [jumlah kata biasa] [panjang rantai] [panjang kata panjang] [file korpus]
+
+    Tiga korpus:
+    - kata biasa: 2-4 suku kata acak, sebagai pembanding;
+    - rantai: semua awalan dari satu kata acak ("Ka", "Kam", "Kamo", ...),
+      jadi kedalaman trie sama dengan jumlah kata;
+    - kata panjang: kata sepanjang beberapa ribu byte, masing-masing
+      menyalin awalan acak dari kata sebelumnya, jadi labelnya panjang dan
+      cabangnya dalam.
+    Untuk tiap korpus diukur printAllWordsTrie (stdout ke /dev/null),
+    trieComplete dan trieCursorNext atas semua kata, trieStats, serta
+    trieFuzzy dengan salah ketik pada kata terpanjang, dalam MB kunci per
+    detik. Daftar hasil printAllWordsTrie dicek: semua kata tercetak utuh
+    dan terurut. Jika file korpus diberikan, ketiga korpus ditulis ke sana
+    dalam format synonymList.txt (satu kata per baris) untuk dipakai ulang.
+*/
+
+#define ROUNDS 5
+#define RESULT_LIMIT ((size_t)-1)
+
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    // xorshift64*
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+typedef struct Corpus
+{
+    char **words;
+    size_t count;
+    size_t cap;
+    size_t bytes;           // jumlah panjang semua kata
+    size_t longest;
+} Corpus;
+
+static int addToCorpus(Corpus *corpus, char *word)
+{
+    if(!word) return 0;
+    if(corpus->count == corpus->cap)
+    {
+        size_t cap = corpus->cap ? corpus->cap * 2 : 1024;
+        char **grown = (char **)realloc(corpus->words, cap * sizeof(char *));
+        if(!grown) return 0;
+        corpus->words = grown;
+        corpus->cap = cap;
+    }
+    size_t len = strlen(word);
+    corpus->words[corpus->count++] = word;
+    corpus->bytes += len;
+    if(len > corpus->longest) corpus->longest = len;
+    return 1;
+}
+
+static void freeCorpus(Corpus *corpus)
+{
+    for(size_t i = 0; i < corpus->count; i++) free(corpus->words[i]);
+    free(corpus->words);
+}
+
+static size_t appendSyllable(char *out, unsigned long long *state)
+{
+    static const char *onsets[] = {"b", "d", "g", "h", "j", "k", "l", "m", "n", "p", "r", "s", "t", "w",
+                                   "br", "kr", "pr", "tr", "st", "ng", "ny", "sy"};
+    static const char vowels[] = "aiueo";
+    const char *onset = onsets[nextRandom(state) % (sizeof(onsets) / sizeof(onsets[0]))];
+    size_t len = 0;
+    while(*onset) out[len++] = *onset++;
+    out[len++] = vowels[nextRandom(state) % 5];
+    return len;
+}
+
+static int makeNormalCorpus(Corpus *corpus, size_t count, unsigned long long *state)
+{
+    char buffer[32];
+    for(size_t i = 0; i < count; i++)
+    {
+        size_t len = 0, syllables = 2 + nextRandom(state) % 3;
+        for(size_t s = 0; s < syllables; s++) len += appendSyllable(buffer + len, state);
+        buffer[0] -= 'a' - 'A';
+        buffer[len] = '\0';
+        if(!addToCorpus(corpus, strdup(buffer))) return 0;
+    }
+    return 1;
+}
+
+static int makeChainCorpus(Corpus *corpus, size_t depth, unsigned long long *state)
+{
+    char *word = (char *)malloc(depth + 8);
+    if(!word) return 0;
+    size_t len = 0;
+    while(len < depth) len += appendSyllable(word + len, state);
+    word[0] -= 'a' - 'A';
+
+    int ok = 1;
+    for(size_t n = 2; n <= depth && ok; n++)
+    {
+        char saved = word[n];
+        word[n] = '\0';
+        ok = addToCorpus(corpus, strdup(word));
+        word[n] = saved;
+    }
+    free(word);
+    return ok;
+}
+
+static int makeLongCorpus(Corpus *corpus, size_t length, size_t budget, unsigned long long *state)
+{
+    size_t first = corpus->count;
+    while(corpus->bytes < budget)
+    {
+        char *word = (char *)malloc(length + 8);
+        if(!word) return 0;
+        size_t len = 0;
+        if(corpus->count > first)
+        {
+            // salin awalan acak dari kata sebelumnya supaya cabangnya dalam
+            const char *from = corpus->words[first + nextRandom(state) % (corpus->count - first)];
+            len = nextRandom(state) % strlen(from);
+            memcpy(word, from, len);
+        }
+        while(len < length) len += appendSyllable(word + len, state);
+        word[len] = '\0';
+        word[0] = 'P';
+        if(!addToCorpus(corpus, word)) return 0;
+    }
+    return 1;
+}
+
+static int writeCorpus(const char *filename, Corpus *corpora, int count)
+{
+    FILE *file = fopen(filename, "wb");
+    if(!file) return 0;
+    for(int c = 0; c < count; c++)
+        for(size_t i = 0; i < corpora[c].count; i++)
+        {
+            fputs(corpora[c].words[i], file);
+            fputs(" :\n", file);
+        }
+    return fclose(file) == 0;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void keepBest(double *best, double value)
+{
+    if(*best == 0 || value < *best) *best = value;
+}
+
+// Jalankan printAllWordsTrie dengan stdout diarahkan ke fd
+static double timePrint(Dictionary *dict, int fd)
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    if(saved < 0) return 0;
+    dup2(fd, STDOUT_FILENO);
+
+    double start = now();
+    printAllWordsTrie(dict);
+    fflush(stdout);
+    double elapsed = now() - start;
+
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    return elapsed;
+}
+
+static int compareString(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+// Cek hasil printAllWordsTrie: baris kata (bukan judul) harus sama dengan
+// kata yang dimasukkan, terurut. expected diurutkan di sini.
+static int verifyPrint(Dictionary *dict, char **expected, size_t count)
+{
+    FILE *out = tmpfile();
+    if(!out) return 0;
+    timePrint(dict, fileno(out));
+    rewind(out);
+    qsort(expected, count, sizeof(char *), compareString);
+
+    char *line = NULL;
+    size_t cap = 0, seen = 0;
+    int ok = 1;
+    while(ok && readLine(out, &line, &cap) > 0)
+    {
+        if(line[0] == '\0' || strncmp(line, "---", 3) == 0) continue;
+        if(seen >= count || strcmp(line, expected[seen]) != 0)
+        {
+            fprintf(stderr, "printAllWordsTrie: word %zu differs (%zu bytes printed)\n", seen, strlen(line));
+            ok = 0;
+        }
+        seen++;
+    }
+    if(ok && seen != count)
+    {
+        fprintf(stderr, "printAllWordsTrie printed %zu of %zu words\n", seen, count);
+        ok = 0;
+    }
+
+    free(line);
+    fclose(out);
+    return ok;
+}
+
+static int countWord(const char *word, void *ctx)
+{
+    (void)word;
+    (*(size_t *)ctx)++;
+    return 1;
+}
+
+static int countFuzzy(const char *word, int distance, void *ctx)
+{
+    (void)word;
+    (void)distance;
+    (*(size_t *)ctx)++;
+    return 1;
+}
+
+static void printRate(const char *label, double seconds, size_t bytes, size_t words)
+{
+    printf("%-14s %10.3f ms %12.1f MB/s %10.1f ns/kata\n", label, seconds * 1e3,
+           seconds > 0 ? bytes / seconds / 1e6 : 0, seconds * 1e9 / words);
+}
+
+static int runCorpus(const char *label, const Corpus *corpus)
+{
+    Dictionary *dict = dictionaryCreate(NULL, NULL);
+    char **inserted = (char **)malloc(corpus->count * sizeof(char *));
+    if(!dict || !inserted) return 0;
+    hashTableReserve(dict, corpus->count);
+
+    // kata kembar hanya dimasukkan sekali
+    size_t count = 0;
+    double start = now();
+    for(size_t i = 0; i < corpus->count; i++)
+        if(!findWord(dict, corpus->words[i]) && insertWordEntry(dict, corpus->words[i]))
+            inserted[count++] = corpus->words[i];
+    double insertTime = now() - start;
+
+    printf("\n%s: %zu kata, %.1f MB, terpanjang %zu byte\n", label, count,
+           corpus->bytes / 1e6, corpus->longest);
+    int ok = verifyPrint(dict, inserted, count);
+    free(inserted);
+
+    int devNull = open("/dev/null", O_WRONLY);
+    if(devNull < 0) return 0;
+    double print = 0, complete = 0, pages = 0, shape = 0, fuzzy = 0;
+    size_t completed = 0, paged = 0, fuzzyFound = 0;
+    TrieStats stats;
+
+    // salah ketik di tengah kata terpanjang
+    size_t longest = 0;
+    for(size_t i = 1; i < corpus->count; i++)
+        if(strlen(corpus->words[i]) > strlen(corpus->words[longest])) longest = i;
+    char *query = strdup(corpus->words[longest]);
+    if(!query) return 0;
+    query[strlen(query) / 2] = 'x';
+
+    for(int round = 0; round < ROUNDS && ok; round++)
+    {
+        keepBest(&print, timePrint(dict, devNull));
+
+        completed = 0;
+        start = now();
+        trieComplete(dict, "", RESULT_LIMIT, countWord, &completed);
+        keepBest(&complete, now() - start);
+
+        TrieCursor cursor;
+        paged = 0;
+        start = now();
+        if(trieCursorInit(&cursor, "", NULL))
+        {
+            while(trieCursorNext(dict, &cursor, TRIE_PAGE_SIZE, countWord, &paged));
+            trieCursorFree(&cursor);
+        }
+        keepBest(&pages, now() - start);
+
+        start = now();
+        trieStats(dict, &stats);
+        keepBest(&shape, now() - start);
+
+        fuzzyFound = 0;
+        start = now();
+        trieFuzzy(dict, query, 1, RESULT_LIMIT, countFuzzy, &fuzzyFound);
+        keepBest(&fuzzy, now() - start);
+    }
+    close(devNull);
+
+    if(ok && (completed != count || paged != count || stats.words != count || !fuzzyFound))
+    {
+        fprintf(stderr, "%s: complete %zu, cursor %zu, stats %zu of %zu words, fuzzy %zu\n",
+                label, completed, paged, stats.words, count, fuzzyFound);
+        ok = 0;
+    }
+    if(ok)
+    {
+        printf("node %zu, kedalaman %zu\n", stats.nodes, stats.maxDepth);
+        printRate("insert", insertTime, corpus->bytes, count);
+        printRate("cetak", print, corpus->bytes, count);
+        printRate("complete", complete, corpus->bytes, count);
+        printRate("cursor", pages, corpus->bytes, count);
+        printRate("trieStats", shape, corpus->bytes, count);
+        printf("%-14s %10.3f ms %12zu hasil\n", "fuzzy k=1", fuzzy * 1e3, fuzzyFound);
+    }
+
+    free(query);
+    dictionaryFree(dict);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    size_t normalCount = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+    size_t chainDepth = argc > 2 ? strtoul(argv[2], NULL, 10) : 4096;
+    size_t longLength = argc > 3 ? strtoul(argv[3], NULL, 10) : 16384;
+    const char *corpusFile = argc > 4 ? argv[4] : NULL;
+    if(normalCount < 1 || chainDepth < 2 || longLength < 2)
+    {
+        fprintf(stderr, "usage: %s [words>=1] [chain depth>=2] [long word length>=2] [corpus file]\n", argv[0]);
+        return 1;
+    }
+
+    unsigned long long state = 88172645463325252ULL;
+    Corpus corpora[3] = {{0}};
+    if(!makeNormalCorpus(&corpora[0], normalCount, &state) ||
+       !makeChainCorpus(&corpora[1], chainDepth, &state) ||
+       !makeLongCorpus(&corpora[2], longLength, corpora[0].bytes, &state))
+    {
+        fprintf(stderr, "Failed to generate the corpus.\n");
+        return 1;
+    }
+    if(corpusFile && !writeCorpus(corpusFile, corpora, 3))
+    {
+        fprintf(stderr, "Failed to write %s.\n", corpusFile);
+        return 1;
+    }
+
+    int ok = runCorpus("kata biasa", &corpora[0]) &&
+             runCorpus("rantai", &corpora[1]) &&
+             runCorpus("kata panjang", &corpora[2]);
+    for(int c = 0; c < 3; c++) freeCorpus(&corpora[c]);
+    return ok ? 0 : 1;
+}
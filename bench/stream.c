@@ -0,0 +1,234 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include "../dictionary.h"
+
+/*
+    Benchmark mode rewrite (streamRewrite) dalam MB/s.
+
+    gcc -O2 bench/stream.c arena.c dictionary.c epoch.c history.c hashtable.c trie.c loader.c snapshot.c wal.c text.c graph.c synonymset.c stream.c batch.c stats.c synonym.c -o bench_stream -pthread
+    ./bench_stream [jumlah kata] [MB masukan]
+
+    Teks dibuat dari kata di kamus (70%) dan kata lain, dengan tanda baca
+    dan baris baru. Seperti teks sungguhan, kata dipilih kira-kira mengikuti
+    hukum Zipf: kata ke-i muncul sebanding 1/i. Teks dialirkan lewat pipe dari thread lain, jadi
+    masukan berapa GB pun tidak pernah disimpan. Keluaran dibaca thread
+    lain dan hanya dihitung checksum-nya. Setiap mode dijalankan dengan
+    pipeline thread dan tanpa thread (SYNONYM_STREAM_THREADS=1); checksum
+    keduanya harus sama.
+*/
+
+#define PATTERN_BYTES (16 * 1024 * 1024)    // teks yang diulang sampai ukuran masukan
+
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    // xorshift64*
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+// Kata ke-i: huruf kapital lalu huruf kecil, sama seperti bench/concurrency.c
+static void makeWord(size_t i, char *buffer)
+{
+    size_t len = 0;
+    buffer[len++] = 'A' + (char)(i % 26);
+    i /= 26;
+    do
+    {
+        buffer[len++] = 'a' + (char)(i % 26);
+        i /= 26;
+    } while(i);
+    buffer[len] = '\0';
+}
+
+// Nomor kata acak di [0, count) dengan peluang kira-kira sebanding 1/(i+1):
+// panjang bit dipilih rata, lalu angka di dalam rentang bit itu.
+static size_t zipfIndex(size_t count, unsigned long long *state)
+{
+    int bits = 0;
+    while(bits < 63 && (1ULL << (bits + 1)) <= count) bits++;
+    unsigned long long r = nextRandom(state);
+    unsigned long long low = 1ULL << (r % (unsigned)(bits + 1));
+    unsigned long long i = low + (r >> 8) % low - 1;
+    return (size_t)(i < count ? i : i % count);
+}
+
+static char *makePattern(size_t wordCount, unsigned long long *state)
+{
+    static const char *separators[] = {" ", " ", " ", " ", ", ", ". ", "\n", " - ", "; "};
+    char *pattern = (char *)malloc(PATTERN_BYTES);
+    if(!pattern) return NULL;
+
+    size_t len = 0;
+    char word[32];
+    while(len + 64 < PATTERN_BYTES)
+    {
+        unsigned long long r = nextRandom(state);
+        size_t index = zipfIndex(wordCount, state);
+        makeWord(r % 10 < 7 ? index : wordCount + index, word);
+        if(r & (1ULL << 60)) word[0] += 'a' - 'A';  // sebagian ditulis huruf kecil
+        size_t wordLen = strlen(word);
+        memcpy(pattern + len, word, wordLen);
+        len += wordLen;
+
+        const char *sep = separators[(r >> 40) % (sizeof(separators) / sizeof(separators[0]))];
+        memcpy(pattern + len, sep, strlen(sep));
+        len += strlen(sep);
+    }
+    memset(pattern + len, ' ', PATTERN_BYTES - len);
+    return pattern;
+}
+
+typedef struct Feed
+{
+    int fd;
+    const char *pattern;
+    unsigned long long total;
+    unsigned long long checksum;    // untuk sink
+} Feed;
+
+static void *generate(void *arg)
+{
+    Feed *feed = (Feed *)arg;
+    unsigned long long left = feed->total;
+    while(left > 0)
+    {
+        size_t chunk = left < PATTERN_BYTES ? (size_t)left : PATTERN_BYTES;
+        for(size_t done = 0; done < chunk;)
+        {
+            ssize_t n = write(feed->fd, feed->pattern + done, chunk - done);
+            if(n <= 0) goto out;
+            done += (size_t)n;
+        }
+        left -= chunk;
+    }
+out:
+    close(feed->fd);
+    return NULL;
+}
+
+static void *sink(void *arg)
+{
+    Feed *feed = (Feed *)arg;
+    static char buffer[1 << 16];
+    unsigned long long hash = 1469598103934665603ULL;     // FNV-1a 64
+    ssize_t n;
+    while((n = read(feed->fd, buffer, sizeof(buffer))) > 0)
+    {
+        for(ssize_t i = 0; i < n; i++)
+        {
+            hash ^= (unsigned char)buffer[i];
+            hash *= 1099511628211ULL;
+        }
+        feed->total += (unsigned long long)n;
+    }
+    feed->checksum = hash;
+    close(feed->fd);
+    return NULL;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int runOnce(Dictionary *dict, const char *pattern, unsigned long long bytes, int mode, int threads,
+                   unsigned long long *checksum)
+{
+    int inPipe[2], outPipe[2];
+    if(pipe(inPipe) != 0 || pipe(outPipe) != 0) return 0;
+
+    setenv("SYNONYM_STREAM_THREADS", threads ? "0" : "1", 1);
+    Feed input = {inPipe[1], pattern, bytes, 0};
+    Feed output = {outPipe[0], NULL, 0, 0};
+    FILE *in = fdopen(inPipe[0], "rb");
+    FILE *out = fdopen(outPipe[1], "wb");
+    pthread_t generator, reader;
+    if(!in || !out || pthread_create(&generator, NULL, generate, &input) != 0 ||
+       pthread_create(&reader, NULL, sink, &output) != 0)
+        return 0;
+
+    StreamStats stats;
+    double start = now();
+    int ok = streamRewrite(dict, in, out, mode, &stats);
+    fclose(out);
+    pthread_join(reader, NULL);
+    double elapsed = now() - start;
+    fclose(in);
+    pthread_join(generator, NULL);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("%-9s %-8s %10.1f %12llu %10.1f%% %12ld  %016llx\n",
+           mode == STREAM_REPLACE ? "replace" : "annotate", threads ? "pipeline" : "serial",
+           stats.bytesIn / elapsed / 1e6, (unsigned long long)stats.tokens,
+           stats.tokens ? 100.0 * stats.matched / stats.tokens : 0.0, usage.ru_maxrss / 1024, output.checksum);
+    *checksum = output.checksum;
+    return ok && stats.bytesIn == bytes;
+}
+
+int main(int argc, char **argv)
+{
+    size_t wordCount = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    unsigned long long megabytes = argc > 2 ? strtoull(argv[2], NULL, 10) : 2048;
+    if(wordCount < 1 || megabytes < 1)
+    {
+        fprintf(stderr, "usage: %s [words>=1] [input MB>=1]\n", argv[0]);
+        return 1;
+    }
+
+    Dictionary *dict = dictionaryCreate(NULL, NULL);
+    if(!dict) return 1;
+    hashTableReserve(dict, wordCount);
+    char word[32], synonym[32];
+    for(size_t i = 0; i < wordCount; i++)
+    {
+        makeWord(i, word);
+        WordEntry *entry = insertWordEntry(dict, word);
+        if(!entry) return 1;
+        for(size_t s = 1; s <= 3; s++)
+        {
+            makeWord((i * 7 + s * 104729) % wordCount, synonym);
+            appendSynonym(dict, entry, internString(dict, synonym));
+        }
+    }
+
+    unsigned long long state = 88172645463325252ULL;
+    char *pattern = makePattern(wordCount, &state);
+    if(!pattern) return 1;
+
+    unsigned long long bytes = megabytes * 1024 * 1024;
+    printf("%zu kata, %llu MB masukan, blok %d x %d KB\n", wordCount, megabytes, STREAM_BLOCKS, STREAM_BLOCK_BYTES / 1024);
+    printf("%-9s %-8s %10s %12s %11s %12s  %s\n", "mode", "thread", "MB/s", "kata", "ketemu", "max RSS MB", "checksum");
+
+    int modes[] = {STREAM_ANNOTATE, STREAM_REPLACE};
+    for(int m = 0; m < 2; m++)
+    {
+        unsigned long long pipelined, serial;
+        if(!runOnce(dict, pattern, bytes, modes[m], 1, &pipelined) ||
+           !runOnce(dict, pattern, bytes, modes[m], 0, &serial))
+        {
+            fprintf(stderr, "streamRewrite failed.\n");
+            return 1;
+        }
+        if(pipelined != serial)
+        {
+            fprintf(stderr, "Pipeline and serial output differ.\n");
+            return 1;
+        }
+    }
+
+    free(pattern);
+    dictionaryFree(dict);
+    return 0;
+}
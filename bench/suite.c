@@ -0,0 +1,731 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include "../dictionary.h"
+
+/*
+    Rangkaian benchmark untuk membandingkan satu versi dengan versi lain.
+    Untuk setiap ukuran dibuat kamus sintetis, lalu diukur load, lookup,
+    tambah dan hapus kata, penelusuran terurut, save, dan memori. Hasilnya
+    ditulis sebagai JSON.
+
+    gcc -O2 bench/suite.c arena.c dictionary.c epoch.c history.c hashtable.c trie.c loader.c snapshot.c wal.c text.c graph.c synonymset.c stream.c batch.c stats.c synonym.c -o bench_suite -pthread
+    ./bench_suite [-r putaran] [-q lookup] [-l label] [-o hasil.json] [-k] [-t 1,2,4,...] [jumlah entry ...]
+    ./bench_suite -g jumlah-entry file            hanya menulis kamus sintetis
+    ./bench_suite -c lama.json baru.json [persen]  bandingkan dua hasil
+
+    Kamus sintetis:
+    - Panjang kata utama mengikuti lengthPermil (kira-kira seperti kata
+      di kamus bahasa Inggris, paling sering 7 huruf). Huruf konsonan dan
+      vokal berselang, jadi awalan kata tersebar seperti bahasa sungguhan,
+      bukan acak rata.
+    - Setiap kata unik tanpa perlu himpunan: kata ke-j dengan panjang L
+      adalah angka (j * A + L) mod banyaknya kata L huruf, ditulis dalam
+      basis campuran 21/5. A dipilih sekitar 0,618 kali banyaknya kata dan
+      tidak punya faktor yang sama dengannya, jadi kata berurutan tersebar
+      ke seluruh ruang. Karena itu kamus 50 juta entry pun dibuat
+      tanpa memori tambahan.
+    - Jumlah sinonim per kata: 3% tanpa sinonim, sisanya geometris dengan
+      rata-rata sekitar 4 dan paling banyak SYNONYMS_MAX, jadi sebagian
+      besar muat di WordEntry dan sebagian kecil memakai set.
+    - Sinonim diambil dari kata utama lain dengan peluang kira-kira
+      sebanding 1/i (Zipf), jadi kata populer dipakai oleh banyak entry.
+
+    Memori trie dicatat terpisah dari RSS: byte node dan array anak yang
+    dipakai per kata, byte arena trie per kata (termasuk free list dan sisa
+    blok), dan perkiraan trie lama dengan 26 pointer per node. Trie lama
+    punya satu node per awalan kunci yang berbeda, yaitu jumlah panjang
+    label radix tree ditambah root, jadi untuk kamus sintetis (huruf a-z
+    saja) perkiraan itu tepat.
+
+    Dengan -t, load juga diukur sekali lagi untuk setiap jumlah thread di
+    daftar (lewat SYNONYM_LOAD_THREADS), untuk melihat seberapa jauh parse
+    paralel menskala. Loader tidak memakai thread lebih dari jumlah chunk,
+    jadi kamus kecil berhenti menskala lebih awal.
+
+    Dengan -c, setiap angka di hasil baru dibandingkan dengan hasil lama
+    untuk jumlah entry yang sama. Angka yang memburuk lebih dari persen
+    (default 10) ditandai, dan program keluar dengan status 1.
+*/
+
+#define MAX_WORD_LEN 20
+#define WORD_SPACE_LIMIT (1ULL << 40)   // lebih dari ini, huruf sisanya diisi acak
+#define SPREAD 2654435761ULL            // pengacak urutan entry dan sinonim
+#define SYNONYMS_MAX 64
+#define EDIT_WORDS 100000               // kata yang ditambah lalu dihapus per putaran
+#define RESULT_LINE 4096
+#define THREAD_COUNTS_MAX 16            // jumlah nilai paling banyak di -t
+#define TRIE_26WAY_NODE 216             // sizeof node trie lama: 26 pointer anak + isEndOfWord
+
+// Peluang panjang kata utama 0..MAX_WORD_LEN huruf, dalam permil
+static const int lengthPermil[MAX_WORD_LEN + 1] = {
+    0, 0, 5, 30, 80, 120, 140, 150, 140, 110, 85, 60, 35, 20, 12, 6, 3, 2, 1, 1, 0,
+};
+
+static const char consonants[] = "bcdfghjklmnpqrstvwxyz";
+static const char vowels[] = "aeiou";
+
+typedef struct Layout
+{
+    size_t total;
+    unsigned long long start[MAX_WORD_LEN + 2];  // indeks kata pertama dengan panjang L
+    unsigned long long space[MAX_WORD_LEN + 1];  // banyaknya kata berbeda dengan panjang L
+    unsigned long long scale[MAX_WORD_LEN + 1];  // pengali A untuk panjang L
+} Layout;
+
+typedef struct Result
+{
+    size_t entries, synonyms;
+    unsigned long long fileBytes;
+    double load, traverse, save, snapshot;      // detik
+    double findHit, findMiss, insert, erase;    // nanodetik per operasi
+    long long rssBytes;
+    long long peakBytes;                        // puncak RSS selama load (lihat peakLoadBytes)
+    TrieStats trie;
+    size_t trieArenaBytes;
+    double loadThreads[THREAD_COUNTS_MAX];      // detik, untuk setiap jumlah thread di -t
+} Result;
+
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    // xorshift64*
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+// Nomor acak di [0, count) dengan peluang kira-kira sebanding 1/(i+1),
+// sama seperti bench/stream.c
+static size_t zipfIndex(size_t count, unsigned long long *state)
+{
+    int bits = 0;
+    while(bits < 63 && (1ULL << (bits + 1)) <= count) bits++;
+    unsigned long long r = nextRandom(state);
+    unsigned long long low = 1ULL << (r % (unsigned)(bits + 1));
+    unsigned long long i = low + (r >> 8) % low - 1;
+    return (size_t)(i < count ? i : i % count);
+}
+
+static unsigned long long gcd(unsigned long long a, unsigned long long b)
+{
+    while(b)
+    {
+        unsigned long long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static void makeLayout(size_t total, Layout *layout)
+{
+    layout->total = total;
+    size_t assigned = 0, carry = 0;
+    for(int len = 0; len <= MAX_WORD_LEN; len++)
+    {
+        unsigned long long space = 1;
+        for(int pos = 0; pos < len && space < WORD_SPACE_LIMIT; pos++) space *= pos % 2 ? 5 : 21;
+        layout->space[len] = space < WORD_SPACE_LIMIT ? space : WORD_SPACE_LIMIT;
+        unsigned long long scale = (unsigned long long)(layout->space[len] * 0.6180339887) | 1;
+        while(gcd(scale, layout->space[len]) != 1) scale += 2;
+        layout->scale[len] = scale;
+
+        // panjang yang sudah penuh meneruskan sisanya ke panjang berikutnya
+        size_t share = (size_t)((unsigned long long)total * lengthPermil[len] / 1000) + carry;
+        if(len == MAX_WORD_LEN) share = total - assigned;
+        size_t count = share < layout->space[len] ? share : (size_t)layout->space[len];
+        carry = share - count;
+        layout->start[len] = assigned;
+        assigned += count;
+    }
+    layout->start[MAX_WORD_LEN + 1] = assigned;
+}
+
+// Kata ke-i (0 <= i < layout->total), diawali huruf kapital
+static size_t makeWord(const Layout *layout, size_t i, char *buffer)
+{
+    int len = 1;
+    while(layout->start[len + 1] <= i) len++;
+    unsigned long long space = layout->space[len];
+    unsigned long long x = (unsigned long long)(((unsigned __int128)(i - layout->start[len] + 1) * layout->scale[len] + len) % space);
+
+    unsigned long long filler = x ^ SPREAD, covered = 1;
+    for(int pos = 0; pos < len; pos++)
+    {
+        unsigned long long radix = pos % 2 ? 5 : 21;
+        unsigned long long digit;
+        if(covered < space)
+        {
+            digit = x % radix;
+            x /= radix;
+            covered *= radix;
+        }
+        else digit = nextRandom(&filler) % radix;
+        buffer[pos] = pos % 2 ? vowels[digit] : consonants[digit];
+    }
+    buffer[0] += 'A' - 'a';
+    buffer[len] = '\0';
+    return (size_t)len;
+}
+
+// Kata yang pasti tidak ada di kamus: pola konsonan-vokal dipatahkan
+static void makeMissingWord(const Layout *layout, size_t i, char *buffer)
+{
+    size_t len = makeWord(layout, i, buffer);
+    buffer[len] = len % 2 ? 'x' : 'a';
+    buffer[len + 1] = '\0';
+}
+
+// Entry ke-i di file atau di daftar query tersebar di semua panjang kata
+static size_t spread(size_t i, size_t total)
+{
+    return (size_t)(((unsigned long long)i * SPREAD + 12345) % total);
+}
+
+static int generateDictionary(size_t total, const char *filename, unsigned long long *bytes)
+{
+    FILE *file = fopen(filename, "wb");
+    if(!file) return 0;
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+
+    Layout layout;
+    makeLayout(total, &layout);
+    unsigned long long state = 88172645463325252ULL;
+    char word[MAX_WORD_LEN + 2];
+    size_t picked[SYNONYMS_MAX];
+    for(size_t i = 0; i < total; i++)
+    {
+        size_t index = spread(i, total);
+        makeWord(&layout, index, word);
+        fputs(word, file);
+        fputs(" :", file);
+
+        size_t count = 0;
+        if(nextRandom(&state) % 100 >= 3)
+            for(count = 1; count < SYNONYMS_MAX && nextRandom(&state) % 4 != 0; count++);
+        if(count >= total) count = total - 1;
+        for(size_t s = 0; s < count; s++)
+        {
+            size_t synonym;
+            int duplicate;
+            do
+            {
+                synonym = spread(zipfIndex(total, &state), total);
+                duplicate = synonym == index;
+                for(size_t k = 0; k < s && !duplicate; k++) duplicate = picked[k] == synonym;
+            } while(duplicate);
+            picked[s] = synonym;
+            makeWord(&layout, synonym, word);
+            fputs(s ? ", " : " ", file);
+            fputs(word, file);
+        }
+        fputc('\n', file);
+    }
+
+    *bytes = (unsigned long long)ftell(file);
+    return fclose(file) == 0;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Memori yang sedang dipakai proses, dalam byte. Memori bebas dari kamus
+// sebelumnya dikembalikan dulu, supaya tidak dipakai ulang dan tidak ikut
+// mengecilkan angka kamus berikutnya.
+static long long residentBytes(void)
+{
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+#ifdef __linux__
+    FILE *statm = fopen("/proc/self/statm", "r");
+    long long size, resident;
+    if(statm)
+    {
+        int ok = fscanf(statm, "%lld %lld", &size, &resident) == 2;
+        fclose(statm);
+        if(ok) return resident * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (long long)usage.ru_maxrss * 1024;
+}
+
+// Puncak RSS selama satu load, di proses anak yang baru di-fork supaya
+// puncak dari ukuran sebelumnya tidak ikut terbaca. Termasuk buffer
+// sementara parser yang sudah dilepas saat load selesai, jadi bisa jauh
+// lebih besar dari rssBytes. 0 jika tidak bisa diukur.
+static long long peakLoadBytes(const char *filename)
+{
+    int fds[2];
+    if(pipe(fds) != 0) return 0;
+    fflush(NULL);
+    pid_t child = fork();
+    if(child < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return 0;
+    }
+    if(child == 0)
+    {
+        close(fds[0]);
+        long long start = residentBytes();
+        Dictionary *dict = dictionaryCreate(NULL, NULL);
+        if(dict) loadFromFileSynonym(dict, filename);
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        long long peak = dict ? (long long)usage.ru_maxrss * 1024 - start : 0;
+        if(write(fds[1], &peak, sizeof(peak)) != sizeof(peak)) _exit(1);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    long long peak = 0;
+    if(read(fds[0], &peak, sizeof(peak)) != sizeof(peak)) peak = 0;
+    close(fds[0]);
+    waitpid(child, NULL, 0);
+    return peak;
+}
+
+static void keepBest(double *best, double value)
+{
+    if(*best == 0 || value < *best) *best = value;
+}
+
+// printAllWordsTrie menulis ke stdout; selama diukur stdout diarahkan ke /dev/null
+static double timeTraversal(Dictionary *dict)
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int devNull = open("/dev/null", O_WRONLY);
+    if(saved < 0 || devNull < 0) return 0;
+    dup2(devNull, STDOUT_FILENO);
+
+    double start = now();
+    printAllWordsTrie(dict);
+    fflush(stdout);
+    double elapsed = now() - start;
+
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    close(devNull);
+    return elapsed;
+}
+
+static double timeLookups(Dictionary *dict, char **queries, size_t count, size_t *found)
+{
+    *found = 0;
+    dictReadBegin();
+    double start = now();
+    for(size_t i = 0; i < count; i++)
+        if(findWord(dict, queries[i])) (*found)++;
+    double elapsed = now() - start;
+    dictReadEnd();
+    return elapsed;
+}
+
+// Load terbaik dari beberapa putaran dengan SYNONYM_LOAD_THREADS = threads
+static double timeLoad(const char *filename, size_t total, int rounds, int threads, int *ok)
+{
+    char value[16];
+    snprintf(value, sizeof(value), "%d", threads);
+    setenv("SYNONYM_LOAD_THREADS", value, 1);
+
+    double best = 0;
+    for(int round = 0; round < rounds; round++)
+    {
+        Dictionary *dict = dictionaryCreate(NULL, NULL);
+        if(!dict) return 0;
+        double start = now();
+        loadFromFileSynonym(dict, filename);
+        keepBest(&best, now() - start);
+        if(dictionaryWordCount(dict) != total) *ok = 0;
+        dictionaryFree(dict);
+    }
+    return best;
+}
+
+static int runSize(size_t total, int rounds, size_t lookups, int keep, const int *threads, int threadCount,
+                   Result *result)
+{
+    memset(result, 0, sizeof(*result));
+    result->entries = total;
+
+    char filename[64], saveName[80], snapName[80];
+    snprintf(filename, sizeof(filename), "bench_suite_%zu.txt", total);
+    snprintf(saveName, sizeof(saveName), "bench_suite_%zu.save.txt", total);
+    snprintf(snapName, sizeof(snapName), "bench_suite_%zu.snap", total);
+
+    fprintf(stderr, "%zu entries: generating %s\n", total, filename);
+    if(!generateDictionary(total, filename, &result->fileBytes))
+    {
+        fprintf(stderr, "Failed to write %s.\n", filename);
+        return 0;
+    }
+
+    Layout layout;
+    makeLayout(total, &layout);
+    size_t edits = total < EDIT_WORDS ? total : EDIT_WORDS;
+    char **hits = (char **)malloc(lookups * sizeof(char *));
+    char **misses = (char **)malloc(lookups * sizeof(char *));
+    char **added = (char **)malloc(edits * sizeof(char *));
+    char *text = (char *)malloc((lookups * 2 + edits) * (MAX_WORD_LEN + 2));
+    if(!hits || !misses || !added || !text) return 0;
+
+    unsigned long long state = 0x2545F4914F6CDD1DULL;
+    char *cursor = text;
+    for(size_t i = 0; i < lookups; i++)
+    {
+        size_t index = (size_t)(nextRandom(&state) % total);
+        hits[i] = cursor;
+        cursor += makeWord(&layout, index, cursor) + 1;
+        misses[i] = cursor;
+        makeMissingWord(&layout, index, cursor);
+        cursor += strlen(cursor) + 1;
+    }
+    for(size_t i = 0; i < edits; i++)
+    {
+        added[i] = cursor;
+        makeMissingWord(&layout, spread(i, total), cursor);
+        cursor += strlen(cursor) + 1;
+    }
+
+    int ok = 1;
+    for(int round = 0; round < rounds && ok; round++)
+    {
+        fprintf(stderr, "%zu entries: round %d/%d\n", total, round + 1, rounds);
+        long long before = residentBytes();
+        double start = now();
+        Dictionary *dict = dictionaryCreate(NULL, NULL);
+        if(!dict) return 0;
+        loadFromFileSynonym(dict, filename);
+        keepBest(&result->load, now() - start);
+        if(round == 0)
+        {
+            result->rssBytes = residentBytes() - before;
+            dictWriteBegin(dict);
+            trieStats(dict, &result->trie);
+            result->trieArenaBytes = result->trie.arenaBytes;
+            dictWriteEnd(dict);
+            HashTableIter it;
+            hashTableIterInit(&it);
+            for(WordEntry *entry; (entry = hashTableNext(dict, &it));) result->synonyms += synonymCount(entry);
+        }
+        if(dictionaryWordCount(dict) != total)
+        {
+            fprintf(stderr, "Loaded %zu of %zu entries.\n", dictionaryWordCount(dict), total);
+            ok = 0;
+        }
+
+        size_t found;
+        keepBest(&result->findHit, timeLookups(dict, hits, lookups, &found) / lookups * 1e9);
+        if(found != lookups) ok = 0;
+        keepBest(&result->findMiss, timeLookups(dict, misses, lookups, &found) / lookups * 1e9);
+        if(found != 0) ok = 0;
+
+        start = now();
+        for(size_t i = 0; i < edits; i++) addWord(dict, added[i], 1);
+        keepBest(&result->insert, (now() - start) / edits * 1e9);
+        if(dictionaryWordCount(dict) != total + edits) ok = 0;
+        start = now();
+        for(size_t i = 0; i < edits; i++) deleteWordEntry(dict, added[i]);
+        keepBest(&result->erase, (now() - start) / edits * 1e9);
+        if(dictionaryWordCount(dict) != total) ok = 0;
+
+        keepBest(&result->traverse, timeTraversal(dict));
+
+        start = now();
+        if(!saveToFileSynonym(dict, saveName)) ok = 0;
+        keepBest(&result->save, now() - start);
+        start = now();
+        if(!saveToFileSynonym(dict, snapName)) ok = 0;
+        keepBest(&result->snapshot, now() - start);
+
+        dictionaryFree(dict);
+    }
+    if(ok) result->peakBytes = peakLoadBytes(filename);
+
+    // nilai SYNONYM_LOAD_THREADS dari luar dikembalikan sesudahnya
+    const char *env = getenv("SYNONYM_LOAD_THREADS");
+    char *saved = env ? strdup(env) : NULL;
+    for(int t = 0; t < threadCount && ok; t++)
+    {
+        result->loadThreads[t] = timeLoad(filename, total, rounds, threads[t], &ok);
+        fprintf(stderr, "%zu entries: load with %d thread%s %.3f s (%.2fx)\n", total, threads[t],
+                threads[t] == 1 ? "" : "s", result->loadThreads[t],
+                result->loadThreads[t] > 0 ? result->loadThreads[0] / result->loadThreads[t] : 0.0);
+    }
+    if(saved) setenv("SYNONYM_LOAD_THREADS", saved, 1);
+    else unsetenv("SYNONYM_LOAD_THREADS");
+    free(saved);
+
+    if(!ok) fprintf(stderr, "%zu entries: results did not match the generated dictionary.\n", total);
+    remove(saveName);
+    remove(snapName);
+    if(!keep) remove(filename);
+    free(hits);
+    free(misses);
+    free(added);
+    free(text);
+    return ok;
+}
+
+static double perWord(size_t bytes, const Result *r)
+{
+    return r->trie.words ? (double)bytes / r->trie.words : 0.0;
+}
+
+static void writeResult(FILE *out, const Result *r, const int *threads, int threadCount)
+{
+    // satu baris per ukuran, supaya -c bisa membacanya tanpa parser JSON
+    fprintf(out, "    {\"entries\": %zu, \"synonyms\": %zu, \"file_bytes\": %llu, "
+                 "\"load_s\": %.6f, \"load_entries_per_s\": %.0f, \"rss_bytes\": %lld, \"bytes_per_entry\": %.1f, "
+                 "\"peak_rss_bytes\": %lld, \"peak_bytes_per_entry\": %.1f, "
+                 "\"find_hit_ns\": %.1f, \"find_miss_ns\": %.1f, \"insert_ns\": %.1f, \"delete_ns\": %.1f, "
+                 "\"traverse_s\": %.6f, \"save_s\": %.6f, \"save_snapshot_s\": %.6f, "
+                 "\"trie_nodes\": %zu, \"trie_bytes_per_word\": %.1f, \"trie_arena_bytes_per_word\": %.1f, "
+                 "\"trie_26way_bytes_per_word\": %.1f",
+            r->entries, r->synonyms, r->fileBytes, r->load, r->load > 0 ? r->entries / r->load : 0.0,
+            r->rssBytes, (double)r->rssBytes / r->entries, r->peakBytes, (double)r->peakBytes / r->entries,
+            r->findHit, r->findMiss, r->insert, r->erase,
+            r->traverse, r->save, r->snapshot, r->trie.nodes, perWord(r->trie.bytes, r),
+            perWord(r->trieArenaBytes, r), perWord((r->trie.labelBytes + 1) * TRIE_26WAY_NODE, r));
+    for(int t = 0; t < threadCount; t++) fprintf(out, ", \"load_t%d_s\": %.6f", threads[t], r->loadThreads[t]);
+    fputc('}', out);
+}
+
+// Daftar jumlah thread "1,2,4,8" untuk -t; 0 jika ada yang di luar 1..LOAD_THREADS_MAX
+static int parseThreadCounts(const char *list, int *threads, int *count)
+{
+    *count = 0;
+    for(const char *p = list; *p;)
+    {
+        char *end;
+        long value = strtol(p, &end, 10);
+        if(end == p || value < 1 || value > LOAD_THREADS_MAX || *count >= THREAD_COUNTS_MAX) return 0;
+        threads[(*count)++] = (int)value;
+        p = *end == ',' ? end + 1 : end;
+        if(*end && *end != ',') return 0;
+    }
+    return *count > 0;
+}
+
+// Ambil nilai angka "key" dari satu baris hasil
+static int resultValue(const char *line, const char *key, double *value)
+{
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    const char *p = strstr(line, pattern);
+    if(!p) return 0;
+    *value = strtod(p + strlen(pattern), NULL);
+    return 1;
+}
+
+static char **readResultLines(const char *filename, size_t *count)
+{
+    FILE *file = fopen(filename, "r");
+    if(!file) return NULL;
+    char **lines = NULL;
+    char line[RESULT_LINE];
+    *count = 0;
+    while(fgets(line, sizeof(line), file))
+    {
+        if(!strstr(line, "\"entries\": ")) continue;
+        char **grown = (char **)realloc(lines, (*count + 1) * sizeof(char *));
+        if(!grown) break;
+        lines = grown;
+        lines[(*count)++] = strdup(line);
+    }
+    fclose(file);
+    return lines;
+}
+
+static int compareResults(const char *oldName, const char *newName, double threshold)
+{
+    // nilai *_per_s makin besar makin baik, sisanya makin kecil makin baik
+    static const char *keys[] = {"load_s", "load_entries_per_s", "bytes_per_entry", "peak_bytes_per_entry",
+                                 "trie_bytes_per_word", "find_hit_ns", "find_miss_ns",
+                                 "insert_ns", "delete_ns", "traverse_s", "save_s", "save_snapshot_s"};
+    size_t oldCount, newCount;
+    char **oldLines = readResultLines(oldName, &oldCount);
+    char **newLines = readResultLines(newName, &newCount);
+    if(!oldLines || !newLines)
+    {
+        fprintf(stderr, "Failed to read %s.\n", !oldLines ? oldName : newName);
+        return 2;
+    }
+
+    int regressions = 0;
+    printf("%10s %-20s %14s %14s %9s\n", "entries", "metric", "old", "new", "change");
+    for(size_t n = 0; n < newCount; n++)
+    {
+        double entries, oldEntries;
+        resultValue(newLines[n], "entries", &entries);
+        const char *old = NULL;
+        for(size_t o = 0; o < oldCount && !old; o++)
+            if(resultValue(oldLines[o], "entries", &oldEntries) && oldEntries == entries) old = oldLines[o];
+        if(!old) continue;
+
+        // sesudah kunci tetap, load_t<n>_s dari -t yang ada di kedua hasil
+        size_t keyCount = sizeof(keys) / sizeof(keys[0]);
+        for(size_t k = 0; k < keyCount + LOAD_THREADS_MAX; k++)
+        {
+            char threadKey[32];
+            snprintf(threadKey, sizeof(threadKey), "load_t%zu_s", k - keyCount + 1);
+            const char *key = k < keyCount ? keys[k] : threadKey;
+            double before, after;
+            if(!resultValue(old, key, &before) || !resultValue(newLines[n], key, &after) || before <= 0)
+                continue;
+            double change = (after - before) / before * 100;
+            double worse = strstr(key, "_per_s") ? -change : change;
+            int regressed = worse > threshold;
+            regressions += regressed;
+            printf("%10.0f %-20s %14.6g %14.6g %+8.1f%%%s\n", entries, key, before, after, change,
+                   regressed ? "  REGRESSION" : "");
+        }
+    }
+
+    for(size_t i = 0; i < oldCount; i++) free(oldLines[i]);
+    for(size_t i = 0; i < newCount; i++) free(newLines[i]);
+    free(oldLines);
+    free(newLines);
+    printf("%d regression%s over %.0f%%\n", regressions, regressions == 1 ? "" : "s", threshold);
+    return regressions ? 1 : 0;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-r rounds] [-q lookups] [-l label] [-o out.json] [-k] [-t 1,2,4,...] [entries ...]\n"
+                    "       %s -g entries file\n"
+                    "       %s -c old.json new.json [percent]\n", program, program, program);
+}
+
+int main(int argc, char **argv)
+{
+    if(argc > 1 && strcmp(argv[1], "-c") == 0)
+    {
+        if(argc < 4)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        return compareResults(argv[2], argv[3], argc > 4 ? atof(argv[4]) : 10.0);
+    }
+    if(argc > 1 && strcmp(argv[1], "-g") == 0)
+    {
+        size_t total = argc > 3 ? strtoul(argv[2], NULL, 10) : 0;
+        unsigned long long bytes;
+        if(total < 2)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        if(!generateDictionary(total, argv[3], &bytes))
+        {
+            fprintf(stderr, "Failed to write %s.\n", argv[3]);
+            return 1;
+        }
+        fprintf(stderr, "%zu entries, %llu bytes\n", total, bytes);
+        return 0;
+    }
+
+    int rounds = 3, keep = 0;
+    size_t lookups = 1000000;
+    const char *label = "", *outName = NULL;
+    size_t sizes[64], sizeCount = 0;
+    int threads[THREAD_COUNTS_MAX], threadCount = 0;
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-k") == 0) keep = 1;
+        else if(i + 1 < argc && strcmp(argv[i], "-r") == 0) rounds = atoi(argv[++i]);
+        else if(i + 1 < argc && strcmp(argv[i], "-q") == 0) lookups = strtoul(argv[++i], NULL, 10);
+        else if(i + 1 < argc && strcmp(argv[i], "-l") == 0) label = argv[++i];
+        else if(i + 1 < argc && strcmp(argv[i], "-o") == 0) outName = argv[++i];
+        else if(i + 1 < argc && strcmp(argv[i], "-t") == 0)
+        {
+            if(!parseThreadCounts(argv[++i], threads, &threadCount))
+            {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        else if(argv[i][0] != '-' && sizeCount < sizeof(sizes) / sizeof(sizes[0])) sizes[sizeCount++] = strtoul(argv[i], NULL, 10);
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if(sizeCount == 0)
+    {
+        static const size_t defaults[] = {1000, 10000, 100000, 1000000};
+        for(; sizeCount < 4; sizeCount++) sizes[sizeCount] = defaults[sizeCount];
+    }
+    int valid = rounds >= 1 && lookups >= 1;
+    for(size_t i = 0; i < sizeCount; i++)
+        if(sizes[i] < 2) valid = 0;
+    if(!valid)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Result *results = (Result *)calloc(sizeCount, sizeof(Result));
+    if(!results) return 1;
+    for(size_t i = 0; i < sizeCount; i++)
+        if(!runSize(sizes[i], rounds, lookups, keep, threads, threadCount, &results[i])) return 1;
+
+    FILE *out = outName ? fopen(outName, "w") : stdout;
+    if(!out)
+    {
+        fprintf(stderr, "Failed to open %s.\n", outName);
+        return 1;
+    }
+    char date[32];
+    time_t t = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&t));
+    fprintf(out, "{\n  \"label\": \"%s\",\n  \"date\": \"%s\",\n", label, date);
+#ifdef __VERSION__
+    fprintf(out, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+#ifdef WORD_INDEX_OPEN
+    fprintf(out, "  \"word_index\": \"open\",\n");
+#else
+    fprintf(out, "  \"word_index\": \"chained\",\n");
+#endif
+    fprintf(out, "  \"text_kernel\": \"%s\",\n  \"rounds\": %d,\n  \"lookups\": %zu,\n  \"edits\": %d,\n",
+            textKernelName(), rounds, lookups, EDIT_WORDS);
+    if(threadCount)
+    {
+        fputs("  \"load_threads\": [", out);
+        for(int t = 0; t < threadCount; t++) fprintf(out, t ? ", %d" : "%d", threads[t]);
+        fputs("],\n", out);
+    }
+    fputs("  \"results\": [\n", out);
+    for(size_t i = 0; i < sizeCount; i++)
+    {
+        writeResult(out, &results[i], threads, threadCount);
+        fputs(i + 1 < sizeCount ? ",\n" : "\n", out);
+    }
+    fputs("  ]\n}\n", out);
+
+    free(results);
+    return out != stdout && fclose(out) != 0;
+}
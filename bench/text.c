@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ctype.h>
+#include "../dictionary.h"
+
+/*
+    Benchmark normalisasi dan hash kata untuk setiap versi kernel di text.c.
+
+    gcc -O2 bench/text.c arena.c dictionary.c epoch.c history.c hashtable.c trie.c loader.c snapshot.c wal.c text.c graph.c synonymset.c stream.c batch.c stats.c synonym.c -o bench_text -pthread
+    ./bench_text [jumlah kata] [panjang baris]
+
+    Tiga beban: kata pendek seperti isi kamus (3-24 byte plus spasi di kedua
+    sisi), baris panjang seperti teks dokumen, dan kata UTF-8 (huruf beraksen,
+    huruf + tanda diakritik gabung, Kiril, Yunani). Sebelum diukur, hasil
+    tiap kernel dibandingkan dengan versi byte per byte yang lama; untuk kata
+    UTF-8 dengan kernel skalar, dan normalisasi kedua tidak boleh mengubah
+    apa-apa lagi.
+*/
+
+#define BENCH_ROUNDS 5      // diambil yang tercepat
+
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    // xorshift64*
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+// Versi lama dari synonym.c, sebagai acuan hasil
+static void referenceTrim(char *word)
+{
+    if(word == NULL || *word == '\0') return;
+
+    char *start = word;
+    while(isspace((unsigned char)*start)) start++;
+
+    char *end = start + strlen(start) - 1;
+    while(end > start && isspace((unsigned char)*end)) end--;
+
+    *(end + 1) = 0;
+
+    if(start != word) memmove(word, start, end - start + 2);
+}
+
+static void referenceCapital(char *word)
+{
+    referenceTrim(word);
+
+    word[0] = toupper((unsigned char)word[0]);
+    for(int i = 1; word[i]; i++) word[i] = tolower((unsigned char)word[i]);
+}
+
+static unsigned int referenceHash(const char *str)
+{
+    unsigned int hash = 5381;
+    int c;
+    while ((c = *str++))
+    {
+        hash = ((hash << 5) + hash) + c;
+    }
+    return hash;
+}
+
+static char randomByte(unsigned long long *state, int spaces)
+{
+    static const char space[] = " \t\n\v\f\r";
+    unsigned long long r = nextRandom(state);
+    if(spaces && r % 8 == 0) return space[(r >> 8) % 6];
+    if(r % 16 == 1) return (char)(128 + (r >> 8) % 64);    // byte lanjutan tanpa awal: bukan UTF-8 sah, tetap utuh
+    if(r % 2) return 'A' + (char)((r >> 8) % 26);
+    return 'a' + (char)((r >> 8) % 26);
+}
+
+// count string di satu buffer, dipisah '\0'; panjang isi acak minLen..maxLen
+static char *makeInput(size_t count, size_t minLen, size_t maxLen, unsigned long long seed, size_t *bytes)
+{
+    unsigned long long state = seed;
+    char *buffer = (char *)malloc(count * (maxLen + 8 + 1));
+    if(!buffer) return NULL;
+
+    char *out = buffer;
+    for(size_t i = 0; i < count; i++)
+    {
+        size_t lead = nextRandom(&state) % 4, trail = nextRandom(&state) % 4;
+        size_t len = minLen + nextRandom(&state) % (maxLen - minLen + 1);
+        for(size_t k = 0; k < lead; k++) *out++ = ' ';
+        for(size_t k = 0; k < len; k++) *out++ = randomByte(&state, k > 0 && k + 1 < len);
+        for(size_t k = 0; k < trail; k++) *out++ = k % 2 ? '\t' : ' ';
+        *out++ = '\0';
+    }
+    *bytes = (size_t)(out - buffer);
+    return buffer;
+}
+
+// Potongan kata UTF-8; "e\xcc\x81" = e + U+0301 (digabung menjadi é)
+static const char *utf8Pieces[] = {
+    "ka", "Ma", "ri", "TO", "\xc3\xa9", "\xc3\x88", "\xc3\x9f", "\xc3\xb1", "\xc3\x96", "e\xcc\x81", "A\xcc\x8a",
+    "\xc8\x99", "\xc8\x9a", "\xc6\xb0", "\xe1\xba\xa0", "\xd0\xbc\xd0\xbe", "\xd0\xa1\xd0\x9a", "\xd0\xb2\xd0\xb0",
+    "\xcf\x8c\xce\xb4", "\xce\xa3\xce\x91", "-", "'",
+};
+
+#define UTF8_PIECES (sizeof(utf8Pieces) / sizeof(utf8Pieces[0]))
+
+// count kata UTF-8 dari 2-6 potongan, dengan spasi di kedua sisi
+static char *makeUtf8Input(size_t count, unsigned long long seed, size_t *bytes)
+{
+    unsigned long long state = seed;
+    char *buffer = (char *)malloc(count * (6 * 6 + 8 + 1));
+    if(!buffer) return NULL;
+
+    char *out = buffer;
+    for(size_t i = 0; i < count; i++)
+    {
+        size_t lead = nextRandom(&state) % 4, trail = nextRandom(&state) % 4;
+        size_t pieces = 2 + nextRandom(&state) % 5;
+        for(size_t k = 0; k < lead; k++) *out++ = ' ';
+        for(size_t k = 0; k < pieces; k++)
+        {
+            const char *piece = utf8Pieces[nextRandom(&state) % UTF8_PIECES];
+            memcpy(out, piece, strlen(piece));
+            out += strlen(piece);
+        }
+        for(size_t k = 0; k < trail; k++) *out++ = k % 2 ? '\t' : ' ';
+        *out++ = '\0';
+    }
+    *bytes = (size_t)(out - buffer);
+    return buffer;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Jalankan trim_and_tocapital lalu hash untuk setiap string di salinan input.
+// Mengembalikan detik tercepat untuk normalisasi dan untuk hash.
+static void runKernel(const char *input, char *work, size_t bytes, const size_t *offsets, size_t count,
+                      double *normalizeTime, double *hashTime, unsigned int *checksum)
+{
+    *normalizeTime = *hashTime = 0;
+    for(int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        memcpy(work, input, bytes);
+        double start = now();
+        for(size_t i = 0; i < count; i++) trim_and_tocapital(work + offsets[i]);
+        double elapsed = now() - start;
+        if(!*normalizeTime || elapsed < *normalizeTime) *normalizeTime = elapsed;
+
+        unsigned int sum = 0;
+        start = now();
+        for(size_t i = 0; i < count; i++) sum += hash(work + offsets[i]);
+        elapsed = now() - start;
+        if(!*hashTime || elapsed < *hashTime) *hashTime = elapsed;
+        *checksum = sum;
+    }
+}
+
+// Bandingkan setiap string dengan versi lama: hasil trim/kapital dan hash harus sama
+static int verify(const char *input, size_t bytes, size_t count)
+{
+    char *a = (char *)malloc(bytes), *b = (char *)malloc(bytes);
+    if(!a || !b) return 0;
+    memcpy(a, input, bytes);
+    memcpy(b, input, bytes);
+
+    int ok = 1;
+    size_t offset = 0;
+    for(size_t i = 0; i < count && ok; i++)
+    {
+        size_t len = strlen(a + offset);
+        if(hash(a + offset) != referenceHash(b + offset)) ok = 0;
+
+        char *copy = (char *)malloc(len + 1);
+        if(!copy) break;
+        memcpy(copy, a + offset, len + 1);
+        trim(copy);
+        referenceTrim(b + offset);
+        if(strcmp(copy, b + offset) != 0) ok = 0;
+        memcpy(b + offset, a + offset, len + 1);
+        free(copy);
+
+        trim_and_tocapital(a + offset);
+        referenceCapital(b + offset);
+        if(strcmp(a + offset, b + offset) != 0 || hash(a + offset) != referenceHash(b + offset)) ok = 0;
+        offset += len + 1;
+    }
+    free(a);
+    free(b);
+    return ok;
+}
+
+// Untuk kata UTF-8: hasil kernel name harus sama dengan kernel skalar, dan
+// menormalisasi hasilnya sekali lagi tidak mengubah apa-apa
+static int verifyUtf8(const char *input, size_t bytes, size_t count, const char *name)
+{
+    char *a = (char *)malloc(bytes), *b = (char *)malloc(bytes);
+    if(!a || !b) return 0;
+    memcpy(a, input, bytes);
+    memcpy(b, input, bytes);
+
+    int ok = 1;
+    size_t offset = 0;
+    for(size_t i = 0; i < count && ok; i++)
+    {
+        size_t len = strlen(a + offset);
+        textUseKernel("scalar");
+        trim_and_tocapital(b + offset);
+        textUseKernel(name);
+        trim_and_tocapital(a + offset);
+        if(strcmp(a + offset, b + offset) != 0) ok = 0;
+
+        char again[64];
+        snprintf(again, sizeof(again), "%s", a + offset);
+        trim_and_tocapital(again);
+        if(strcmp(again, a + offset) != 0) ok = 0;
+        offset += len + 1;
+    }
+    free(a);
+    free(b);
+    return ok;
+}
+
+// minLen == 0: kata UTF-8
+static void runWorkload(const char *label, size_t count, size_t minLen, size_t maxLen)
+{
+    size_t bytes;
+    char *input = minLen ? makeInput(count, minLen, maxLen, 0x9E3779B97F4A7C15ULL + maxLen, &bytes)
+                         : makeUtf8Input(count, 0x9E3779B97F4A7C15ULL, &bytes);
+    char *work = (char *)malloc(bytes);
+    size_t *offsets = (size_t *)malloc(count * sizeof(size_t));
+    if(!input || !work || !offsets) return;
+    for(size_t i = 0, offset = 0; i < count; i++)
+    {
+        offsets[i] = offset;
+        offset += strlen(input + offset) + 1;
+    }
+
+    printf("\n%s: %zu string, %.1f MB\n", label, count, bytes / 1e6);
+    printf("%-8s %16s %16s %10s\n", "kernel", "normalize B/s", "hash B/s", "checksum");
+
+    static const char *names[] = {"scalar", "sse2", "avx2"};
+    for(size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        if(!textUseKernel(names[i])) continue;
+        if(minLen ? !verify(input, bytes, count) : !verifyUtf8(input, bytes, count, names[i]))
+        {
+            printf("%-8s hasil berbeda dari versi lama\n", names[i]);
+            continue;
+        }
+
+        double normalizeTime, hashTime;
+        unsigned int checksum;
+        runKernel(input, work, bytes, offsets, count, &normalizeTime, &hashTime, &checksum);
+        printf("%-8s %16.0f %16.0f %10u\n", names[i], bytes / normalizeTime, bytes / hashTime, checksum);
+    }
+
+    free(input);
+    free(work);
+    free(offsets);
+}
+
+int main(int argc, char **argv)
+{
+    size_t wordCount = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t lineLength = argc > 2 ? strtoul(argv[2], NULL, 10) : 4096;
+    if(wordCount < 1 || lineLength < 2)
+    {
+        fprintf(stderr, "usage: %s [words>=1] [line length>=2]\n", argv[0]);
+        return 1;
+    }
+
+    runWorkload("kata", wordCount, 3, 24);
+    runWorkload("kata UTF-8", wordCount, 0, 0);
+    size_t lines = wordCount * 14 / lineLength + 1;
+    runWorkload("baris", lines, lineLength / 2, lineLength);
+    return 0;
+}
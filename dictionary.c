@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dictionary_private.h"
+
+// Membuat dan melepas kamus, serta menukar kamus yang sedang dipakai.
+//
+// Kamus baru bisa dibangun di belakang (mis. loadDictionary pada handle
+// baru) sementara pembaca masih memakai kamus lama, lalu diumumkan dengan
+// dictionaryPublish. Pembaca mengambil kamus lewat dictionaryAcquire di dalam
+// dictReadBegin/dictReadEnd, jadi kamus lama baru dilepas (dictionaryRetire)
+// setelah pembaca terakhir yang mungkin memegangnya keluar.
+
+// Kamus kosong. synonymFile adalah file dasar: snapshot dan log memakai nama
+// yang sama dengan ekstensi SNAPSHOT_EXT, WAL_EXT dan WAL_OLD_EXT, jadi dua
+// kamus dengan file dasar berbeda tidak saling menimpa. Keduanya boleh NULL
+// untuk kamus yang tidak dimuat dari atau disimpan ke file.
+Dictionary *dictionaryCreate(const char *synonymFile, const char *historyFile)
+{
+    Dictionary *dict = (Dictionary *)calloc(1, sizeof(Dictionary));
+    if(!dict)
+    {
+        fprintf(stderr, "Failed to allocate memory for dictionary.\n");
+        return NULL;
+    }
+
+    slabInit(&dict->entrySlab, sizeof(WordEntry), &dict->wordArena);
+    slabInit(&dict->trieSlab, sizeof(TrieNode), &dict->trieArena);
+#ifndef _WIN32
+    pthread_mutex_init(&dict->writeLock, NULL);
+    pthread_rwlock_init(&dict->trieLock, NULL);
+#endif
+
+    int named = 1;
+    if(synonymFile)
+    {
+        dict->synonymFile = strdup(synonymFile);
+        dict->snapshotFile = pathWithExtension(synonymFile, SNAPSHOT_EXT);
+        dict->walFile = pathWithExtension(synonymFile, WAL_EXT);
+        dict->walOldFile = pathWithExtension(synonymFile, WAL_OLD_EXT);
+        named = dict->synonymFile && dict->snapshotFile && dict->walFile && dict->walOldFile;
+    }
+    if(historyFile)
+    {
+        dict->historyFile = strdup(historyFile);
+        named = named && dict->historyFile;
+    }
+    if(!named)
+    {
+        fprintf(stderr, "Failed to allocate memory for dictionary file names.\n");
+        dictionaryFree(dict);
+        return NULL;
+    }
+
+    if(!historyInit(dict))
+    {
+        fprintf(stderr, "Failed to allocate memory for history.\n");
+        dictionaryFree(dict);
+        return NULL;
+    }
+
+    dict->trie = createTrieNode(dict);
+    if(!dict->trie)
+    {
+        fprintf(stderr, "Failed to allocate memory for root Trie.\n");
+        dictionaryFree(dict);
+        return NULL;
+    }
+    return dict;
+}
+
+// Lepas kamus beserta semua isinya. Log harus sudah ditutup (walClose) dan
+// tidak boleh ada pembaca yang masih memakainya.
+void dictionaryFree(Dictionary *dict)
+{
+    if(!dict) return;
+
+    freeMemorySynonym(dict);
+    freeHistory(dict);
+    freeTrieNode(dict);
+#ifndef _WIN32
+    pthread_mutex_destroy(&dict->writeLock);
+    pthread_rwlock_destroy(&dict->trieLock);
+#endif
+    free(dict->synonymFile);
+    free(dict->snapshotFile);
+    free(dict->historyFile);
+    free(dict->walFile);
+    free(dict->walOldFile);
+    free(dict);
+}
+
+// Jumlah kata utama di index, termasuk yang masih dilayani dari snapshot
+size_t dictionaryWordCount(Dictionary *dict)
+{
+    return dict->index.count + snapshotWordCount(dict);
+}
+
+// Kamus yang sedang diumumkan di slot. Pemanggil harus berada di dalam
+// dictReadBegin/dictReadEnd selama memakai hasilnya.
+Dictionary *dictionaryAcquire(Dictionary **slot)
+{
+    return LOAD_ACQUIRE(slot);
+}
+
+// Umumkan next di slot dan kembalikan kamus sebelumnya. Pembaca baru
+// langsung melihat next tanpa menunggu; kamus lama dilepas dengan
+// dictionaryRetire.
+Dictionary *dictionaryPublish(Dictionary **slot, Dictionary *next)
+{
+    return __atomic_exchange_n(slot, next, __ATOMIC_ACQ_REL);
+}
+
+// Tunggu pembaca yang mungkin masih memegang old, lalu lepas old
+void dictionaryRetire(Dictionary *old)
+{
+    if(!old) return;
+    epochSynchronize();
+    dictionaryFree(old);
+}
@@ -1,48 +1,508 @@
 #ifndef FUNCTIONS_H
 #define FUNCTIONS_H
-#define HASH_SIZE 503
-#define ALPHABET_SIZE 26
-#define SYNONYM_FILE "synonymList.txt"
-#define HISTORY_FILE "history.txt"
+#define HASH_INITIAL_SIZE 512   // harus pangkat dua
+#define HASH_MAX_LOAD_FACTOR 1.0
+#define HASH_REHASH_STEP 4      // bucket yang dipindah per operasi saat rehash
+#define INDEX_MAX_LOAD_FACTOR 0.75 // untuk backend open addressing
+#define INDEX_INLINE_KEY 12     // byte kata yang disalin ke dalam slot
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define STRING_POOL_INITIAL_SIZE 1024
+#define STRING_CLASS_BYTES 8     // string ter-intern diambil dari slab per kelas 8, 16, ... byte
+#define STRING_CLASSES 16        // sampai 128 byte; yang lebih panjang dari malloc
+#define LOAD_CHUNK_BYTES (4 * 1024 * 1024) // ukuran chunk saat load paralel
+#define LOAD_THREADS_MAX 64
+#define STREAM_BLOCK_BYTES (1024 * 1024) // ukuran blok baca mode rewrite
+#define STREAM_BLOCKS 8                  // blok yang beredar di pipeline rewrite (batas memori)
+#define STREAM_RESOLVE_BATCH 128         // token yang dicari lalu ditulis bersamaan
+#define BATCH_COMMANDS 4096              // perintah per batch di mode batch (default)
+#define TRIE_COMPLETE_LIMIT 10   // jumlah saran autocomplete di menu
+#define TRIE_PAGE_SIZE 20        // kata per halaman saat menampilkan range
+#define TRIE_FUZZY_DISTANCE 2    // jarak edit terjauh yang didukung trieFuzzy (lihat README)
+#define TRIE_FUZZY_ERROR ((size_t)-1) // hasil trieFuzzy untuk jarak di luar 0..TRIE_FUZZY_DISTANCE
+#define TRIE_SUFFIX_BYTES 4      // panjang akhiran kunci di indeks akhiran trie (lihat trie.c)
+#define TRIE_CHILD_CLASSES 8     // kelas kapasitas array anak trie: 2, 4, ..., 256
+#define SYNONYM_INLINE 4         // sinonim yang disimpan langsung di WordEntry
+#define GRAPH_BACKLINKS_INITIAL 4 // kapasitas awal array sisi balik graf sinonim
+#define LOOKUP_BATCH 16          // kata yang di-prefetch bersamaan oleh findWords
+#define WORD_ITER_BATCH 16       // entry yang di-prefetch bersamaan oleh wordIterNext
+#define SYNONYM_FILE "synonymList.txt"   // file dasar yang dibuka main.c
+#define SNAPSHOT_EXT ".snap"
+#define SNAPSHOT_VERSION 4           // 2: kunci trie UTF-8 utuh, 3: generasi log di header, 4: index dan checksum per blok
+#define SNAPSHOT_BLOCK (16 * 1024)   // byte per checksum blok snapshot, dicek saat pertama dibaca
+#define HISTORY_FILE "history.txt"      // riwayat yang dibuka main.c
+#define HISTORY_CAPACITY 100000    // record riwayat yang disimpan (SYNONYM_HISTORY_LIMIT)
+#define WAL_EXT ".wal"                         // log di samping file dasar
+#define WAL_OLD_EXT ".wal.old"                 // log yang sedang dipadatkan
+#define WAL_SYNC_MS 100                        // interval group commit, 0 = fsync tiap operasi
+#define WAL_COMPACT_BYTES (8 * 1024 * 1024)    // log sebesar ini dipadatkan ke file dasar
+#define EPOCH_MAX_READERS 256   // thread pembaca yang dilacak per slot (lihat epoch.c)
+#define EPOCH_RECLAIM_BATCH 64  // node pensiun sebelum penulis mencoba melepasnya
+
+// Jenis record di write-ahead log (lihat wal.c)
+#define WAL_OP_ADD_WORD 'W'
+#define WAL_OP_ADD_SYNONYM 'S'
+#define WAL_OP_DELETE_WORD 'w'
+#define WAL_OP_DELETE_SYNONYM 's'
+#define WAL_OP_HISTORY 'H'
+#define WAL_OP_GENERATION 'G'    // awal segmen log, argumennya nomor generasi
+
+#define STREAM_ANNOTATE 0   // tulis kata lalu [sinonim1|sinonim2|...]
+#define STREAM_REPLACE 1    // ganti kata dengan sinonim terbarunya
+
+// Hasil addWordLocked, addSynonymLocked, deleteWordLocked, deleteSynonymLocked
+#define EDIT_OK 0
+#define EDIT_EXISTS 1       // kata atau sinonim sudah ada
+#define EDIT_NO_ENTRY 2     // kata utamanya tidak ada
+#define EDIT_NOT_FOUND 3    // yang mau dihapus tidak ada
+#define EDIT_FAILED 4       // alokasi gagal
+
+// Operasi yang dihitung dan diukur latensinya (lihat stats.c)
+#define STATS_FIND 0            // findWord
+#define STATS_FIND_BATCH 1      // findWords, satu panggilan
+#define STATS_ADD_WORD 2
+#define STATS_ADD_SYNONYM 3
+#define STATS_DELETE_WORD 4
+#define STATS_DELETE_SYNONYM 5
+#define STATS_LOAD 6            // loadFromFileSynonym atau snapshot
+#define STATS_SAVE 7            // saveToFileSynonym
+#define STATS_OPS 8
+
+// Counter jalur panas
+#define STATS_CHAIN_WALKS 0     // rantai/probe yang ditelusuri oleh findWord yang diukur
+#define STATS_CHAIN_STEPS 1     // entry/slot yang dibandingkan selama itu
+#define STATS_FIND_RETRIES 2    // lookup yang diulang karena penulis mengubah tabel
+#define STATS_BATCH_WORDS 3     // kata yang dicari lewat findWords
+#define STATS_REHASH_MOVES 4    // entry yang dipindah oleh rehash bertahap
+#define STATS_ARENA_BLOCKS 5    // blok arena dari malloc
+#define STATS_ARENA_ALLOCS 6
+#define STATS_SLAB_REUSES 7     // slabAlloc yang dilayani free list
+#define STATS_SET_ALLOCS 8      // SynonymSet baru (membesar atau dibangun ulang)
+#define STATS_RETIRED 9         // node yang dipensiunkan lewat retireNode
+#define STATS_COUNTERS 10
+
+#define STATS_SAMPLE 128        // lookup yang diukur: 1 dari sekian, pangkat dua (SYNONYM_STATS_SAMPLE)
+#define STATS_CHAIN_HISTOGRAM 8 // panjang rantai 0..7 dihitung sendiri, sisanya jadi satu
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+// Akses atomik untuk field yang dibaca pembaca tanpa lock (lihat epoch.c)
+#define LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+// Hash djb2 diaduk dulu (finalizer murmur3) sebelum dipakai sebagai posisi
+// di tabel linear probing: kata yang hanya beda huruf terakhir punya hash
+// djb2 yang berurutan, dan linear probing menumpuknya menjadi cluster panjang
+static inline unsigned int mixHash(unsigned int h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+// Instrumentasi (lihat stats.c). STATS_BEGIN di awal fungsi, lalu STATS_END
+// sebelum kembali, atau "return STATS_RETURN(op, nilai)". findWord memakai
+// STATS_LOOKUP_BEGIN yang tidak memanggil fungsi kecuali lookup itu diukur.
+// Dengan -DSYNONYM_NO_STATS semuanya hilang dari build.
+#ifndef SYNONYM_NO_STATS
+#ifndef _WIN32
+#define STATS_THREAD __thread
+#else
+#define STATS_THREAD
+#endif
+#define STATS_BEGIN(op) uint64_t statsStart_ = statsStart(op)
+#define STATS_LOOKUP_BEGIN() uint64_t statsStart_ = statsLookupStart()
+#define STATS_END(op) (statsStart_ ? statsEnd((op), statsStart_) : (void)0)
+#define STATS_RETURN(op, value) (STATS_END(op), (value))
+#define STATS_COUNT(counter, n) statsCount((counter), (n))
+#define STATS_WALK(steps) (statsTracing ? statsWalk(steps) : (void)0)
+#else
+#define STATS_BEGIN(op) ((void)0)
+#define STATS_LOOKUP_BEGIN() ((void)0)
+#define STATS_END(op) ((void)0)
+#define STATS_RETURN(op, value) (value)
+#define STATS_COUNT(counter, n) ((void)0)
+#define STATS_WALK(steps) ((void)0)
+#endif
 
 /*
     copy to terminal to create .exe program : 
-    gcc history.c synonym.c main.c -o program
+    gcc arena.c dictionary.c epoch.c history.c hashtable.c trie.c loader.c snapshot.c wal.c text.c graph.c synonymset.c stream.c batch.c stats.c synonym.c main.c -o program -pthread
+
+    tambahkan -DWORD_INDEX_OPEN untuk memakai index open addressing
+    (lihat hashtable.c) sebagai ganti hash table chaining, dan
+    -DSYNONYM_NO_STATS untuk membuang instrumentasi (lihat stats.c).
 */
 
 // declaration the data struture
-typedef struct SynonymNode 
+// Sinonim satu kata utama setelah tidak muat lagi di WordEntry (lihat synonymset.c).
+// items sesuai urutan ditambahkan; sinonim yang dihapus menjadi NULL di tempatnya.
+typedef struct SynonymSet
 {
-    char* word;
-    struct SynonymNode* next;
-} SynonymNode;
+    uint32_t count;         // sinonim yang masih ada
+    uint32_t used;          // slot items yang sudah terpakai, termasuk yang NULL
+    uint32_t cap;
+    uint32_t mask;          // ukuran index - 1
+    uint32_t *index;        // posisi + 1 di items per slot hash, 0 = kosong; hanya untuk penulis
+    const char *items[];    // string dari internString, jangan di-free
+} SynonymSet;
 
 // Struktur node untuk kata utama di Hash table
 typedef struct WordEntry {
-    char* word;
-    SynonymNode* synonyms;  // linked list sinonim
+    const char* word;       // string dari internString, jangan di-free
+    SynonymSet* synonyms;   // NULL selama sinonim muat di inlineSynonyms
     struct WordEntry* next; // untuk collision chaining
+    uint32_t inlineCount;   // sinonim inline yang masih ada
+    uint32_t inlineUsed;    // slot inline yang sudah terpakai, termasuk yang NULL
+    const char *inlineSynonyms[SYNONYM_INLINE];
 } WordEntry;
 
-// Trie node untuk sesuai urutan
+// Posisi saat membaca sinonim satu entry, dari yang terbaru
+typedef struct SynonymIter
+{
+    const char *const *items;
+    uint32_t next;
+} SynonymIter;
+
+// Node radix tree untuk sesuai urutan (lihat trie.c)
 typedef struct TrieNode {
-    struct TrieNode *children[ALPHABET_SIZE];
-    int isEndOfWord; // 1 jika akhir kata
+    const char *label;          // potongan kunci, menunjuk ke string ter-intern
+    unsigned int labelLen;
+    unsigned short childCount;
+    unsigned short childCap;
+    struct TrieNode **children; // terurut menurut byte pertama label, diikuti childCap byte kunci
+    struct WordEntry *entry;    // kata utama yang kuncinya berakhir di node ini, NULL = bukan akhir kata
 } TrieNode;
 
-typedef struct HistoryNode
-{ 
-    char* action;
-    char* time;
-    struct HistoryNode* next;
-} HistoryNode;
+// Kunci yang menunggu dimasukkan ke trie (lihat trieReady)
+typedef struct TrieSeed
+{
+    const char *key;            // kunci ter-intern yang sudah dinormalisasi
+    struct WordEntry *entry;
+} TrieSeed;
+
+// Kunci trie yang berakhiran sama (lihat suffixBucket di trie.c)
+typedef struct SuffixBucket
+{
+    const char **keys;          // kunci ter-intern milik trie, tanpa urutan
+    uint32_t count, cap;
+} SuffixBucket;
+
+// Indeks akhiran untuk trieFuzzy jarak 2, buckets NULL = belum dibangun
+typedef struct SuffixIndex
+{
+    SuffixBucket *buckets;
+    size_t mask;                // jumlah bucket - 1
+    size_t count;               // kunci di semua bucket
+} SuffixIndex;
+
+// Cursor untuk membaca kata terurut di antara dua batas, halaman demi halaman
+typedef struct TrieCursor
+{
+    char *lastKey;      // batas bawah, lalu kata terakhir yang sudah dikembalikan
+    char *upperKey;     // batas atas inklusif, NULL = tanpa batas
+    int started;
+    int done;
+    int (*visit)(const char *word, void *ctx);
+    void *ctx;
+} TrieCursor;
+
+// Isi file yang dipetakan ke memori (lihat loader.c)
+typedef struct MappedFile
+{
+    const char *data;
+    size_t size;
+    int mapped;     // 1 jika dari mmap, 0 jika dibaca ke buffer
+} MappedFile;
+
+// Hasil parse satu chunk file sinonim (lihat loader.c); string disimpan
+// sebagai offset ke teks chunk karena buffer teks bisa di-realloc
+typedef struct LoadToken
+{
+    size_t offset;
+    unsigned int hash;
+} LoadToken;
+
+typedef struct LoadLine
+{
+    LoadToken word;
+    size_t synonymStart;    // index sinonim pertama baris ini
+} LoadLine;
+
+typedef struct LoadChunk
+{
+    const char *start;
+    const char *end;
+    char *text;
+    size_t textLen, textCap;
+    LoadLine *lines;
+    size_t lineCount, lineCap;
+    LoadToken *synonyms;
+    size_t synonymCount, synonymCap;
+    int ready;
+} LoadChunk;
+
+// Hasil satu kali streamRewrite (lihat stream.c)
+typedef struct StreamStats
+{
+    uint64_t bytesIn;
+    uint64_t bytesOut;
+    uint64_t tokens;
+    uint64_t matched;       // token yang ada di kamus
+} StreamStats;
+
+// Snapshot biner (lihat snapshot.c). Semua offset dihitung dari awal file,
+// jadi file bisa langsung di-mmap di alamat mana pun tanpa relokasi.
+typedef struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t checksum;          // checksum tabel blockSums
+    uint64_t fileSize;
+    uint64_t stringCount;
+    uint64_t entryCount;
+    uint64_t synonymCount;
+    uint64_t bucketCount;       // pangkat dua, posisi string = mixHash(hash) & (bucketCount - 1)
+    uint64_t blockCount;        // blok SNAPSHOT_BLOCK byte dari headerSize sampai blockSumsOffset
+    uint64_t stringsOffset;     // SnapshotString[stringCount], terurut menurut posisinya
+    uint64_t entriesOffset;     // SnapshotEntry[entryCount], terurut menurut kunci trie
+    uint64_t synonymsOffset;    // uint32_t[synonymCount], index string
+    uint64_t bucketsOffset;     // uint32_t[bucketCount + 1], index string pertama tiap posisi
+    uint64_t entryOfOffset;     // uint32_t[stringCount], entry yang katanya string ini, atau SNAPSHOT_NONE
+    uint64_t textOffset;        // string berakhiran '\0', paling banyak 4 GB
+    uint64_t textSize;
+    uint64_t blockSumsOffset;   // uint64_t[blockCount], checksum tiap blok
+    uint64_t generation;        // generasi log terakhir yang sudah masuk, 0 = tidak diketahui
+} SnapshotHeader;
+
+typedef struct SnapshotString
+{
+    uint32_t offset;            // dari textOffset, string berakhir di '\0' berikutnya
+    uint32_t hash;              // hash(str), supaya tidak dihitung ulang saat load
+} SnapshotString;
+
+typedef struct SnapshotEntry
+{
+    uint32_t word;              // index string
+    uint32_t trieKey;           // index string kunci trie, SNAPSHOT_NONE jika tidak ada
+    uint32_t synonymStart;      // index pertama di tabel sinonim
+    uint32_t synonymCount;
+} SnapshotEntry;
+
+// Snapshot yang dilayani langsung dari file yang di-mmap (lihat snapshot.c).
+// Tabel menunjuk ke dalam file; WordEntry kata dari snapshot baru diisi
+// saat kata itu pertama kali dipakai.
+typedef struct SnapshotIndex
+{
+    const SnapshotString *strings;
+    const SnapshotEntry *entries;
+    const uint32_t *synonyms;
+    const uint32_t *buckets;
+    const uint32_t *entryOf;
+    const char *text;
+    const char *blocks;         // awal daerah yang dicek per blok
+    const uint64_t *blockSums;
+    uint64_t stringCount, entryCount, synonymCount, bucketCount, textSize, blockCount;
+    uint64_t *checked;          // bit per blok yang checksum-nya sudah cocok
+    int allChecked;             // 1 jika semua blok sudah cocok
+    WordEntry *words;           // satu per entry, NULL = tidak ada kata dari snapshot
+    unsigned char *state;       // SNAPSHOT_ENTRY_* per entry
+    size_t live;                // entry yang belum dihapus atau rusak
+    int damaged;                // 1 jika ada blok yang checksum-nya salah
+} SnapshotIndex;
+
+// Keadaan WordEntry milik snapshot (SnapshotIndex.state)
+#define SNAPSHOT_ENTRY_NEW 0    // belum pernah dipakai
+#define SNAPSHOT_ENTRY_BUSY 1   // sedang diisi oleh satu thread
+#define SNAPSHOT_ENTRY_READY 2
+#define SNAPSHOT_ENTRY_GONE 3   // dihapus, atau bloknya rusak
+
+#define SNAPSHOT_NONE 0xFFFFFFFFu
+
+// Satu aksi di riwayat (lihat history.c)
+typedef struct HistoryRecord
+{
+    int64_t time;               // detik sejak 1970 (time_t)
+    const char *word;           // kata utama, atau teks aksi untuk WAL_OP_HISTORY
+    const char *synonym;        // NULL kecuali untuk aksi sinonim
+    uint64_t prevWord;          // seq record sebelumnya yang menyentuh word, 0 = tidak ada
+    uint64_t prevSynonym;       // idem untuk synonym
+    char op;                    // WAL_OP_ADD_WORD, ..., WAL_OP_HISTORY = teks bebas
+} HistoryRecord;
+
+// Arena bump-pointer: memori diambil per blok besar dan dilepas sekaligus
+typedef struct ArenaBlock
+{
+    struct ArenaBlock *next;
+    size_t used;
+    size_t size;
+    char data[];
+} ArenaBlock;
+
+typedef struct Arena
+{
+    ArenaBlock *head;
+    size_t blockCount;
+    size_t reserved;    // total byte yang sudah diambil dari malloc
+} Arena;
+
+// Node berukuran tetap dari arena, dengan free list untuk node yang dihapus
+typedef struct Slab
+{
+    void *freeList;
+    size_t objectSize;
+    Arena *arena;
+} Slab;
+
+// Sisi balik graf sinonim: kata utama yang mencantumkan satu string (lihat graph.c)
+typedef struct Backlinks
+{
+    uint32_t count;
+    uint32_t cap;
+    struct WordEntry *entries[];
+} Backlinks;
+
+// Set string ter-intern (open addressing). Setiap string menghitung
+// pemegangnya (kata utama, sinonim, kunci trie) dan dilepas saat tidak ada
+// lagi yang memegangnya (lihat internRelease).
+typedef struct PoolSlot
+{
+    const char *str;
+    unsigned int hash;
+    uint32_t refs;          // jumlah pemegang, atau POOL_PINNED
+    Backlinks *listedBy;    // NULL selama graf belum dibangun atau tidak ada yang mencantumkan
+} PoolSlot;
+
+#define POOL_PINNED 0x80000000u // string di luar pool (snapshot), tidak pernah dilepas
+
+typedef struct StringPool
+{
+    PoolSlot *slots;
+    size_t size;
+    size_t count;
+} StringPool;
+
+#ifndef WORD_INDEX_OPEN
+// Array bucket beserta ukurannya dalam satu alokasi. Ukurannya tidak pernah
+// berubah, jadi pembaca tanpa lock yang memuat satu pointer selalu
+// mendapat ukuran yang cocok dengan array-nya.
+typedef struct BucketArray
+{
+    size_t size;        // jumlah bucket
+    WordEntry *head[];
+} BucketArray;
+
+// Hash table dengan chaining yang membesar sendiri.
+// Saat resize, bucket dari tabel lama dipindah sedikit demi sedikit
+// di setiap insert/delete, jadi tidak ada satu operasi yang berhenti lama.
+typedef struct HashTable
+{
+    BucketArray *buckets;
+    size_t count;       // jumlah entry
+    BucketArray *oldBuckets; // tabel lama selama rehash berjalan
+    size_t rehashIndex; // bucket lama berikutnya yang akan dipindah
+    unsigned long seq;  // ganjil selama penulis mengubah tabel
+} HashTable;
+#else
+// Slot index open addressing: hash dan awal kata disimpan inline
+// supaya lookup kata pendek selesai dalam satu cache line.
+typedef struct IndexSlot
+{
+    unsigned int hash;
+    char key[INDEX_INLINE_KEY]; // kata utuh jika < INDEX_INLINE_KEY, selain itu awalannya
+    WordEntry *entry;
+} IndexSlot;
+
+// Slot dan byte kontrolnya dalam satu alokasi yang tidak pernah berubah
+// ukuran, sama seperti BucketArray
+typedef struct SlotArray
+{
+    size_t size;
+    unsigned char *ctrl;  // byte kontrol per slot: 7 bit hash, EMPTY, atau DELETED; sesudah slot[]
+    IndexSlot slot[];
+} SlotArray;
+
+typedef struct HashTable
+{
+    SlotArray *slots;
+    size_t count;
+    size_t tombstones;
+    SlotArray *oldSlots;  // tabel lama selama rehash berjalan
+    size_t rehashIndex;
+    unsigned long seq;    // ganjil selama penulis mengubah tabel
+} HashTable;
+#endif
+
+typedef struct HashTableIter
+{
+    int inOld;
+    size_t index;
+    WordEntry *next;
+    size_t mapped;      // posisi di snapshot setelah tabel habis, SIZE_MAX = tabel saja
+} HashTableIter;
+
+// Iterator kata utama terurut menurut kunci trie (lihat wordIterNext)
+typedef struct WordIter
+{
+    const TrieNode **stack;     // node yang belum dikunjungi, berikutnya di puncak
+    size_t top, cap;
+    struct WordEntry *batch[WORD_ITER_BATCH]; // entry berikutnya yang sudah di-prefetch
+    unsigned int batchNext, batchCount;
+    HashTableIter bucket;       // dipakai jika trie tidak memuat semua kata
+    int sorted;                 // 1 = terurut, 0 = urutan bucket hash table
+    int failed;                 // alokasi stack gagal, hasilnya terpotong
+} WordIter;
 
-// declare global variable
-extern WordEntry* hashTable[HASH_SIZE];
-extern HistoryNode *historyTop;
-extern TrieNode *rootTrie;
+// Bentuk index kata saat ini (lihat hashTableStats). Untuk chaining yang
+// dihitung panjang rantai per bucket, untuk open addressing jarak slot dari
+// posisi awalnya.
+typedef struct IndexStats
+{
+    size_t slots;           // bucket atau slot, termasuk tabel lama selama rehash
+    size_t used;            // bucket yang tidak kosong / slot yang terisi
+    size_t entries;
+    size_t tombstones;      // hanya open addressing
+    size_t longest;         // rantai terpanjang / jarak probe terjauh
+    size_t total;           // jumlah panjang rantai / jarak probe
+    size_t histogram[STATS_CHAIN_HISTOGRAM + 1];
+    size_t bytes;
+} IndexStats;
+
+typedef struct TrieStats
+{
+    size_t nodes;
+    size_t words;
+    size_t maxDepth;        // node dari root ke daun terdalam
+    size_t childSlots;      // kapasitas semua array anak
+    size_t children;        // slot yang terpakai
+    size_t labelBytes;      // jumlah panjang label = node trie tanpa path compression
+    size_t bytes;           // node dan array anak yang dipakai, tanpa free list slab
+    size_t arenaBytes;      // arena trie yang sudah dipesan, termasuk free list
+} TrieStats;
+
+// Node yang menunggu dilepas sampai tidak ada pembaca yang memegangnya (lihat epoch.c)
+typedef struct RetiredNode
+{
+    void *ptr;
+    Slab *slab;         // NULL = dilepas dengan free()
+    uint64_t epoch;
+} RetiredNode;
+
+// Satu kamus lengkap: index, trie, riwayat, semua memorinya, dan nama file
+// tempat kamus disimpan. Tidak ada state kamus yang global, jadi satu proses
+// bisa memegang beberapa kamus dan membangun versi baru di belakang lalu
+// menukarnya (lihat dictionary.c). Isinya didefinisikan di
+// dictionary_private.h dan hanya disentuh lewat fungsi-fungsi di bawah.
+typedef struct Dictionary Dictionary;
 
 // declaration the functions here
 // global
@@ -53,31 +513,214 @@ void trim_and_tocapital(char *word);
 void trim(char *word);
 
 // create node and hash
-SynonymNode *createSynonymNode(const char *word);
-WordEntry *createWordEntry(const char *word);
-WordEntry *findWord(const char *word);
-HistoryNode *createHistoryNode(const char *action);
-TrieNode *createTrieNode();
+WordEntry *createWordEntry(Dictionary *dict, const char *word);
+WordEntry *findWord(Dictionary *dict, const char *word);
+size_t findWords(Dictionary *dict, const char *const *words, size_t count, WordEntry **entries);
+TrieNode *createTrieNode(Dictionary *dict);
 unsigned int hash(const char *str);
 
+// dictionary.c
+Dictionary *dictionaryCreate(const char *synonymFile, const char *historyFile);
+void dictionaryFree(Dictionary *dict);
+size_t dictionaryWordCount(Dictionary *dict);
+Dictionary *dictionaryAcquire(Dictionary **slot);
+Dictionary *dictionaryPublish(Dictionary **slot, Dictionary *next);
+void dictionaryRetire(Dictionary *old);
+
+// text.c (trim, trim_and_tolower, trim_and_tocapital dan hash juga di sini)
+unsigned int hashBytes(const char *str, size_t len);
+const char *textKernelName(void);
+int textUseKernel(const char *name);
+size_t upperFirst(const char *word, char *first);
+size_t lowerFirst(const char *word, char *first);
+
+// arena.c
+void *arenaAlloc(Arena *arena, size_t size);
+void arenaFree(Arena *arena);
+void *slabAlloc(Slab *slab);
+void slabFree(Slab *slab, void *ptr);
+void slabInit(Slab *slab, size_t objectSize, Arena *arena);
+void slabReset(Slab *slab);
+const char *internString(Dictionary *dict, const char *str);
+const char *internStringHashed(Dictionary *dict, const char *str, unsigned int h);
+const char *internAdopt(Dictionary *dict, const char *str, unsigned int h);
+const char *internFind(Dictionary *dict, const char *str);
+void internRelease(Dictionary *dict, const char *interned);
+PoolSlot *internSlot(Dictionary *dict, const char *interned);
+size_t pointerHash(const void *p);
+void internReserve(Dictionary *dict, size_t count);
+size_t stringPoolSizeFor(size_t count);
+void freeStringPool(Dictionary *dict);
+
+// epoch.c
+void dictReadBegin(void);
+void dictReadEnd(void);
+void dictWriteBegin(Dictionary *dict);
+void dictWriteEnd(Dictionary *dict);
+void retireNode(Dictionary *dict, Slab *slab, void *ptr);
+void epochReclaim(Dictionary *dict);
+void epochSynchronize(void);
+void epochShutdown(Dictionary *dict);
+
+// hashtable.c
+int initHashTable(HashTable *table, size_t size);
+void hashTableReserve(Dictionary *dict, size_t count);
+WordEntry *hashTableFind(Dictionary *dict, const char *word);
+WordEntry *hashTableFindHashed(Dictionary *dict, const char *word, unsigned int h);
+void hashTableFindBatch(Dictionary *dict, const char *const *words, size_t count, WordEntry **out);
+int hashTableInsert(Dictionary *dict, WordEntry *entry);
+int hashTableInsertHashed(Dictionary *dict, WordEntry *entry, unsigned int h);
+WordEntry *hashTableRemove(Dictionary *dict, const char *word);
+void hashTableIterInit(HashTableIter *it);
+void hashTableStats(Dictionary *dict, IndexStats *stats);
+WordEntry *hashTableNext(Dictionary *dict, HashTableIter *it);
+void freeHashTable(Dictionary *dict);
+
 // synonym.c
-void addSynonym(const char *word, const char *synonym, const int condition);
-void addWord(const char* str, const int condition);
-void printSynonyms(const char* str);
-void saveToFileSynonym(const char* filename);
-void loadFromFileSynonym(const char* filename);
-void printAllWords(void);
-void freeMemorySynonym(void);
-void freeTrieNode(TrieNode *root);
-void menu(void);
+WordEntry *insertWordEntry(Dictionary *dict, const char *word);
+const char *appendSynonym(Dictionary *dict, WordEntry *entry, const char *interned);
+int addWordLocked(Dictionary *dict, const char *word, const int condition);
+int addSynonymLocked(Dictionary *dict, const char *word, const char *synonym, const int condition);
+int deleteWordLocked(Dictionary *dict, const char *word);
+int deleteSynonymLocked(Dictionary *dict, const char *word, const char *synonym);
+void addSynonym(Dictionary *dict, const char *word, const char *synonym, const int condition);
+void addWord(Dictionary *dict, const char* str, const int condition);
+int removeWordEntry(Dictionary *dict, const char *word);
+int removeSynonym(Dictionary *dict, WordEntry *entry, const char *synonym);
+void deleteWordEntry(Dictionary *dict, const char *word);
+void deleteSynonym(Dictionary *dict, const char *word, const char *synonym);
+void printSynonyms(Dictionary *dict, const char* str);
+int saveToFileSynonym(Dictionary *dict, const char* filename);
+void printAllWords(Dictionary *dict);
+void printCompletions(Dictionary *dict, const char *prefix);
+void printListedBy(Dictionary *dict, const char *word);
+void printRelated(Dictionary *dict, const char *word, int maxHops);
+void printWordRange(Dictionary *dict, const char *from, const char *to);
+void freeMemorySynonym(Dictionary *dict);
+void menu(Dictionary *dict);
+
+// loader.c
+int mapFile(const char *filename, MappedFile *file);
+void unmapFile(MappedFile *file);
+int syncFile(FILE *fp);
+FILE *openReplacement(const char *filename, char **tmpName);
+int commitReplacement(FILE *fp, char *tmpName, const char *filename, int ok);
+int writeReplacement(const char *filename, const void *data, size_t size);
+void loadFromFileSynonym(Dictionary *dict, const char* filename);
+char *pathWithExtension(const char *file, const char *ext);
+void loadDictionary(Dictionary *dict);
+
+// stream.c
+int streamRewrite(Dictionary *dict, FILE *in, FILE *out, int mode, StreamStats *stats);
+
+// batch.c
+int runBatch(Dictionary *dict, FILE *in, FILE *out, size_t batchSize);
+int readLine(FILE *in, char **line, size_t *cap);
+
+// snapshot.c
+int isSnapshotFile(const char *filename);
+int snapshotIsFresh(const char *snapshotFile, const char *textFile);
+int saveSnapshot(Dictionary *dict, const char *filename);
+char *snapshotImage(Dictionary *dict, uint64_t generation, size_t *size);
+int saveSnapshotText(const char *image, const char *filename);
+int loadSnapshot(Dictionary *dict, const char *filename);
+void closeSnapshot(Dictionary *dict);
+WordEntry *snapshotFindWord(Dictionary *dict, const char *word, unsigned int h);
+WordEntry *snapshotRemoveWord(Dictionary *dict, const char *word, unsigned int h);
+WordEntry *snapshotNextWord(Dictionary *dict, size_t *pos, const char **key);
+const char *snapshotFindString(Dictionary *dict, const char *str, unsigned int h);
+size_t snapshotWordCount(Dictionary *dict);
+int snapshotOwnsEntry(const Dictionary *dict, const WordEntry *entry);
+int snapshotOwnsString(const Dictionary *dict, const char *str);
+int snapshotDamaged(Dictionary *dict);
+
+// wal.c
+void walOpen(Dictionary *dict);
+void walAppend(Dictionary *dict, char op, const char *a, const char *b);
+int walSync(Dictionary *dict);
+void walClose(Dictionary *dict);
+
+// trie.c
+const char *trieKeyOf(Dictionary *dict, const char *word);
+void insertToTrie(Dictionary *dict, WordEntry *entry);
+void insertTrieKey(Dictionary *dict, const char *key, WordEntry *entry);
+int deleteFromTrie(Dictionary *dict, const char *word);
+void printAllWordsTrie(Dictionary *dict);
+void wordIterInit(Dictionary *dict, WordIter *it);
+WordEntry *wordIterNext(Dictionary *dict, WordIter *it);
+void wordIterFree(WordIter *it);
+size_t trieComplete(Dictionary *dict, const char *prefix, size_t k,
+                    int (*visit)(const char *word, void *ctx), void *ctx);
+size_t trieFuzzy(Dictionary *dict, const char *word, int maxDistance, size_t k,
+                 int (*visit)(const char *word, int distance, void *ctx), void *ctx);
+int trieCursorInit(TrieCursor *cursor, const char *from, const char *to);
+size_t trieCursorNext(Dictionary *dict, TrieCursor *cursor, size_t k,
+                      int (*visit)(const char *word, void *ctx), void *ctx);
+void trieCursorFree(TrieCursor *cursor);
+void trieStats(Dictionary *dict, TrieStats *stats);
+void freeTrieNode(Dictionary *dict);
+
+// synonymset.c
+size_t synonymCount(const WordEntry *entry);
+int synonymContains(const WordEntry *entry, const char *interned);
+void synonymReserve(Dictionary *dict, WordEntry *entry, size_t count);
+int synonymInsert(Dictionary *dict, WordEntry *entry, const char *interned);
+int synonymErase(WordEntry *entry, const char *interned);
+void synonymIterInit(const WordEntry *entry, SynonymIter *it);
+const char *synonymNext(SynonymIter *it);
+size_t synonymSetBytes(const WordEntry *entry);
+
+// graph.c
+void graphLink(Dictionary *dict, WordEntry *entry, const char *synonym);
+void graphUnlink(Dictionary *dict, WordEntry *entry, const char *synonym);
+void graphReset(Dictionary *dict);
+size_t graphBytes(Dictionary *dict);
+size_t synonymListedBy(Dictionary *dict, const char *word,
+                       int (*visit)(const char *word, void *ctx), void *ctx);
+size_t relatedWords(Dictionary *dict, const char *word, int maxHops,
+                    int (*visit)(const char *word, int hops, void *ctx), void *ctx);
 
 // history.c
-void pushLoadedHistory(const char *time, const char *action);
-void saveToFileHistory(const char *filename);
-void loadFromFileHistory(const char *filename);
-void getCurrentTimestamp(char *buffer, size_t size);
-void pushHistory(const char *action);
-void printHistory(void);
-void freeHistory(void);
+int historyInit(Dictionary *dict);
+void pushLoadedHistory(Dictionary *dict, const char *time, const char *action);
+int saveToFileHistory(Dictionary *dict, const char *filename);
+char *historyText(Dictionary *dict, uint64_t generation, size_t *size);
+void loadFromFileHistory(Dictionary *dict, const char *filename);
+int formatHistoryAction(const HistoryRecord *record, char *buffer, size_t size);
+void formatHistoryTime(int64_t time, char *buffer, size_t size);
+int64_t parseHistoryTime(const char *text);
+void pushHistory(Dictionary *dict, char op, const char *word, const char *synonym);
+size_t historyBetween(Dictionary *dict, int64_t from, int64_t to, size_t k,
+                      int (*visit)(const HistoryRecord *record, void *ctx), void *ctx);
+size_t historyForWord(Dictionary *dict, const char *word, size_t k,
+                      int (*visit)(const HistoryRecord *record, void *ctx), void *ctx);
+void printHistory(Dictionary *dict);
+void printHistoryBetween(Dictionary *dict, const char *from, const char *to);
+void printHistoryForWord(Dictionary *dict, const char *word);
+void freeHistory(Dictionary *dict);
+size_t historyBytes(Dictionary *dict, size_t *records);
+
+// stats.c
+uint64_t statsStart(int op);
+void statsEnd(int op, uint64_t start);
+void statsCount(int counter, uint64_t n);
+void statsWalk(uint64_t steps);
+uint64_t statsSampleLookup(void);
+void printStats(Dictionary *dict, FILE *out);
+
+#ifndef SYNONYM_NO_STATS
+extern STATS_THREAD uint64_t statsLookups;  // findWord di thread ini, dimulai dari -1
+extern STATS_THREAD int statsTracing;       // lookup yang sedang berjalan diukur
+extern uint64_t statsLookupMask;            // sampel - 1, sampel pangkat dua
+
+// Jalur cepat findWord: satu penambahan per lookup, statsSampleLookup hanya
+// untuk lookup yang diukur
+static inline uint64_t statsLookupStart(void)
+{
+    uint64_t n = statsLookups + 1;
+    __atomic_store_n(&statsLookups, n, __ATOMIC_RELAXED);
+    return (n & __atomic_load_n(&statsLookupMask, __ATOMIC_RELAXED)) ? 0 : statsSampleLookup();
+}
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef DICTIONARY_PRIVATE_H
+#define DICTIONARY_PRIVATE_H
+#include "dictionary.h"
+
+struct WalState;
+struct HistoryLog;
+
+// Isi kamus (lihat dictionary.h). Hanya file library yang meng-include
+// header ini; program lain memegang Dictionary lewat pointer saja.
+struct Dictionary
+{
+    HashTable index;
+    TrieNode *trie;             // root trie
+    size_t trieWords;           // node trie yang menunjuk ke entry
+    int triePending;            // 1 = kata snapshot dan trieSeeds belum masuk trie
+    TrieSeed *trieSeeds;        // kunci yang ditambahkan selama triePending
+    size_t trieSeedCount, trieSeedCap;
+    SuffixIndex trieSuffixes;   // kunci trie menurut akhirannya, untuk trieFuzzy jarak 2
+    struct HistoryLog *history; // ring buffer riwayat (lihat history.c)
+    Arena wordArena;            // entry, sinonim, dan string
+    Arena trieArena;
+    Slab entrySlab;
+    Slab trieSlab;
+    Slab childSlabs[TRIE_CHILD_CLASSES];
+    Slab stringSlabs[STRING_CLASSES];
+    StringPool strings;
+    MappedFile snapshot;        // snapshot yang string-nya masih dipakai kamus
+    SnapshotIndex mapped;       // kata yang dilayani langsung dari snapshot
+    char *synonymFile;          // file dasar, NULL = kamus tanpa file
+    char *snapshotFile;         // synonymFile dengan SNAPSHOT_EXT
+    char *historyFile;          // NULL = riwayat tidak dimuat dari file
+    char *walFile;              // synonymFile dengan WAL_EXT
+    char *walOldFile;           // synonymFile dengan WAL_OLD_EXT
+    struct WalState *wal;       // NULL = perubahan tidak dicatat
+    uint64_t wordGeneration;    // generasi log yang sudah ada di snapshot yang dimuat
+    uint64_t historyGeneration; // idem untuk file riwayat
+    RetiredNode *retired;
+    size_t retiredCount, retiredCap;
+    int graphReady;             // 1 jika sisi balik graf sinonim sudah dibangun
+#ifndef _WIN32
+    pthread_mutex_t writeLock;
+    pthread_rwlock_t trieLock;
+#endif
+};
+
+#endif
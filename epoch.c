@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "dictionary_private.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <time.h>
+#endif
+
+// Sinkronisasi kamus untuk dipakai banyak thread.
+//
+// Pembaca (findWord, printSynonyms) tidak pernah mengambil lock: mereka
+// hanya mengumumkan epoch global saat masuk ke dictReadBegin. Penulis satu
+// kamus dijalankan satu per satu lewat dictWriteBegin. Node yang dilepas penulis
+// (entry, sinonim, array bucket lama) tidak langsung dikembalikan ke slab,
+// tapi "dipensiunkan" dengan epoch saat itu dan baru dilepas setelah semua
+// pembaca yang mungkin masih memegangnya sudah keluar (epoch-based
+// reclamation). Trie memakai rwlock sendiri (lihat trie.c).
+//
+// Epoch pembaca berlaku untuk semua kamus dalam proses, jadi pembaca yang
+// berpindah ke kamus baru (dictionaryPublish) tetap dilindungi skema yang sama.
+
+#ifndef _WIN32
+
+// Satu slot per thread pembaca, masing-masing satu cache line supaya
+// pembaca di core berbeda tidak saling menulis cache line yang sama
+typedef struct EpochSlot
+{
+    uint64_t epoch;     // epoch saat masuk, 0 = tidak sedang membaca
+    int used;
+    char pad[64 - sizeof(uint64_t) - sizeof(int)];
+} __attribute__((aligned(64))) EpochSlot;
+
+static EpochSlot epochSlots[EPOCH_MAX_READERS];
+static uint64_t globalEpoch = 1;
+static unsigned long overflowReaders;   // pembaca tanpa slot (thread > EPOCH_MAX_READERS)
+
+static pthread_key_t slotKey;
+static pthread_once_t slotKeyOnce = PTHREAD_ONCE_INIT;
+
+static __thread int mySlot = -1;
+static __thread int readDepth;
+
+static void releaseSlot(void *arg)
+{
+    (void)arg;
+    if(mySlot >= 0) __atomic_store_n(&epochSlots[mySlot].used, 0, __ATOMIC_RELEASE);
+    mySlot = -1;
+}
+
+static void createSlotKey(void)
+{
+    pthread_key_create(&slotKey, releaseSlot);
+}
+
+// Ambil slot kosong untuk thread ini; slot dilepas lagi saat thread selesai
+static int acquireSlot(void)
+{
+    pthread_once(&slotKeyOnce, createSlotKey);
+    for(int i = 0; i < EPOCH_MAX_READERS; i++)
+    {
+        int expected = 0;
+        if(__atomic_compare_exchange_n(&epochSlots[i].used, &expected, 1, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        {
+            mySlot = i;
+            pthread_setspecific(slotKey, &epochSlots[i]);
+            return i;
+        }
+    }
+    return -1;
+}
+
+void dictReadBegin(void)
+{
+    if(readDepth++) return;
+    if(mySlot < 0 && acquireSlot() < 0)
+    {
+        __atomic_add_fetch(&overflowReaders, 1, __ATOMIC_SEQ_CST);
+        return;
+    }
+
+    // seq_cst: penulis yang tidak melihat slot ini pasti sudah selesai
+    // melepas node sebelum pembaca ini mulai menelusuri
+    __atomic_store_n(&epochSlots[mySlot].epoch, __atomic_load_n(&globalEpoch, __ATOMIC_SEQ_CST),
+                     __ATOMIC_SEQ_CST);
+}
+
+void dictReadEnd(void)
+{
+    if(--readDepth) return;
+    if(mySlot < 0)
+    {
+        __atomic_sub_fetch(&overflowReaders, 1, __ATOMIC_SEQ_CST);
+        return;
+    }
+    __atomic_store_n(&epochSlots[mySlot].epoch, 0, __ATOMIC_RELEASE);
+}
+
+void dictWriteBegin(Dictionary *dict)
+{
+    pthread_mutex_lock(&dict->writeLock);
+}
+
+void dictWriteEnd(Dictionary *dict)
+{
+    pthread_mutex_unlock(&dict->writeLock);
+}
+
+// Epoch terkecil yang masih dipegang pembaca; UINT64_MAX jika tidak ada
+static uint64_t oldestReader(void)
+{
+    if(__atomic_load_n(&overflowReaders, __ATOMIC_SEQ_CST)) return 0;
+
+    uint64_t oldest = UINT64_MAX;
+    for(int i = 0; i < EPOCH_MAX_READERS; i++)
+    {
+        uint64_t e = __atomic_load_n(&epochSlots[i].epoch, __ATOMIC_SEQ_CST);
+        if(e && e < oldest) oldest = e;
+    }
+    return oldest;
+}
+
+#else
+
+// Build Windows tidak memakai thread, jadi semua ini kosong
+void dictReadBegin(void) {}
+void dictReadEnd(void) {}
+void dictWriteBegin(Dictionary *dict) { (void)dict; }
+void dictWriteEnd(Dictionary *dict) { (void)dict; }
+static uint64_t globalEpoch = 1;
+static uint64_t oldestReader(void) { return UINT64_MAX; }
+
+#endif
+
+// Daftar node yang menunggu dilepas ada di tiap kamus dan hanya disentuh penulisnya
+static void releaseNode(RetiredNode *node)
+{
+    if(node->slab) slabFree(node->slab, node->ptr);
+    else free(node->ptr);
+}
+
+// Lepas node yang sudah tidak mungkin dipegang pembaca mana pun.
+// Node yang dipensiunkan di epoch e aman jika semua pembaca aktif masuk
+// setelah epoch e berakhir.
+void epochReclaim(Dictionary *dict)
+{
+    __atomic_add_fetch(&globalEpoch, 1, __ATOMIC_SEQ_CST);
+    uint64_t oldest = oldestReader();
+
+    size_t kept = 0;
+    for(size_t i = 0; i < dict->retiredCount; i++)
+    {
+        if(dict->retired[i].epoch < oldest) releaseNode(&dict->retired[i]);
+        else dict->retired[kept++] = dict->retired[i];
+    }
+    dict->retiredCount = kept;
+}
+
+// Tunggu sampai semua pembaca yang sudah masuk sebelum panggilan ini keluar.
+// Setelah itu tidak ada pembaca yang masih memegang apa pun yang sudah
+// tidak terjangkau saat fungsi ini dipanggil.
+void epochSynchronize(void)
+{
+    uint64_t target = __atomic_add_fetch(&globalEpoch, 1, __ATOMIC_SEQ_CST);
+#ifndef _WIN32
+    while(oldestReader() < target)
+    {
+        struct timespec pause = {0, 100000};
+        nanosleep(&pause, NULL);
+    }
+#else
+    (void)target;
+#endif
+}
+
+// Pensiunkan ptr (dari slab, atau dari malloc jika slab NULL). Penulis harus
+// sudah melepas semua jalan menuju ptr sebelum memanggil ini.
+void retireNode(Dictionary *dict, Slab *slab, void *ptr)
+{
+    if(!ptr) return;
+
+    if(dict->retiredCount == dict->retiredCap)
+    {
+        size_t cap = dict->retiredCap ? dict->retiredCap * 2 : EPOCH_RECLAIM_BATCH * 2;
+        RetiredNode *grown = (RetiredNode *)realloc(dict->retired, cap * sizeof(RetiredNode));
+        if(!grown)
+        {
+            // tanpa memori untuk daftar: lebih aman bocor daripada dilepas terlalu cepat
+            fprintf(stderr, "Failed to allocate memory for retired node.\n");
+            return;
+        }
+        dict->retired = grown;
+        dict->retiredCap = cap;
+    }
+
+    RetiredNode *node = &dict->retired[dict->retiredCount++];
+    node->ptr = ptr;
+    node->slab = slab;
+    node->epoch = __atomic_load_n(&globalEpoch, __ATOMIC_SEQ_CST);
+    STATS_COUNT(STATS_RETIRED, 1);
+
+    if(dict->retiredCount % EPOCH_RECLAIM_BATCH == 0) epochReclaim(dict);
+}
+
+// Saat kamus dilepas: tidak ada pembaca lagi, semua node dilepas
+void epochShutdown(Dictionary *dict)
+{
+    for(size_t i = 0; i < dict->retiredCount; i++)
+        if(!dict->retired[i].slab) free(dict->retired[i].ptr);
+    free(dict->retired);
+    dict->retired = NULL;
+    dict->retiredCount = dict->retiredCap = 0;
+}
@@ -0,0 +1,260 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "dictionary_private.h"
+
+// Graf sinonim dua arah.
+//
+// Sisi maju sudah ada: daftar sinonim tiap WordEntry. Sisi balik ("siapa
+// yang mencantumkan X") disimpan sebagai array adjacency di slot pool milik
+// X (PoolSlot.listedBy), karena setiap kata utama maupun sinonim sudah punya
+// tepat satu string ter-intern. Jadi "siapa yang mencantumkan X" cukup satu
+// lookup lalu membaca arraynya, dan penelusuran beberapa langkah hanya
+// menyentuh kata yang memang terjangkau.
+//
+// Sisi balik baru dibangun saat query graf pertama, supaya load kamus tidak
+// ikut membayar. Setelah itu appendSynonym, removeSynonym dan removeWordEntry
+// menjaganya tetap sama dengan sisi maju. Semua perubahan dan query graf
+// berjalan dengan dictWriteBegin dipegang.
+
+// Kata yang sudah dikunjungi saat menelusuri graf, dengan jarak langkahnya
+typedef struct GraphVisit
+{
+    const char *word;
+    int hops;
+} GraphVisit;
+
+// Set pointer string (open addressing), ukurannya mengikuti jumlah kata yang dikunjungi
+typedef struct VisitedSet
+{
+    const char **slots;
+    size_t size;
+    size_t count;
+} VisitedSet;
+
+static int growVisited(VisitedSet *set)
+{
+    size_t size = set->size ? set->size * 2 : 64;
+    const char **slots = (const char **)calloc(size, sizeof(const char *));
+    if(!slots) return 0;
+
+    for(size_t i = 0; i < set->size; i++)
+    {
+        if(!set->slots[i]) continue;
+        size_t j = pointerHash(set->slots[i]) & (size - 1);
+        while(slots[j]) j = (j + 1) & (size - 1);
+        slots[j] = set->slots[i];
+    }
+    free(set->slots);
+    set->slots = slots;
+    set->size = size;
+    return 1;
+}
+
+// 1 jika word baru ditambahkan, 0 jika sudah ada, -1 jika gagal alokasi
+static int markVisited(VisitedSet *set, const char *word)
+{
+    if(set->count + 1 > set->size / 2 && !growVisited(set)) return -1;
+
+    size_t mask = set->size - 1;
+    size_t i = pointerHash(word) & mask;
+    for(; set->slots[i]; i = (i + 1) & mask)
+        if(set->slots[i] == word) return 0;
+    set->slots[i] = word;
+    set->count++;
+    return 1;
+}
+
+static int addBacklink(Dictionary *dict, const char *synonym, WordEntry *entry)
+{
+    // sinonim dari snapshot yang dilayani baru masuk pool saat dibutuhkan
+    PoolSlot *slot = internSlot(dict, synonym);
+    if(!slot && snapshotOwnsString(dict, synonym) && internAdopt(dict, synonym, hash(synonym)))
+        slot = internSlot(dict, synonym);
+    if(!slot) return 0;
+
+    Backlinks *links = slot->listedBy;
+    if(!links || links->count == links->cap)
+    {
+        uint32_t cap = links ? links->cap * 2 : GRAPH_BACKLINKS_INITIAL;
+        Backlinks *grown = (Backlinks *)realloc(links, sizeof(Backlinks) + cap * sizeof(WordEntry *));
+        if(!grown) return 0;
+        if(!links) grown->count = 0;
+        grown->cap = cap;
+        slot->listedBy = links = grown;
+    }
+    links->entries[links->count++] = entry;
+    return 1;
+}
+
+// Bangun sisi balik dari semua daftar sinonim; 0 jika kehabisan memori
+static int buildGraph(Dictionary *dict)
+{
+    HashTableIter it;
+    hashTableIterInit(&it);
+    WordEntry *entry;
+    while((entry = hashTableNext(dict, &it)))
+    {
+        SynonymIter syn;
+        synonymIterInit(entry, &syn);
+        for(const char *synonym; (synonym = synonymNext(&syn));)
+        {
+            if(!addBacklink(dict, synonym, entry))
+            {
+                fprintf(stderr, "Failed to allocate memory for synonym graph.\n");
+                graphReset(dict);
+                return 0;
+            }
+        }
+    }
+    dict->graphReady = 1;
+    return 1;
+}
+
+// Catat bahwa entry mencantumkan synonym (dipanggil appendSynonym)
+void graphLink(Dictionary *dict, WordEntry *entry, const char *synonym)
+{
+    if(!dict->graphReady) return;
+
+    // tanpa memori untuk sisi balik: buang grafnya, dibangun ulang saat query berikutnya
+    if(!addBacklink(dict, synonym, entry)) graphReset(dict);
+}
+
+// Hapus sisi balik entry -> synonym
+void graphUnlink(Dictionary *dict, WordEntry *entry, const char *synonym)
+{
+    if(!dict->graphReady) return;
+
+    PoolSlot *slot = internSlot(dict, synonym);
+    Backlinks *links = slot ? slot->listedBy : NULL;
+    if(!links) return;
+
+    for(uint32_t i = 0; i < links->count; i++)
+    {
+        if(links->entries[i] != entry) continue;
+        memmove(&links->entries[i], &links->entries[i + 1], (links->count - i - 1) * sizeof(WordEntry *));
+        if(--links->count == 0)
+        {
+            free(links);
+            slot->listedBy = NULL;
+        }
+        return;
+    }
+}
+
+// Lepas semua sisi balik; graf dibangun ulang saat dibutuhkan lagi
+void graphReset(Dictionary *dict)
+{
+    StringPool *pool = &dict->strings;
+    for(size_t i = 0; i < pool->size; i++)
+    {
+        free(pool->slots[i].listedBy);
+        pool->slots[i].listedBy = NULL;
+    }
+    dict->graphReady = 0;
+}
+
+// Byte heap semua array sisi balik; dipanggil dengan dictWriteBegin dipegang
+size_t graphBytes(Dictionary *dict)
+{
+    StringPool *pool = &dict->strings;
+    size_t bytes = 0;
+    for(size_t i = 0; i < pool->size; i++)
+    {
+        Backlinks *links = pool->slots[i].listedBy;
+        if(links) bytes += sizeof(Backlinks) + links->cap * sizeof(WordEntry *);
+    }
+    return bytes;
+}
+
+// Panggil visit untuk setiap kata utama yang mencantumkan word sebagai
+// sinonim. Berhenti jika visit mengembalikan 0.
+// Mengembalikan jumlah kata yang dikunjungi.
+size_t synonymListedBy(Dictionary *dict, const char *word,
+                       int (*visit)(const char *word, void *ctx), void *ctx)
+{
+    size_t visited = 0;
+    dictWriteBegin(dict);
+    if(dict->graphReady || buildGraph(dict))
+    {
+        PoolSlot *slot = internSlot(dict, internFind(dict, word));
+        Backlinks *links = slot ? slot->listedBy : NULL;
+        for(uint32_t i = 0; links && i < links->count; i++)
+        {
+            visited++;
+            if(!visit(links->entries[i]->word, ctx)) break;
+        }
+    }
+    dictWriteEnd(dict);
+    return visited;
+}
+
+static int pushVisit(GraphVisit **queue, size_t *count, size_t *cap, VisitedSet *seen,
+                     const char *word, int hops)
+{
+    int added = markVisited(seen, word);
+    if(added <= 0) return added == 0;
+
+    if(*count == *cap)
+    {
+        size_t newCap = *cap ? *cap * 2 : 64;
+        GraphVisit *grown = (GraphVisit *)realloc(*queue, newCap * sizeof(GraphVisit));
+        if(!grown) return 0;
+        *queue = grown;
+        *cap = newCap;
+    }
+    (*queue)[*count].word = word;
+    (*queue)[*count].hops = hops;
+    (*count)++;
+    return 1;
+}
+
+// Telusuri graf dari word ke dua arah (sinonimnya dan kata yang
+// mencantumkannya) sampai maxHops langkah, melebar per langkah. visit
+// dipanggil sekali untuk setiap kata yang terjangkau, dengan jarak
+// terpendeknya; berhenti jika visit mengembalikan 0. Mengembalikan jumlah
+// kata yang dikunjungi.
+size_t relatedWords(Dictionary *dict, const char *word, int maxHops,
+                    int (*visit)(const char *word, int hops, void *ctx), void *ctx)
+{
+    GraphVisit *queue = NULL;
+    size_t count = 0, cap = 0, visited = 0;
+    VisitedSet seen = {NULL, 0, 0};
+
+    dictWriteBegin(dict);
+    const char *start = internFind(dict, word);
+    int ok = start && (dict->graphReady || buildGraph(dict)) &&
+             pushVisit(&queue, &count, &cap, &seen, start, 0);
+
+    for(size_t head = 0; ok && head < count; head++)
+    {
+        GraphVisit current = queue[head];
+        if(head > 0)
+        {
+            visited++;
+            if(!visit(current.word, current.hops, ctx)) break;
+        }
+        if(current.hops >= maxHops) continue;
+
+        WordEntry *entry = findWord(dict, current.word);
+        if(entry)
+        {
+            SynonymIter syn;
+            synonymIterInit(entry, &syn);
+            for(const char *synonym; ok && (synonym = synonymNext(&syn));)
+                ok = pushVisit(&queue, &count, &cap, &seen, synonym, current.hops + 1);
+        }
+
+        PoolSlot *slot = internSlot(dict, current.word);
+        Backlinks *links = slot ? slot->listedBy : NULL;
+        for(uint32_t i = 0; ok && links && i < links->count; i++)
+            ok = pushVisit(&queue, &count, &cap, &seen, links->entries[i]->word, current.hops + 1);
+    }
+    dictWriteEnd(dict);
+
+    if(!ok && start) fprintf(stderr, "Failed to allocate memory for related words.\n");
+    free(queue);
+    free(seen.slots);
+    return visited;
+}
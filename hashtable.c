@@ -0,0 +1,715 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dictionary_private.h"
+
+// Ukuran tabel selalu pangkat dua supaya index cukup pakai mask
+static size_t roundUpPowerOfTwo(size_t n)
+{
+    size_t size = HASH_INITIAL_SIZE;
+    while(size < n) size <<= 1;
+    return size;
+}
+
+// Penulis (yang memegang dictWriteBegin) menaikkan seq menjadi ganjil
+// selama mengubah tabel. Pembaca tidak mengambil lock: mereka membaca seq
+// sebelum dan sesudah lookup dan mengulang jika ada penulis di tengahnya.
+// Memori yang dilepas penulis dipensiunkan lewat retireNode, jadi pembaca
+// yang terlambat tidak pernah menyentuh memori yang sudah dipakai ulang.
+static void seqBegin(HashTable *table)
+{
+    __atomic_store_n(&table->seq, table->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void seqEnd(HashTable *table)
+{
+    __atomic_store_n(&table->seq, table->seq + 1, __ATOMIC_RELEASE);
+}
+
+static unsigned long seqRead(HashTable *table)
+{
+    return __atomic_load_n(&table->seq, __ATOMIC_ACQUIRE);
+}
+
+// 1 jika ada penulis yang berjalan sejak seqRead mengembalikan seq
+static int seqChanged(HashTable *table, unsigned long seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return (seq & 1) || __atomic_load_n(&table->seq, __ATOMIC_RELAXED) != seq;
+}
+
+#ifndef WORD_INDEX_OPEN
+
+static BucketArray *allocBuckets(size_t size)
+{
+    BucketArray *buckets = (BucketArray *)calloc(1, sizeof(BucketArray) + size * sizeof(WordEntry *));
+    if(buckets) buckets->size = size;
+    return buckets;
+}
+
+int initHashTable(HashTable *table, size_t size)
+{
+    table->buckets = allocBuckets(roundUpPowerOfTwo(size));
+    if(!table->buckets)
+    {
+        fprintf(stderr, "Failed to allocate memory for hash table.\n");
+        return 0;
+    }
+
+    table->count = 0;
+    table->oldBuckets = NULL;
+    table->rehashIndex = 0;
+    return 1;
+}
+
+// Pindahkan beberapa bucket dari tabel lama ke tabel baru
+static void rehashStep(Dictionary *dict, size_t steps)
+{
+    HashTable *table = &dict->index;
+    BucketArray *buckets = table->buckets, *old = table->oldBuckets;
+    while(old && steps--)
+    {
+        WordEntry *entry = old->head[table->rehashIndex];
+        while(entry)
+        {
+            WordEntry *next = entry->next;
+            size_t index = hash(entry->word) & (buckets->size - 1);
+            entry->next = buckets->head[index];
+            STORE_RELEASE(&buckets->head[index], entry);
+            STATS_COUNT(STATS_REHASH_MOVES, 1);
+            entry = next;
+        }
+        STORE_RELEASE(&old->head[table->rehashIndex], NULL);
+
+        if(++table->rehashIndex == old->size)
+        {
+            // pembaca yang masih memegang pointer lama membaca array kosong
+            // sampai epoch-nya selesai
+            STORE_RELEASE(&table->oldBuckets, NULL);
+            retireNode(dict, NULL, old);
+            table->rehashIndex = 0;
+            old = NULL;
+        }
+    }
+}
+
+// Mulai rehash bertahap ke tabel berukuran newSize
+static int growHashTable(Dictionary *dict, size_t newSize)
+{
+    HashTable *table = &dict->index;
+    // selesaikan rehash sebelumnya dulu (jarang terjadi)
+    if(table->oldBuckets) rehashStep(dict, table->oldBuckets->size);
+
+    BucketArray *buckets = allocBuckets(newSize);
+    if(!buckets) return 0;
+
+    // tabel lama diumumkan dulu: pembaca yang melihat tabel baru pasti juga
+    // melihat tabel lama yang masih berisi semua entry
+    table->rehashIndex = 0;
+    STORE_RELEASE(&table->oldBuckets, table->buckets);
+    STORE_RELEASE(&table->buckets, buckets);
+    return 1;
+}
+
+void hashTableReserve(Dictionary *dict, size_t count)
+{
+    HashTable *table = &dict->index;
+    if(!table->buckets && !initHashTable(table, HASH_INITIAL_SIZE)) return;
+
+    size_t size = roundUpPowerOfTwo((size_t)(count / HASH_MAX_LOAD_FACTOR) + 1);
+    if(size <= table->buckets->size) return;
+    seqBegin(table);
+    growHashTable(dict, size);
+    seqEnd(table);
+}
+
+// Ambil pointer ke slot 'next' yang menunjuk entry dengan kata ini
+static WordEntry **findSlot(HashTable *table, const char *word, unsigned int h)
+{
+    WordEntry **slot = &table->buckets->head[h & (table->buckets->size - 1)];
+    for(; *slot; slot = &(*slot)->next)
+        if(strcmp((*slot)->word, word) == 0) return slot;
+
+    BucketArray *old = table->oldBuckets;
+    if(old)
+    {
+        size_t index = h & (old->size - 1);
+        if(index >= table->rehashIndex)
+        {
+            slot = &old->head[index];
+            for(; *slot; slot = &(*slot)->next)
+                if(strcmp((*slot)->word, word) == 0) return slot;
+        }
+    }
+    return NULL;
+}
+
+static WordEntry *findInChain(WordEntry *entry, const char *word)
+{
+    size_t steps = 0;
+    for(; entry; entry = LOAD_ACQUIRE(&entry->next))
+    {
+        steps++;
+        if(strcmp(entry->word, word) == 0) break;
+    }
+    STATS_WALK(steps);
+    return entry;
+}
+
+// Lookup tanpa lock, aman dipanggil pembaca di dalam dictReadBegin/End.
+// Entry yang ditemukan selalu benar; hanya "tidak ada" yang perlu dicek
+// ulang, karena rehash yang berjalan bisa memindahkan entry dari jalurnya.
+static WordEntry *tableFindHashed(Dictionary *dict, const char *word, unsigned int h)
+{
+    HashTable *table = &dict->index;
+    for(;;)
+    {
+        unsigned long seq = seqRead(table);
+        BucketArray *buckets = LOAD_ACQUIRE(&table->buckets);
+        if(!buckets) return NULL;
+
+        WordEntry *entry = findInChain(LOAD_ACQUIRE(&buckets->head[h & (buckets->size - 1)]), word);
+        if(entry) return entry;
+
+        BucketArray *old = LOAD_ACQUIRE(&table->oldBuckets);
+        if(old)
+        {
+            entry = findInChain(LOAD_ACQUIRE(&old->head[h & (old->size - 1)]), word);
+            if(entry) return entry;
+        }
+
+        if(!seqChanged(table, seq)) return NULL;
+        STATS_COUNT(STATS_FIND_RETRIES, 1);
+    }
+}
+
+// Satu kelompok (<= LOOKUP_BATCH) dari hashTableFindBatch. Setiap tahap
+// dijalankan untuk semua kata sebelum tahap berikutnya, jadi cache miss
+// bucket, entry, dan string kata dari kata-kata yang berbeda saling tumpang
+// tindih, bukan menunggu satu per satu.
+static void findGroup(Dictionary *dict, const char *const *words, size_t count, WordEntry **out)
+{
+    HashTable *table = &dict->index;
+    unsigned int h[LOOKUP_BATCH];
+    WordEntry *head[LOOKUP_BATCH];
+
+    unsigned long seq = seqRead(table);
+    BucketArray *buckets = LOAD_ACQUIRE(&table->buckets);
+    if(!buckets)
+    {
+        memset(out, 0, count * sizeof(WordEntry *));
+        return;
+    }
+
+    size_t mask = buckets->size - 1;
+    for(size_t i = 0; i < count; i++)
+    {
+        h[i] = hash(words[i]);
+        __builtin_prefetch(&buckets->head[h[i] & mask]);
+    }
+    for(size_t i = 0; i < count; i++)
+    {
+        head[i] = LOAD_ACQUIRE(&buckets->head[h[i] & mask]);
+        if(head[i]) __builtin_prefetch(head[i]);
+    }
+    for(size_t i = 0; i < count; i++)
+        if(head[i]) __builtin_prefetch(head[i]->word);
+
+    for(size_t i = 0; i < count; i++)
+        out[i] = findInChain(head[i], words[i]);
+
+    // "tidak ada" hanya pasti jika tidak ada rehash yang sedang berjalan dan
+    // seq tidak berubah; selain itu cek ulang lewat jalur biasa
+    int recheck = LOAD_ACQUIRE(&table->oldBuckets) || seqChanged(table, seq);
+    for(size_t i = 0; i < count; i++)
+        if(!out[i] && recheck) out[i] = tableFindHashed(dict, words[i], h[i]);
+}
+
+int hashTableInsert(Dictionary *dict, WordEntry *entry)
+{
+    return hashTableInsertHashed(dict, entry, hash(entry->word));
+}
+
+int hashTableInsertHashed(Dictionary *dict, WordEntry *entry, unsigned int h)
+{
+    HashTable *table = &dict->index;
+    if(!table->buckets && !initHashTable(table, HASH_INITIAL_SIZE)) return 0;
+
+    seqBegin(table);
+    rehashStep(dict, HASH_REHASH_STEP);
+    if(table->count + 1 > table->buckets->size * HASH_MAX_LOAD_FACTOR)
+        growHashTable(dict, table->buckets->size << 1);
+
+    // entry baru selalu masuk ke tabel baru, diumumkan setelah next terisi
+    BucketArray *buckets = table->buckets;
+    size_t index = h & (buckets->size - 1);
+    entry->next = buckets->head[index];
+    STORE_RELEASE(&buckets->head[index], entry);
+    table->count++;
+    seqEnd(table);
+    return 1;
+}
+
+static WordEntry *tableRemove(Dictionary *dict, const char *word)
+{
+    HashTable *table = &dict->index;
+    if(!table->buckets) return NULL;
+
+    seqBegin(table);
+    rehashStep(dict, HASH_REHASH_STEP);
+
+    WordEntry **slot = findSlot(table, word, hash(word));
+    WordEntry *entry = slot ? *slot : NULL;
+    if(entry)
+    {
+        // next dibiarkan: pembaca yang sedang berada di entry ini masih
+        // bisa lanjut ke entry berikutnya
+        STORE_RELEASE(slot, entry->next);
+        table->count--;
+    }
+    seqEnd(table);
+    return entry;
+}
+
+// Kembalikan entry berikutnya; entry yang dikembalikan boleh langsung di-free
+static WordEntry *tableNext(Dictionary *dict, HashTableIter *it)
+{
+    HashTable *table = &dict->index;
+    while(!it->next)
+    {
+        BucketArray *buckets = it->inOld ? table->oldBuckets : table->buckets;
+        if(!buckets || it->index >= buckets->size)
+        {
+            if(it->inOld) return NULL;
+            it->inOld = 1;
+            it->index = table->rehashIndex;
+            continue;
+        }
+        it->next = buckets->head[it->index++];
+    }
+
+    WordEntry *entry = it->next;
+    it->next = entry->next;
+    return entry;
+}
+
+// Panjang rantai tiap bucket, termasuk bucket lama yang belum dipindah
+void hashTableStats(Dictionary *dict, IndexStats *stats)
+{
+    HashTable *table = &dict->index;
+    memset(stats, 0, sizeof(*stats));
+    stats->entries = table->count;
+    for(int old = 0; old < 2; old++)
+    {
+        BucketArray *buckets = old ? table->oldBuckets : table->buckets;
+        if(!buckets) continue;
+        stats->bytes += sizeof(BucketArray) + buckets->size * sizeof(WordEntry *);
+        for(size_t i = old ? table->rehashIndex : 0; i < buckets->size; i++)
+        {
+            size_t length = 0;
+            for(WordEntry *entry = buckets->head[i]; entry; entry = entry->next) length++;
+            stats->slots++;
+            stats->used += length > 0;
+            stats->total += length;
+            if(length > stats->longest) stats->longest = length;
+            stats->histogram[length < STATS_CHAIN_HISTOGRAM ? length : STATS_CHAIN_HISTOGRAM]++;
+        }
+    }
+}
+
+void freeHashTable(Dictionary *dict)
+{
+    HashTable *table = &dict->index;
+    free(table->buckets);
+    free(table->oldBuckets);
+    table->buckets = NULL;
+    table->oldBuckets = NULL;
+    table->count = 0;
+    table->rehashIndex = 0;
+}
+
+#else /* WORD_INDEX_OPEN */
+
+// Backend open addressing: satu byte kontrol per slot (7 bit hash atau
+// EMPTY/DELETED) dan slot yang menyimpan hash 32-bit serta salinan kata
+// pendek, jadi kebanyakan lookup tidak perlu menyentuh WordEntry sama sekali.
+
+#define CTRL_EMPTY   0x80
+#define CTRL_DELETED 0xFE
+#define CTRL_TAG(h)  ((unsigned char)((h) >> 25))
+
+// Posisi slot dan tag diambil dari mixHash(h); slot tetap menyimpan h asli.
+
+static SlotArray *allocSlots(size_t size)
+{
+    SlotArray *slots = (SlotArray *)malloc(sizeof(SlotArray) + size * (sizeof(IndexSlot) + 1));
+    if(!slots) return NULL;
+    slots->size = size;
+    slots->ctrl = (unsigned char *)(slots->slot + size);
+    memset(slots->ctrl, CTRL_EMPTY, size);
+    return slots;
+}
+
+int initHashTable(HashTable *table, size_t size)
+{
+    table->slots = allocSlots(roundUpPowerOfTwo(size));
+    if(!table->slots)
+    {
+        fprintf(stderr, "Failed to allocate memory for hash table.\n");
+        return 0;
+    }
+
+    table->count = 0;
+    table->tombstones = 0;
+    table->oldSlots = NULL;
+    table->rehashIndex = 0;
+    return 1;
+}
+
+// Cocokkan kata dengan slot; kata pendek selesai di dalam slot
+static int slotMatches(const IndexSlot *slot, unsigned int h, const char *word, size_t len)
+{
+    if(slot->hash != h) return 0;
+    if(len < INDEX_INLINE_KEY) return memcmp(slot->key, word, len + 1) == 0;
+    if(memcmp(slot->key, word, INDEX_INLINE_KEY) != 0) return 0;
+    return strcmp(slot->entry->word + INDEX_INLINE_KEY, word + INDEX_INLINE_KEY) == 0;
+}
+
+static void fillSlot(IndexSlot *slot, WordEntry *entry, unsigned int h)
+{
+    // sisa key diisi nol, sama seperti strncpy
+    size_t len = strnlen(entry->word, INDEX_INLINE_KEY);
+    slot->hash = h;
+    memcpy(slot->key, entry->word, len);
+    memset(slot->key + len, 0, INDEX_INLINE_KEY - len);
+    slot->entry = entry;
+}
+
+// Cari posisi kata di satu tabel, -1 jika tidak ada
+static long probe(const SlotArray *slots, unsigned int h, const char *word, size_t len)
+{
+    size_t mask = slots->size - 1;
+    unsigned int mixed = mixHash(h);
+    unsigned char tag = CTRL_TAG(mixed);
+    for(size_t i = mixed & mask, steps = 1;; i = (i + 1) & mask, steps++)
+    {
+        unsigned char c = LOAD_ACQUIRE(&slots->ctrl[i]);
+        if(c == CTRL_EMPTY || (c == tag && slotMatches(&slots->slot[i], h, word, len)))
+        {
+            STATS_WALK(steps);
+            return c == CTRL_EMPTY ? -1 : (long)i;
+        }
+    }
+}
+
+// Taruh entry di slot kosong/terhapus pertama pada tabel baru
+static void placeEntry(HashTable *table, WordEntry *entry, unsigned int h)
+{
+    SlotArray *slots = table->slots;
+    size_t mask = slots->size - 1;
+    unsigned int mixed = mixHash(h);
+    size_t i = mixed & mask;
+    while(slots->ctrl[i] != CTRL_EMPTY && slots->ctrl[i] != CTRL_DELETED)
+        i = (i + 1) & mask;
+
+    // slot diisi dulu, baru byte kontrol yang membuatnya terlihat
+    if(slots->ctrl[i] == CTRL_DELETED) table->tombstones--;
+    fillSlot(&slots->slot[i], entry, h);
+    STORE_RELEASE(&slots->ctrl[i], CTRL_TAG(mixed));
+}
+
+// Pindahkan beberapa slot dari tabel lama ke tabel baru
+static void rehashStep(Dictionary *dict, size_t steps)
+{
+    HashTable *table = &dict->index;
+    SlotArray *old = table->oldSlots;
+    while(old && steps--)
+    {
+        size_t i = table->rehashIndex;
+        unsigned char c = old->ctrl[i];
+        if(c != CTRL_EMPTY && c != CTRL_DELETED)
+        {
+            // tandai DELETED, bukan EMPTY, supaya rantai probe di tabel lama tetap utuh
+            placeEntry(table, old->slot[i].entry, old->slot[i].hash);
+            STORE_RELEASE(&old->ctrl[i], CTRL_DELETED);
+            STATS_COUNT(STATS_REHASH_MOVES, 1);
+        }
+
+        if(++table->rehashIndex == old->size)
+        {
+            STORE_RELEASE(&table->oldSlots, NULL);
+            retireNode(dict, NULL, old);
+            table->rehashIndex = 0;
+            old = NULL;
+        }
+    }
+}
+
+static int growHashTable(Dictionary *dict, size_t newSize)
+{
+    HashTable *table = &dict->index;
+    if(table->oldSlots) rehashStep(dict, table->oldSlots->size);
+
+    SlotArray *slots = allocSlots(newSize);
+    if(!slots) return 0;
+
+    // tabel lama diumumkan dulu, sama seperti backend berantai
+    table->rehashIndex = 0;
+    STORE_RELEASE(&table->oldSlots, table->slots);
+    STORE_RELEASE(&table->slots, slots);
+    table->tombstones = 0;
+    return 1;
+}
+
+void hashTableReserve(Dictionary *dict, size_t count)
+{
+    HashTable *table = &dict->index;
+    if(!table->slots && !initHashTable(table, HASH_INITIAL_SIZE)) return;
+
+    size_t size = roundUpPowerOfTwo((size_t)(count / INDEX_MAX_LOAD_FACTOR) + 1);
+    if(size <= table->slots->size) return;
+    seqBegin(table);
+    growHashTable(dict, size);
+    seqEnd(table);
+}
+
+static WordEntry *findEntry(HashTable *table, unsigned int h, const char *word, size_t len)
+{
+    SlotArray *slots = LOAD_ACQUIRE(&table->slots);
+    if(!slots) return NULL;
+
+    long i = probe(slots, h, word, len);
+    if(i >= 0) return slots->slot[i].entry;
+
+    SlotArray *old = LOAD_ACQUIRE(&table->oldSlots);
+    if(old)
+    {
+        i = probe(old, h, word, len);
+        if(i >= 0) return old->slot[i].entry;
+    }
+    return NULL;
+}
+
+// Lookup tanpa lock. Slot bisa diisi ulang oleh penulis saat sedang
+// dibaca, jadi hasil (ketemu maupun tidak) hanya dipakai jika seq tidak
+// berubah selama lookup.
+static WordEntry *tableFindHashed(Dictionary *dict, const char *word, unsigned int h)
+{
+    HashTable *table = &dict->index;
+    size_t len = strlen(word);
+    for(;;)
+    {
+        unsigned long seq = seqRead(table);
+        WordEntry *entry = findEntry(table, h, word, len);
+        if(!seqChanged(table, seq)) return entry;
+        STATS_COUNT(STATS_FIND_RETRIES, 1);
+    }
+}
+
+// Satu kelompok (<= LOOKUP_BATCH) dari hashTableFindBatch. Hash semua kata
+// dihitung dulu dan slot awalnya di-prefetch, baru probe dijalankan, jadi
+// cache miss dari kata-kata yang berbeda saling tumpang tindih.
+static void findGroup(Dictionary *dict, const char *const *words, size_t count, WordEntry **out)
+{
+    HashTable *table = &dict->index;
+    unsigned int h[LOOKUP_BATCH];
+    size_t len[LOOKUP_BATCH];
+
+    unsigned long seq = seqRead(table);
+    SlotArray *slots = LOAD_ACQUIRE(&table->slots);
+    if(!slots)
+    {
+        memset(out, 0, count * sizeof(WordEntry *));
+        return;
+    }
+
+    size_t mask = slots->size - 1;
+    for(size_t i = 0; i < count; i++)
+    {
+        h[i] = hash(words[i]);
+        len[i] = strlen(words[i]);
+        __builtin_prefetch(&slots->ctrl[mixHash(h[i]) & mask]);
+        __builtin_prefetch(&slots->slot[mixHash(h[i]) & mask]);
+    }
+    for(size_t i = 0; i < count; i++)
+        out[i] = findEntry(table, h[i], words[i], len[i]);
+
+    // sama seperti tableFindHashed: hasil hanya dipakai jika seq tidak berubah
+    if(!seqChanged(table, seq)) return;
+    for(size_t i = 0; i < count; i++)
+        out[i] = tableFindHashed(dict, words[i], h[i]);
+}
+
+int hashTableInsert(Dictionary *dict, WordEntry *entry)
+{
+    return hashTableInsertHashed(dict, entry, hash(entry->word));
+}
+
+int hashTableInsertHashed(Dictionary *dict, WordEntry *entry, unsigned int h)
+{
+    HashTable *table = &dict->index;
+    if(!table->slots && !initHashTable(table, HASH_INITIAL_SIZE)) return 0;
+
+    int ok = 1;
+    seqBegin(table);
+    rehashStep(dict, HASH_REHASH_STEP);
+    size_t size = table->slots->size;
+    if(table->count + table->tombstones + 1 > size * INDEX_MAX_LOAD_FACTOR)
+    {
+        // kalau yang penuh kebanyakan tombstone, cukup bangun ulang dengan ukuran sama
+        size_t newSize = table->count + 1 > size * INDEX_MAX_LOAD_FACTOR / 2 ? size << 1 : size;
+        ok = growHashTable(dict, newSize);
+    }
+
+    if(ok)
+    {
+        placeEntry(table, entry, h);
+        table->count++;
+    }
+    seqEnd(table);
+    return ok;
+}
+
+static WordEntry *tableRemove(Dictionary *dict, const char *word)
+{
+    HashTable *table = &dict->index;
+    if(!table->slots) return NULL;
+
+    seqBegin(table);
+    rehashStep(dict, HASH_REHASH_STEP);
+    unsigned int h = hash(word);
+    size_t len = strlen(word);
+    WordEntry *entry = NULL;
+    SlotArray *slots = table->slots, *old = table->oldSlots;
+    long i = probe(slots, h, word, len);
+    if(i >= 0)
+    {
+        STORE_RELEASE(&slots->ctrl[i], CTRL_DELETED);
+        table->tombstones++;
+        table->count--;
+        entry = slots->slot[i].entry;
+    }
+    else if(old)
+    {
+        i = probe(old, h, word, len);
+        if(i >= 0)
+        {
+            STORE_RELEASE(&old->ctrl[i], CTRL_DELETED);
+            table->count--;
+            entry = old->slot[i].entry;
+        }
+    }
+    seqEnd(table);
+    return entry;
+}
+
+static WordEntry *tableNext(Dictionary *dict, HashTableIter *it)
+{
+    HashTable *table = &dict->index;
+    for(;;)
+    {
+        SlotArray *slots = it->inOld ? table->oldSlots : table->slots;
+        if(!slots || it->index >= slots->size)
+        {
+            if(it->inOld) return NULL;
+            it->inOld = 1;
+            it->index = table->rehashIndex;
+            continue;
+        }
+
+        size_t i = it->index++;
+        if(slots->ctrl[i] != CTRL_EMPTY && slots->ctrl[i] != CTRL_DELETED) return slots->slot[i].entry;
+    }
+}
+
+// Jarak tiap slot terisi dari posisi awal hash-nya, termasuk tabel lama
+void hashTableStats(Dictionary *dict, IndexStats *stats)
+{
+    HashTable *table = &dict->index;
+    memset(stats, 0, sizeof(*stats));
+    stats->entries = table->count;
+    stats->tombstones = table->tombstones;
+    for(int old = 0; old < 2; old++)
+    {
+        SlotArray *slots = old ? table->oldSlots : table->slots;
+        if(!slots) continue;
+        size_t size = slots->size;
+        stats->bytes += sizeof(SlotArray) + size * (1 + sizeof(IndexSlot));
+        stats->slots += size;
+        for(size_t i = old ? table->rehashIndex : 0; i < size; i++)
+        {
+            if(slots->ctrl[i] == CTRL_EMPTY || slots->ctrl[i] == CTRL_DELETED) continue;
+            size_t distance = (i - (mixHash(slots->slot[i].hash) & (size - 1))) & (size - 1);
+            stats->used++;
+            stats->total += distance;
+            if(distance > stats->longest) stats->longest = distance;
+            stats->histogram[distance < STATS_CHAIN_HISTOGRAM ? distance : STATS_CHAIN_HISTOGRAM]++;
+        }
+    }
+}
+
+void freeHashTable(Dictionary *dict)
+{
+    HashTable *table = &dict->index;
+    free(table->slots);
+    free(table->oldSlots);
+    table->slots = NULL;
+    table->oldSlots = NULL;
+    table->count = 0;
+    table->tombstones = 0;
+    table->rehashIndex = 0;
+}
+
+#endif /* WORD_INDEX_OPEN */
+
+// Index kata = tabel di atas ditambah kata yang masih dilayani dari
+// snapshot (lihat snapshot.c). Kata baru selalu masuk tabel; kata snapshot
+// hanya dicari, dihapus, dan ikut dijalani iterator. table->count hanya
+// menghitung isi tabel (lihat dictionaryWordCount).
+
+WordEntry *hashTableFind(Dictionary *dict, const char *word)
+{
+    return hashTableFindHashed(dict, word, hash(word));
+}
+
+WordEntry *hashTableFindHashed(Dictionary *dict, const char *word, unsigned int h)
+{
+    WordEntry *entry = tableFindHashed(dict, word, h);
+    return entry ? entry : snapshotFindWord(dict, word, h);
+}
+
+// Lookup count kata sekaligus; out[i] = entry untuk words[i] atau NULL.
+// Aturan pemanggilnya sama dengan hashTableFind.
+void hashTableFindBatch(Dictionary *dict, const char *const *words, size_t count, WordEntry **out)
+{
+    for(size_t i = 0; i < count; i += LOOKUP_BATCH)
+    {
+        size_t n = count - i < LOOKUP_BATCH ? count - i : LOOKUP_BATCH;
+        findGroup(dict, words + i, n, out + i);
+    }
+    if(!dict->mapped.words) return;
+    for(size_t i = 0; i < count; i++)
+        if(!out[i]) out[i] = snapshotFindWord(dict, words[i], hash(words[i]));
+}
+
+WordEntry *hashTableRemove(Dictionary *dict, const char *word)
+{
+    WordEntry *entry = tableRemove(dict, word);
+    return entry ? entry : snapshotRemoveWord(dict, word, hash(word));
+}
+
+void hashTableIterInit(HashTableIter *it)
+{
+    it->inOld = 0;
+    it->index = 0;
+    it->next = NULL;
+    it->mapped = 0;
+}
+
+// Isi tabel dulu, lalu kata snapshot yang masih ada
+WordEntry *hashTableNext(Dictionary *dict, HashTableIter *it)
+{
+    WordEntry *entry = tableNext(dict, it);
+    return entry ? entry : snapshotNextWord(dict, &it->mapped, NULL);
+}
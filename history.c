@@ -2,151 +2,641 @@
 #include <time.h>
 #include <stdlib.h>
 #include <string.h>
-#include "dictionary.h"
+#include "dictionary_private.h"
 
-HistoryNode *historyTop = NULL;
+// Riwayat disimpan di ring buffer berkapasitas tetap (HISTORY_CAPACITY atau
+// SYNONYM_HISTORY_LIMIT); record tertua dibuang saat penuh, dan jika
+// SYNONYM_HISTORY_DAYS diisi, record yang lebih tua dari sekian hari juga
+// dibuang. Waktu disimpan sebagai detik (time_t) dan kata sebagai pointer ke
+// string riwayat sendiri, jadi satu record tidak butuh malloc. Teks aksi baru
+// dibuat saat dicetak atau disimpan.
+//
+// Setiap record punya nomor urut (seq) yang terus naik. Waktu record tidak
+// pernah turun, jadi "aksi antara T1 dan T2" dicari dengan binary search.
+// Setiap record juga menyimpan seq record sebelumnya yang menyentuh kata
+// yang sama, dan tabel kata menyimpan seq terbarunya, jadi "aksi pada kata W"
+// hanya menelusuri record milik W. Rantai berhenti di record yang sudah
+// dibuang, jadi membuang record tidak perlu menyentuh index.
+//
+// history.txt dan log tetap memakai baris teks "waktu,aksi" seperti dulu,
+// dari yang tertua. File yang ditulis pemadatan log diawali baris generasi
+// log yang sudah masuk; baris itu tidak punya waktu, jadi versi lama
+// melewatinya.
 
-void getCurrentTimestamp(char *buffer, size_t size) 
+static const char historyGenerationLine[] = "# generation ";
+
+typedef struct HistoryWord
+{
+    const char *word;       // di arena riwayat, NULL = slot kosong
+    uint64_t latest;        // seq record terbaru yang menyentuh kata ini
+} HistoryWord;
+
+typedef struct HistoryLog
 {
-    time_t now = time(NULL);
-    struct tm *t = localtime(&now);
-    strftime(buffer, size, "%Y-%m-%d %H:%M:%S", t);
+    HistoryRecord *records; // ring; seq s ada di records[(s - 1) % allocated]
+    size_t allocated;       // tumbuh sampai capacity, setelah itu tetap
+    size_t capacity;
+    uint64_t first, next;   // seq tertua yang masih ada, seq berikutnya
+    int64_t maxAge;         // detik, 0 = tidak dibuang karena umur
+    HistoryWord *words;     // open addressing, ukuran pangkat dua
+    size_t wordCap, wordCount;
+    Arena strings;
+    int64_t textTime;       // detik yang teksnya ada di timeText
+    char timeText[32];
+#ifndef _WIN32
+    pthread_mutex_t lock;
+#endif
+} HistoryLog;
+
+#ifndef _WIN32
+#define HISTORY_LOCK(log) pthread_mutex_lock(&(log)->lock)
+#define HISTORY_UNLOCK(log) pthread_mutex_unlock(&(log)->lock)
+#else
+#define HISTORY_LOCK(log)
+#define HISTORY_UNLOCK(log)
+#endif
+
+static size_t envSize(const char *name, size_t fallback)
+{
+    const char *env = getenv(name);
+    if(!env || !*env) return fallback;
+    long value = atol(env);
+    return value > 0 ? (size_t)value : fallback;
 }
 
-HistoryNode *createHistoryNode(const char *action)
+int historyInit(Dictionary *dict)
 {
-    HistoryNode *newNode = (HistoryNode *)malloc(sizeof(HistoryNode));
-    if(!newNode) return NULL;
+    HistoryLog *log = (HistoryLog *)calloc(1, sizeof(HistoryLog));
+    if(!log) return 0;
 
-    newNode->action = strdup(action);
-    if(!newNode->action) {
-        free(newNode);
-        return NULL;
+    log->capacity = envSize("SYNONYM_HISTORY_LIMIT", HISTORY_CAPACITY);
+    log->maxAge = (int64_t)envSize("SYNONYM_HISTORY_DAYS", 0) * 24 * 60 * 60;
+    log->first = log->next = 1;
+    log->textTime = -1;
+#ifndef _WIN32
+    pthread_mutex_init(&log->lock, NULL);
+#endif
+    dict->history = log;
+    return 1;
+}
+
+static HistoryRecord *recordAt(HistoryLog *log, uint64_t seq)
+{
+    return &log->records[(seq - 1) % log->allocated];
+}
+
+static HistoryWord *findHistoryWord(HistoryLog *log, const char *word)
+{
+    if(!log->wordCap) return NULL;
+    for(size_t i = mixHash(hash(word)) & (log->wordCap - 1);; i = (i + 1) & (log->wordCap - 1))
+    {
+        HistoryWord *slot = &log->words[i];
+        if(!slot->word || strcmp(slot->word, word) == 0) return slot;
     }
+}
 
-    char timeBuffer[30];
-    getCurrentTimestamp(timeBuffer, sizeof(timeBuffer));
+static int growWords(HistoryLog *log, size_t size)
+{
+    HistoryWord *words = (HistoryWord *)calloc(size, sizeof(HistoryWord));
+    if(!words) return 0;
 
-    newNode->time = strdup(timeBuffer);
-    if(!newNode->time)
+    for(size_t i = 0; i < log->wordCap; i++)
     {
-        free(newNode->action);
-        free(newNode);
+        if(!log->words[i].word) continue;
+        size_t j = mixHash(hash(log->words[i].word)) & (size - 1);
+        while(words[j].word) j = (j + 1) & (size - 1);
+        words[j] = log->words[i];
+    }
+    free(log->words);
+    log->words = words;
+    log->wordCap = size;
+    return 1;
+}
+
+// Slot kata di tabel, dibuat (beserta salinan string-nya) jika belum ada
+static HistoryWord *internHistoryWord(HistoryLog *log, const char *word)
+{
+    if((log->wordCount + 1) * 2 > log->wordCap && !growWords(log, log->wordCap ? log->wordCap * 2 : 64))
         return NULL;
+
+    HistoryWord *slot = findHistoryWord(log, word);
+    if(slot->word) return slot;
+
+    size_t len = strlen(word) + 1;
+    char *copy = (char *)arenaAlloc(&log->strings, len);
+    if(!copy) return NULL;
+    memcpy(copy, word, len);
+    slot->word = copy;
+    slot->latest = 0;
+    log->wordCount++;
+    return slot;
+}
+
+static int addRecord(HistoryLog *log, int64_t time, char op, const char *word, const char *synonym);
+
+// Tabel kata hanya bertambah, jadi setelah banyak record dibuang tabel dan
+// arena dibangun ulang dari record yang masih ada saja
+static void compactWords(HistoryLog *log)
+{
+    HistoryLog fresh = *log;
+    fresh.words = NULL;
+    fresh.wordCap = fresh.wordCount = 0;
+    memset(&fresh.strings, 0, sizeof(fresh.strings));
+    fresh.records = (HistoryRecord *)malloc(log->allocated * sizeof(HistoryRecord));
+    if(!fresh.records) return;
+    fresh.first = fresh.next = log->first;
+
+    for(uint64_t seq = log->first; seq < log->next; seq++)
+    {
+        const HistoryRecord *record = recordAt(log, seq);
+        if(!addRecord(&fresh, record->time, record->op, record->word, record->synonym))
+        {
+            free(fresh.records);
+            free(fresh.words);
+            arenaFree(&fresh.strings);
+            return;
+        }
     }
 
-    newNode->next = NULL;
-    return  newNode;
+    free(log->records);
+    free(log->words);
+    arenaFree(&log->strings);
+    log->first = fresh.first;
+    log->records = fresh.records;
+    log->words = fresh.words;
+    log->wordCap = fresh.wordCap;
+    log->wordCount = fresh.wordCount;
+    log->strings = fresh.strings;
 }
 
-void pushHistory(const char *action)
+// Sambungkan record seq ke rantai kata; mengembalikan seq sebelumnya
+static int linkWord(HistoryLog *log, const char *word, uint64_t seq, const char **interned, uint64_t *prev)
 {
-    HistoryNode *newNode = createHistoryNode(action);
-    if(!newNode) return;
+    HistoryWord *slot = internHistoryWord(log, word);
+    if(!slot) return 0;
+    *interned = slot->word;
+    *prev = slot->latest >= log->first ? slot->latest : 0;
+    slot->latest = seq;
+    return 1;
+}
+
+// Ring diperbesar dua kali lipat (paling banyak capacity) sampai penuh
+static int growRecords(HistoryLog *log)
+{
+    size_t size = log->allocated ? log->allocated * 2 : 64;
+    if(size > log->capacity) size = log->capacity;
+    HistoryRecord *records = (HistoryRecord *)malloc(size * sizeof(HistoryRecord));
+    if(!records) return 0;
 
-    newNode->next = historyTop;
-    historyTop = newNode;
+    for(uint64_t seq = log->first; seq < log->next; seq++)
+        records[(seq - 1) % size] = *recordAt(log, seq);
+    free(log->records);
+    log->records = records;
+    log->allocated = size;
+    return 1;
 }
 
-void pushLoadedHistory(const char *time, const char *action)
+// Tambah record di ujung ring; dipanggil dengan lock riwayat dipegang
+static int addRecord(HistoryLog *log, int64_t time, char op, const char *word, const char *synonym)
 {
-    HistoryNode *newNode = (HistoryNode *)malloc(sizeof(HistoryNode));
-    if(!newNode) 
+    if(log->next > log->first)
     {
-        perror("Memory allocation failed for HistoryNode (load).\n");
-        return;
+        // waktu tidak boleh turun (jam mundur, file lama tidak urut) supaya binary search tetap benar
+        int64_t last = recordAt(log, log->next - 1)->time;
+        if(time < last) time = last;
     }
 
-    newNode->time = strdup(time);
-    if(!newNode->time)
+    if(log->next - log->first == log->allocated)
     {
-        perror("Memory allocation failed for time (load)\n");
-        return;
+        if(log->allocated < log->capacity)
+        {
+            if(!growRecords(log)) return 0;
+        }
+        else log->first++;
     }
+    while(log->maxAge && log->first < log->next && recordAt(log, log->first)->time < time - log->maxAge)
+        log->first++;
+
+    HistoryRecord record;
+    record.time = time;
+    record.op = op;
+    record.synonym = NULL;
+    record.prevSynonym = 0;
+    if(!linkWord(log, word, log->next, &record.word, &record.prevWord)) return 0;
+    if(synonym && strcmp(synonym, word) != 0 &&
+       !linkWord(log, synonym, log->next, &record.synonym, &record.prevSynonym))
+        return 0;
+    if(synonym && !record.synonym) record.synonym = record.word;
+
+    *recordAt(log, log->next) = record;
+    log->next++;
 
-    newNode->action = strdup(action);
-    if(!newNode->action)
+    if(log->wordCount > 4 * log->capacity && log->wordCount > 1024) compactWords(log);
+    return 1;
+}
+
+// Tulis teks aksi record seperti yang dulu disimpan di history.txt.
+// Mengembalikan panjangnya seperti snprintf.
+int formatHistoryAction(const HistoryRecord *record, char *buffer, size_t size)
+{
+    switch(record->op)
     {
-        perror("Memory allocation failed for action (load)\n");
-        return;
+    case WAL_OP_ADD_WORD:
+        return snprintf(buffer, size, "create a new entry '%s' into the dictionary", record->word);
+    case WAL_OP_ADD_SYNONYM:
+        return snprintf(buffer, size, "add synonym %s to %s", record->synonym, record->word);
+    case WAL_OP_DELETE_WORD:
+        return snprintf(buffer, size, "Delete %s from word entry", record->word);
+    case WAL_OP_DELETE_SYNONYM:
+        return snprintf(buffer, size, "Delete %s from %s", record->synonym, record->word);
+    default:
+        return snprintf(buffer, size, "%s", record->word);
     }
+}
 
-    newNode->next = historyTop;
-    historyTop = newNode;
+void formatHistoryTime(int64_t time, char *buffer, size_t size)
+{
+    time_t t = (time_t)time;
+    struct tm local;
+#ifndef _WIN32
+    int ok = localtime_r(&t, &local) != NULL;
+#else
+    int ok = localtime_s(&local, &t) == 0;
+#endif
+    if(!ok || !strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &local)) snprintf(buffer, size, "%lld", (long long)time);
 }
 
-void printHistory(void) 
+// formatHistoryTime untuk record yang berurutan: banyak record jatuh di detik
+// yang sama, jadi teks detik sebelumnya dipakai lagi
+static const char *cachedHistoryTime(int64_t time, int64_t *cachedTime, char *buffer, size_t size)
 {
-    printf("\n==================================== Action History ====================================\n\n");
-    HistoryNode *current = historyTop;
+    if(*cachedTime != time)
+    {
+        formatHistoryTime(time, buffer, size);
+        *cachedTime = time;
+    }
+    return buffer;
+}
+
+// "YYYY-MM-DD HH:MM:SS" (jam boleh tidak ada) waktu lokal; -1 jika salah
+int64_t parseHistoryTime(const char *text)
+{
+    struct tm t;
+    memset(&t, 0, sizeof(t));
+    int fields = sscanf(text, "%d-%d-%d %d:%d:%d", &t.tm_year, &t.tm_mon, &t.tm_mday,
+                        &t.tm_hour, &t.tm_min, &t.tm_sec);
+    if(fields != 3 && fields != 6) return -1;
+    t.tm_year -= 1900;
+    t.tm_mon -= 1;
+    t.tm_isdst = -1;
+    time_t result = mktime(&t);
+    return result == (time_t)-1 ? -1 : (int64_t)result;
+}
+
+// Catat aksi sekarang. word dan synonym disalin; synonym NULL untuk aksi
+// pada kata utama. Dipanggil oleh fungsi *Locked di synonym.c.
+void pushHistory(Dictionary *dict, char op, const char *word, const char *synonym)
+{
+    HistoryLog *log = dict->history;
+    char timeText[32], small[256];
+    char *action = small;
+
+    HISTORY_LOCK(log);
+    int ok = addRecord(log, (int64_t)time(NULL), op, word, synonym);
+    if(ok)
+    {
+        const HistoryRecord *record = recordAt(log, log->next - 1);
+        strcpy(timeText, cachedHistoryTime(record->time, &log->textTime, log->timeText, sizeof(log->timeText)));
+        int len = formatHistoryAction(record, small, sizeof(small));
+        if(len >= (int)sizeof(small) && (action = (char *)malloc((size_t)len + 1)))
+            formatHistoryAction(record, action, (size_t)len + 1);
+    }
+    HISTORY_UNLOCK(log);
+
+    // log ditulis di luar lock riwayat, jadi pembaca riwayat tidak ikut
+    // menunggu log (atau fsync di mode sinkron)
+    if(ok && action) walAppend(dict, WAL_OP_HISTORY, timeText, action);
+    if(action != small) free(action);
+}
+
+// Potong kata di antara prefix dan suffix dari action ke buffer
+static const char *between(const char *action, const char *prefix, const char *suffix, char *buffer)
+{
+    size_t prefixLen = strlen(prefix), suffixLen = strlen(suffix), len = strlen(action);
+    if(len <= prefixLen + suffixLen || strncmp(action, prefix, prefixLen) != 0 ||
+       strcmp(action + len - suffixLen, suffix) != 0)
+        return NULL;
+    memcpy(buffer, action + prefixLen, len - prefixLen - suffixLen);
+    buffer[len - prefixLen - suffixLen] = '\0';
+    return buffer;
+}
+
+// Ubah teks aksi lama kembali menjadi record; teks lain disimpan apa adanya
+static int addActionText(HistoryLog *log, int64_t time, const char *action)
+{
+    size_t len = strlen(action);
+    char *buffer = (char *)malloc(len + 1);
+    if(!buffer) return 0;
+
+    int ok;
+    const char *split;
+    if(between(action, "create a new entry '", "' into the dictionary", buffer))
+        ok = addRecord(log, time, WAL_OP_ADD_WORD, buffer, NULL);
+    else if(between(action, "Delete ", " from word entry", buffer))
+        ok = addRecord(log, time, WAL_OP_DELETE_WORD, buffer, NULL);
+    else if(between(action, "add synonym ", "", buffer) && (split = strstr(buffer, " to ")))
+    {
+        buffer[split - buffer] = '\0';
+        ok = addRecord(log, time, WAL_OP_ADD_SYNONYM, split + 4, buffer);
+    }
+    else if(between(action, "Delete ", "", buffer) && (split = strstr(buffer, " from ")))
+    {
+        buffer[split - buffer] = '\0';
+        ok = addRecord(log, time, WAL_OP_DELETE_SYNONYM, split + 6, buffer);
+    }
+    else ok = addRecord(log, time, WAL_OP_HISTORY, action, NULL);
+
+    free(buffer);
+    return ok;
+}
+
+// Riwayat dari log (waktu dan aksi dalam bentuk teks)
+void pushLoadedHistory(Dictionary *dict, const char *time, const char *action)
+{
+    int64_t t = parseHistoryTime(time);
+    if(t < 0) return;
 
-    if(!current) printf("Belum ada riwayat.\n");
+    HistoryLog *log = dict->history;
+    HISTORY_LOCK(log);
+    if(!addActionText(log, t, action)) perror("Memory allocation failed for history (load)");
+    HISTORY_UNLOCK(log);
+}
+
+// Panggil visit untuk record dengan waktu di [from, to], dari yang tertua,
+// paling banyak k. visit dipanggil dengan lock riwayat dipegang, jadi tidak
+// boleh mencatat riwayat; berhenti jika visit mengembalikan 0. Mengembalikan
+// jumlah record yang dikunjungi.
+size_t historyBetween(Dictionary *dict, int64_t from, int64_t to, size_t k,
+                      int (*visit)(const HistoryRecord *record, void *ctx), void *ctx)
+{
+    HistoryLog *log = dict->history;
+    HISTORY_LOCK(log);
 
-    while(current)
+    // record pertama dengan waktu >= from
+    uint64_t low = log->first, high = log->next;
+    while(low < high)
     {
-        printf("%-30s %s\n", current->time, current->action);
-        current = current->next;
+        uint64_t mid = low + (high - low) / 2;
+        if(recordAt(log, mid)->time < from) low = mid + 1;
+        else high = mid;
     }
+
+    size_t visited = 0;
+    for(uint64_t seq = low; seq < log->next && visited < k; seq++)
+    {
+        const HistoryRecord *record = recordAt(log, seq);
+        if(record->time > to) break;
+        visited++;
+        if(!visit(record, ctx)) break;
+    }
+    HISTORY_UNLOCK(log);
+    return visited;
 }
 
-void freeHistory(void)
+// Panggil visit untuk record yang menyentuh word (sebagai kata utama atau
+// sinonim), dari yang terbaru, paling banyak k. Aturan visit sama dengan
+// historyBetween.
+size_t historyForWord(Dictionary *dict, const char *word, size_t k,
+                      int (*visit)(const HistoryRecord *record, void *ctx), void *ctx)
 {
-    HistoryNode *current = historyTop;
-    while(current)
+    HistoryLog *log = dict->history;
+    HISTORY_LOCK(log);
+
+    size_t visited = 0;
+    HistoryWord *slot = findHistoryWord(log, word);
+    uint64_t seq = slot && slot->word ? slot->latest : 0;
+    while(seq >= log->first && seq > 0 && visited < k)
     {
-        HistoryNode *next = current->next;
-        free(current->action);
-        free(current->time);
-        free(current);
-        current = next;
+        const HistoryRecord *record = recordAt(log, seq);
+        visited++;
+        if(!visit(record, ctx)) break;
+        seq = record->word == slot->word ? record->prevWord : record->prevSynonym;
     }
-    historyTop = NULL;
+    HISTORY_UNLOCK(log);
+    return visited;
+}
+
+static int printHistoryRecord(const HistoryRecord *record, void *ctx)
+{
+    (void)ctx;
+    char timeText[32];
+    formatHistoryTime(record->time, timeText, sizeof(timeText));
+    int len = formatHistoryAction(record, NULL, 0);
+    char *action = (char *)malloc((size_t)len + 1);
+    if(!action) return 0;
+    formatHistoryAction(record, action, (size_t)len + 1);
+    printf("%-30s %s\n", timeText, action);
+    free(action);
+    return 1;
+}
+
+void printHistory(Dictionary *dict)
+{
+    printf("\n==================================== Action History ====================================\n\n");
+    HistoryLog *log = dict->history;
+    HISTORY_LOCK(log);
+    if(log->next == log->first) printf("Belum ada riwayat.\n");
+    // terbaru dulu
+    for(uint64_t seq = log->next; seq > log->first; seq--)
+        if(!printHistoryRecord(recordAt(log, seq - 1), NULL)) break;
+    HISTORY_UNLOCK(log);
 }
 
-void saveToFileHistory(const char *filename)
+// Tampilkan riwayat di antara dua waktu "YYYY-MM-DD [HH:MM:SS]"; to kosong
+// berarti sampai sekarang
+void printHistoryBetween(Dictionary *dict, const char *from, const char *to)
 {
-    FILE *file = fopen(filename, "w");
-    if(!file)
+    int64_t start = parseHistoryTime(from);
+    int64_t end = to[0] ? parseHistoryTime(to) : INT64_MAX;
+    if(start < 0 || end < 0)
     {
-        printf("Failed to open file to save history.\n");
+        printf("Format waktu: YYYY-MM-DD atau YYYY-MM-DD HH:MM:SS\n");
         return;
     }
+    // tanggal saja berarti sampai akhir hari itu
+    if(to[0] && !strchr(to, ':')) end += 24 * 60 * 60 - 1;
 
-    HistoryNode *current = historyTop;
-    while(current)
+    if(!historyBetween(dict, start, end, (size_t)-1, printHistoryRecord, NULL))
+        printf("Tidak ada riwayat di antara waktu itu.\n");
+}
+
+void printHistoryForWord(Dictionary *dict, const char *word)
+{
+    if(!historyForWord(dict, word, (size_t)-1, printHistoryRecord, NULL))
+        printf("Tidak ada riwayat untuk '%s'.\n", word);
+}
+
+// Byte yang dipakai riwayat; *records diisi jumlah record yang tersimpan
+size_t historyBytes(Dictionary *dict, size_t *records)
+{
+    HistoryLog *log = dict->history;
+    *records = 0;
+    if(!log) return 0;
+    HISTORY_LOCK(log);
+    *records = (size_t)(log->next - log->first);
+    size_t bytes = sizeof(HistoryLog) + log->allocated * sizeof(HistoryRecord) +
+                   log->wordCap * sizeof(HistoryWord) + log->strings.reserved;
+    HISTORY_UNLOCK(log);
+    return bytes;
+}
+
+void freeHistory(Dictionary *dict)
+{
+    HistoryLog *log = dict->history;
+    if(!log) return;
+    free(log->records);
+    free(log->words);
+    arenaFree(&log->strings);
+#ifndef _WIN32
+    pthread_mutex_destroy(&log->lock);
+#endif
+    free(log);
+    dict->history = NULL;
+}
+
+// Isi history.txt (dari record tertua) dalam satu buffer malloc sebesar
+// *size byte; NULL jika gagal. Lock riwayat hanya dipegang selama menyalin.
+// generation selain 0 ditulis di baris pertama (lihat wal.c).
+char *historyText(Dictionary *dict, uint64_t generation, size_t *size)
+{
+    HistoryLog *log = dict->history;
+    size_t length = 0, cap = 4096;
+    char *text = (char *)malloc(cap);
+    char timeText[32];
+    int64_t textTime = -1;
+
+    if(text && generation)
+        length = (size_t)snprintf(text, cap, "%s%llu\n", historyGenerationLine, (unsigned long long)generation);
+
+    HISTORY_LOCK(log);
+    for(uint64_t seq = log->first; text && seq < log->next; seq++)
     {
-        fprintf(file, "%s,%s\n", current->time, current->action);
-        current = current->next;
+        const HistoryRecord *record = recordAt(log, seq);
+        const char *when = cachedHistoryTime(record->time, &textTime, timeText, sizeof(timeText));
+        size_t whenLen = strlen(when);
+        size_t actionLen = (size_t)formatHistoryAction(record, NULL, 0);
+        size_t needed = length + whenLen + actionLen + 3;
+        if(needed > cap)
+        {
+            while(cap < needed) cap *= 2;
+            char *grown = (char *)realloc(text, cap);
+            if(!grown) free(text);
+            if(!(text = grown)) break;
+        }
+
+        memcpy(text + length, when, whenLen);
+        length += whenLen;
+        text[length++] = ',';
+        formatHistoryAction(record, text + length, cap - length);
+        length += actionLen;
+        text[length++] = '\n';
     }
+    HISTORY_UNLOCK(log);
+
+    *size = length;
+    return text;
+}
+
+// Tulis riwayat dari yang tertua
+int saveToFileHistory(Dictionary *dict, const char *filename)
+{
+    size_t size;
+    char *text = historyText(dict, 0, &size);
+    int ok = text && writeReplacement(filename, text, size);
+    free(text);
+    if(!ok) printf("Failed to save history to %s.\n", filename);
+    return ok;
+}
+
+typedef struct HistoryLine
+{
+    int64_t time;
+    size_t index;           // urutan di file, supaya sort stabil
+    const char *start;      // aksi di file yang di-mmap
+    size_t len;
+} HistoryLine;
 
-    fclose(file);
+static int compareHistoryLine(const void *a, const void *b)
+{
+    const HistoryLine *x = (const HistoryLine *)a, *y = (const HistoryLine *)b;
+    if(x->time != y->time) return x->time < y->time ? -1 : 1;
+    return (x->index > y->index) - (x->index < y->index);
 }
 
-void loadFromFileHistory(const char *filename)
+// Baca "waktu,aksi" per baris. File lama ditulis dari yang terbaru (atau
+// campur aduk), jadi baris diurutkan dulu menurut waktu.
+void loadFromFileHistory(Dictionary *dict, const char *filename)
 {
-    FILE *file = fopen(filename, "r");
-    if(!file)
+    MappedFile file;
+    if(!mapFile(filename, &file))
     {
         printf("Failed to open file %s for history.\n", filename);
         return;
     }
 
-    char line[1024];
-    while(fgets(line, sizeof(line), file))
+    HistoryLine *lines = NULL;
+    size_t count = 0, cap = 0, longest = 0;
+    const char *p = file.data, *end = file.data + file.size;
+    size_t markLen = strlen(historyGenerationLine);
+    if(file.size > markLen && memcmp(p, historyGenerationLine, markLen) == 0)
+        dict->historyGeneration = strtoull(p + markLen, NULL, 10);
+    while(p < end)
     {
-        char *token;
-        char *historyTime = strtok(line, ",\n");
-        char *historyAction = strtok(NULL, "\n");
-
-        if(historyTime) 
-            trim(historyTime);
-
-        if(historyAction)
-            trim(historyAction);
+        const char *eol = memchr(p, '\n', (size_t)(end - p));
+        if(!eol) eol = end;
+        const char *comma = memchr(p, ',', (size_t)(eol - p));
+        if(comma && comma - p < 32)
+        {
+            char timeText[32];
+            memcpy(timeText, p, (size_t)(comma - p));
+            timeText[comma - p] = '\0';
+            trim(timeText);
+            int64_t t = parseHistoryTime(timeText);
+            if(t >= 0)
+            {
+                if(count == cap)
+                {
+                    cap = cap ? cap * 2 : 256;
+                    HistoryLine *grown = (HistoryLine *)realloc(lines, cap * sizeof(HistoryLine));
+                    if(!grown) break;
+                    lines = grown;
+                }
+                lines[count] = (HistoryLine){t, count, comma + 1, (size_t)(eol - comma - 1)};
+                if(lines[count].len > longest) longest = lines[count].len;
+                count++;
+            }
+        }
+        p = eol + 1;
+    }
+    qsort(lines, count, sizeof(HistoryLine), compareHistoryLine);
 
-        if (historyTime && historyAction && strlen(historyAction) > 0 && strlen(historyTime) > 0) 
-            pushLoadedHistory(historyTime, historyAction);
+    char *action = (char *)malloc(longest + 1);
+    HistoryLog *log = dict->history;
+    HISTORY_LOCK(log);
+    for(size_t i = 0; action && i < count; i++)
+    {
+        memcpy(action, lines[i].start, lines[i].len);
+        action[lines[i].len] = '\0';
+        trim(action);
+        if(action[0] && !addActionText(log, lines[i].time, action))
+        {
+            perror("Memory allocation failed for history (load)");
+            break;
+        }
     }
+    HISTORY_UNLOCK(log);
 
-    fclose(file);
-}
\ No newline at end of file
+    free(action);
+    free(lines);
+    unmapFile(&file);
+}
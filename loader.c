@@ -0,0 +1,482 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dictionary_private.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <io.h>
+#endif
+
+// Petakan seluruh file ke memori (mmap); di Windows dibaca sekaligus ke buffer
+int mapFile(const char *filename, MappedFile *file)
+{
+    file->data = NULL;
+    file->size = 0;
+    file->mapped = 0;
+
+#ifndef _WIN32
+    int fd = open(filename, O_RDONLY);
+    if(fd < 0) return 0;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return 0;
+    }
+
+    file->size = (size_t)st.st_size;
+    if(file->size > 0)
+    {
+        void *data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data == MAP_FAILED)
+        {
+            close(fd);
+            return 0;
+        }
+        madvise(data, file->size, MADV_SEQUENTIAL);
+        file->data = (const char *)data;
+        file->mapped = 1;
+    }
+    close(fd);
+    return 1;
+#else
+    FILE *fp = fopen(filename, "rb");
+    if(!fp) return 0;
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if(size > 0)
+    {
+        char *data = (char *)malloc((size_t)size);
+        if(!data || fread(data, 1, (size_t)size, fp) != (size_t)size)
+        {
+            free(data);
+            fclose(fp);
+            return 0;
+        }
+        file->data = data;
+        file->size = (size_t)size;
+    }
+    fclose(fp);
+    return 1;
+#endif
+}
+
+void unmapFile(MappedFile *file)
+{
+#ifndef _WIN32
+    if(file->mapped) munmap((void *)file->data, file->size);
+#else
+    free((void *)file->data);
+#endif
+    file->data = NULL;
+    file->size = 0;
+    file->mapped = 0;
+}
+
+// Paksa isi file yang sudah di-fflush sampai ke disk
+int syncFile(FILE *fp)
+{
+#ifndef _WIN32
+    return fsync(fileno(fp)) == 0;
+#else
+    return _commit(_fileno(fp)) == 0;
+#endif
+}
+
+// Nama file di samping file lain: ekstensinya (jika ada) diganti ext, jadi
+// ("kamus/lain.txt", ".snap") -> "kamus/lain.snap". Hasil malloc.
+char *pathWithExtension(const char *file, const char *ext)
+{
+    size_t len = strlen(file);
+    const char *dot = strrchr(file, '.');
+    const char *slash = strrchr(file, '/');
+    if(dot && dot != file && (!slash || dot > slash + 1)) len = (size_t)(dot - file);
+
+    char *path = (char *)malloc(len + strlen(ext) + 1);
+    if(!path) return NULL;
+    memcpy(path, file, len);
+    strcpy(path + len, ext);
+    return path;
+}
+
+// Tulis file baru lewat file sementara "<nama>.tmp" lalu rename, jadi isi
+// lama tetap utuh sampai isi baru benar-benar ada di disk
+FILE *openReplacement(const char *filename, char **tmpName)
+{
+    size_t len = strlen(filename) + 5;
+    *tmpName = (char *)malloc(len);
+    if(!*tmpName) return NULL;
+    snprintf(*tmpName, len, "%s.tmp", filename);
+
+    FILE *fp = fopen(*tmpName, "wb");
+    if(!fp)
+    {
+        free(*tmpName);
+        *tmpName = NULL;
+    }
+    return fp;
+}
+
+// ok = 0 membatalkan penggantian. Mengembalikan 1 jika file sudah diganti.
+int commitReplacement(FILE *fp, char *tmpName, const char *filename, int ok)
+{
+    ok = ok && fflush(fp) == 0 && syncFile(fp);
+    ok = fclose(fp) == 0 && ok;
+#ifdef _WIN32
+    if(ok) remove(filename);
+#endif
+    if(ok) ok = rename(tmpName, filename) == 0;
+    if(!ok) remove(tmpName);
+    free(tmpName);
+    return ok;
+}
+
+// Ganti isi filename dengan size byte dari data sekaligus
+int writeReplacement(const char *filename, const void *data, size_t size)
+{
+    char *tmpName;
+    FILE *fp = openReplacement(filename, &tmpName);
+    if(!fp) return 0;
+    return commitReplacement(fp, tmpName, filename, size == 0 || fwrite(data, 1, size, fp) == size);
+}
+
+static size_t countLines(const char *data, size_t size)
+{
+    size_t lines = 0;
+    const char *p = data, *end = data + size;
+    while(p < end && (p = memchr(p, '\n', (size_t)(end - p))))
+    {
+        lines++;
+        p++;
+    }
+    return lines + 1;
+}
+
+// File dibagi menjadi chunk yang berakhir di batas baris. Tiap chunk
+// di-parse (trim, kapitalisasi, hash) ke buffer sendiri, lalu dimasukkan ke
+// kamus sesuai urutan file, jadi hasilnya sama persis dengan load berurutan.
+
+static int reserveChunk(void **items, size_t *cap, size_t needed, size_t itemSize)
+{
+    if(needed <= *cap) return 1;
+
+    size_t newCap = *cap ? *cap : 64;
+    while(newCap < needed) newCap *= 2;
+    void *grown = realloc(*items, newCap * itemSize);
+    if(!grown) return 0;
+    *items = grown;
+    *cap = newCap;
+    return 1;
+}
+
+// Salin potongan [start, end) ke teks chunk, trim, dan catat sebagai token
+static int pushToken(LoadChunk *chunk, const char *start, const char *end, int capital, LoadToken *token)
+{
+    size_t len = (size_t)(end - start);
+    if(!reserveChunk((void **)&chunk->text, &chunk->textCap, chunk->textLen + len + 1, 1)) return 0;
+
+    char *text = chunk->text + chunk->textLen;
+    memcpy(text, start, len);
+    text[len] = '\0';
+    if(capital) trim_and_tocapital(text);
+    else trim(text);
+    if(text[0] == '\0') return 0;
+
+    size_t textLen = strlen(text);
+    token->offset = chunk->textLen;
+    token->hash = hashBytes(text, textLen);
+    chunk->textLen += textLen + 1;
+    return 1;
+}
+
+// Satu baris "Kata : Sinonim1, Sinonim2, ..." langsung dari memori file
+static void parseLine(LoadChunk *chunk, const char *line, const char *lineEnd)
+{
+    const char *colon = memchr(line, ':', (size_t)(lineEnd - line));
+    const char *wordEnd = colon ? colon : lineEnd;
+
+    if(!reserveChunk((void **)&chunk->lines, &chunk->lineCap, chunk->lineCount + 1, sizeof(LoadLine)))
+        return;
+
+    LoadLine *parsed = &chunk->lines[chunk->lineCount];
+    if(!pushToken(chunk, line, wordEnd, 1, &parsed->word)) return;
+    parsed->synonymStart = chunk->synonymCount;
+    chunk->lineCount++;
+    if(!colon) return;
+
+    const char *p = colon + 1;
+    while(p < lineEnd)
+    {
+        const char *comma = memchr(p, ',', (size_t)(lineEnd - p));
+        const char *tokenEnd = comma ? comma : lineEnd;
+
+        if(reserveChunk((void **)&chunk->synonyms, &chunk->synonymCap,
+                        chunk->synonymCount + 1, sizeof(LoadToken)) &&
+           pushToken(chunk, p, tokenEnd, 0, &chunk->synonyms[chunk->synonymCount]))
+            chunk->synonymCount++;
+
+        p = tokenEnd + 1;
+    }
+}
+
+static void parseChunk(LoadChunk *chunk)
+{
+    const char *p = chunk->start;
+    while(p < chunk->end)
+    {
+        const char *newline = memchr(p, '\n', (size_t)(chunk->end - p));
+        const char *lineEnd = newline ? newline : chunk->end;
+        parseLine(chunk, p, lineEnd);
+        p = lineEnd + 1;
+    }
+}
+
+// Masukkan hasil parse ke kamus. Hash sudah dihitung, jadi tiap baris
+// cukup satu lookup entry dan satu intern per sinonim.
+static void applyChunk(Dictionary *dict, LoadChunk *chunk)
+{
+    for(size_t i = 0; i < chunk->lineCount; i++)
+    {
+        const LoadLine *line = &chunk->lines[i];
+        const char *word = chunk->text + line->word.offset;
+
+        WordEntry *entry = hashTableFindHashed(dict, word, line->word.hash);
+        if(!entry) entry = insertWordEntry(dict, word);
+        if(!entry) continue;
+
+        // sinonim dibaca dari yang terbaru, jadi ditambahkan dari belakang
+        // supaya menyimpan lagi menghasilkan baris yang sama
+        size_t synonymEnd = i + 1 < chunk->lineCount ? chunk->lines[i + 1].synonymStart : chunk->synonymCount;
+        synonymReserve(dict, entry, synonymEnd - line->synonymStart);
+        for(size_t j = synonymEnd; j-- > line->synonymStart;)
+        {
+            const LoadToken *synonym = &chunk->synonyms[j];
+            appendSynonym(dict, entry, internStringHashed(dict, chunk->text + synonym->offset, synonym->hash));
+        }
+    }
+}
+
+static void freeChunk(LoadChunk *chunk)
+{
+    free(chunk->text);
+    free(chunk->lines);
+    free(chunk->synonyms);
+    chunk->text = NULL;
+    chunk->lines = NULL;
+    chunk->synonyms = NULL;
+    chunk->textLen = chunk->textCap = 0;
+    chunk->lineCount = chunk->lineCap = 0;
+    chunk->synonymCount = chunk->synonymCap = 0;
+}
+
+// Bagi [data, data+size) menjadi chunk sekitar LOAD_CHUNK_BYTES yang berakhir di '\n'
+static LoadChunk *splitChunks(const char *data, size_t size, size_t *count)
+{
+    size_t maxChunks = size / LOAD_CHUNK_BYTES + 1;
+    LoadChunk *chunks = (LoadChunk *)calloc(maxChunks, sizeof(LoadChunk));
+    if(!chunks) return NULL;
+
+    size_t n = 0;
+    const char *p = data, *end = data + size;
+    while(p < end)
+    {
+        const char *chunkEnd = end;
+        if((size_t)(end - p) > LOAD_CHUNK_BYTES)
+        {
+            const char *newline = memchr(p + LOAD_CHUNK_BYTES, '\n', (size_t)(end - p - LOAD_CHUNK_BYTES));
+            chunkEnd = newline ? newline + 1 : end;
+        }
+        chunks[n].start = p;
+        chunks[n].end = chunkEnd;
+        n++;
+        p = chunkEnd;
+    }
+    *count = n;
+    return chunks;
+}
+
+#ifndef _WIN32
+typedef struct LoadJob
+{
+    LoadChunk *chunks;
+    size_t chunkCount;
+    size_t nextChunk;   // chunk berikutnya yang akan di-parse
+    size_t applied;     // chunk yang sudah dimasukkan ke kamus
+    size_t window;      // batas chunk yang boleh di-parse lebih dulu
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} LoadJob;
+
+static void *parseWorker(void *arg)
+{
+    LoadJob *job = (LoadJob *)arg;
+
+    pthread_mutex_lock(&job->lock);
+    for(;;)
+    {
+        // jangan terlalu jauh di depan thread utama supaya memori tetap terbatas
+        while(job->nextChunk < job->chunkCount && job->nextChunk >= job->applied + job->window)
+            pthread_cond_wait(&job->changed, &job->lock);
+        if(job->nextChunk >= job->chunkCount) break;
+
+        LoadChunk *chunk = &job->chunks[job->nextChunk++];
+        pthread_mutex_unlock(&job->lock);
+        parseChunk(chunk);
+        pthread_mutex_lock(&job->lock);
+
+        chunk->ready = 1;
+        pthread_cond_broadcast(&job->changed);
+    }
+    pthread_mutex_unlock(&job->lock);
+    return NULL;
+}
+
+static int loadThreadCount(size_t chunkCount)
+{
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *env = getenv("SYNONYM_LOAD_THREADS");
+    if(env && atoi(env) > 0) threads = atoi(env);
+
+    if(threads < 1) threads = 1;
+    if(threads > LOAD_THREADS_MAX) threads = LOAD_THREADS_MAX;
+    if((size_t)threads > chunkCount) threads = (long)chunkCount;
+    return (int)threads;
+}
+
+// Worker mem-parse chunk secara paralel, thread utama memasukkan hasilnya berurutan
+static int loadChunksParallel(Dictionary *dict, LoadChunk *chunks, size_t chunkCount, int threads)
+{
+    LoadJob job;
+    job.chunks = chunks;
+    job.chunkCount = chunkCount;
+    job.nextChunk = 0;
+    job.applied = 0;
+    job.window = (size_t)threads * 2;
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.changed, NULL);
+
+    pthread_t workers[LOAD_THREADS_MAX];
+    int started = 0;
+    for(; started < threads; started++)
+        if(pthread_create(&workers[started], NULL, parseWorker, &job) != 0) break;
+
+    if(started == 0)
+    {
+        pthread_mutex_destroy(&job.lock);
+        pthread_cond_destroy(&job.changed);
+        return 0;
+    }
+
+    for(size_t i = 0; i < chunkCount; i++)
+    {
+        pthread_mutex_lock(&job.lock);
+        while(!chunks[i].ready) pthread_cond_wait(&job.changed, &job.lock);
+        pthread_mutex_unlock(&job.lock);
+
+        applyChunk(dict, &chunks[i]);
+        freeChunk(&chunks[i]);
+
+        pthread_mutex_lock(&job.lock);
+        job.applied++;
+        pthread_cond_broadcast(&job.changed);
+        pthread_mutex_unlock(&job.lock);
+    }
+
+    for(int t = 0; t < started; t++) pthread_join(workers[t], NULL);
+    pthread_mutex_destroy(&job.lock);
+    pthread_cond_destroy(&job.changed);
+    return 1;
+}
+#endif
+
+// Fungsi untuk load data dari file: file di-mmap, dibagi per chunk baris,
+// di-parse paralel, lalu dimasukkan berurutan ke hash table yang sudah
+// diperbesar di awal. Tidak ada batas panjang baris.
+void loadFromFileSynonym(Dictionary *dict, const char *filename)
+{
+    STATS_BEGIN(STATS_LOAD);
+    MappedFile file;
+    if(!mapFile(filename, &file))
+    {
+        printf("Failed to open file %s for synonym.\n", filename);
+        return;
+    }
+
+    hashTableReserve(dict, dict->index.count + countLines(file.data, file.size));
+
+    size_t chunkCount = 0;
+    LoadChunk *chunks = splitChunks(file.data, file.size, &chunkCount);
+    if(!chunks)
+    {
+        printf("Failed to allocate memory for loading %s.\n", filename);
+        unmapFile(&file);
+        return;
+    }
+
+    int done = 0;
+#ifndef _WIN32
+    int threads = loadThreadCount(chunkCount);
+    if(threads > 1) done = loadChunksParallel(dict, chunks, chunkCount, threads);
+#endif
+
+    for(size_t i = 0; !done && i < chunkCount; i++)
+    {
+        parseChunk(&chunks[i]);
+        applyChunk(dict, &chunks[i]);
+        freeChunk(&chunks[i]);
+    }
+
+    free(chunks);
+    unmapFile(&file);
+    STATS_END(STATS_LOAD);
+}
+
+#ifndef _WIN32
+static void *historyLoader(void *arg)
+{
+    Dictionary *dict = (Dictionary *)arg;
+    loadFromFileHistory(dict, dict->historyFile);
+    return NULL;
+}
+#endif
+
+// Snapshot milik file dasar (dict->snapshotFile) dipakai jika ada dan tidak
+// lebih tua dari file teks, selain itu file teks di-parse seperti biasa
+static void loadSynonyms(Dictionary *dict)
+{
+    if(snapshotIsFresh(dict->snapshotFile, dict->synonymFile))
+    {
+        STATS_BEGIN(STATS_LOAD);
+        int loaded = loadSnapshot(dict, dict->snapshotFile);
+        STATS_END(STATS_LOAD);
+        if(loaded) return;
+    }
+    loadFromFileSynonym(dict, dict->synonymFile);
+}
+
+// Load kamus dan riwayat dari file yang diberikan ke dictionaryCreate,
+// bersamaan; riwayat hanya menyentuh dict->history. File yang tidak
+// diberikan (NULL) dilewati.
+void loadDictionary(Dictionary *dict)
+{
+#ifndef _WIN32
+    pthread_t historyThread;
+    if(dict->synonymFile && dict->historyFile && pthread_create(&historyThread, NULL, historyLoader, dict) == 0)
+    {
+        loadSynonyms(dict);
+        pthread_join(historyThread, NULL);
+        return;
+    }
+#endif
+    if(dict->synonymFile) loadSynonyms(dict);
+    if(dict->historyFile) loadFromFileHistory(dict, dict->historyFile);
+}
@@ -1,21 +1,85 @@
 #include "dictionary.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-int main()
+// program rewrite [annotate|replace] [masukan] [keluaran]
+// Tanpa nama file (atau "-") dibaca dari stdin dan ditulis ke stdout.
+static int rewrite(Dictionary *dict, int argc, char **argv)
 {
-    rootTrie = createTrieNode();
-    if(!rootTrie)
+    int mode = STREAM_ANNOTATE;
+    if(argc > 0 && strcmp(argv[0], "replace") == 0) mode = STREAM_REPLACE;
+    else if(argc > 0 && strcmp(argv[0], "annotate") != 0)
     {
-        printf("Failed to allocate memory for root Trie.\n");
-        // Consider exiting or handling this critical failure appropriately
+        fprintf(stderr, "usage: program rewrite [annotate|replace] [input] [output]\n");
+        return 1;
+    }
+
+    FILE *in = argc > 1 && strcmp(argv[1], "-") != 0 ? fopen(argv[1], "rb") : stdin;
+    FILE *out = argc > 2 && strcmp(argv[2], "-") != 0 ? fopen(argv[2], "wb") : stdout;
+    if(!in || !out)
+    {
+        fprintf(stderr, "Failed to open %s.\n", !in ? argv[1] : argv[2]);
+        if(in && in != stdin) fclose(in);
+        return 1;
+    }
+
+    StreamStats stats;
+    int ok = streamRewrite(dict, in, out, mode, &stats);
+    fprintf(stderr, "%llu bytes, %llu words, %llu found in dictionary\n",
+            (unsigned long long)stats.bytesIn, (unsigned long long)stats.tokens,
+            (unsigned long long)stats.matched);
+    if(!ok) fprintf(stderr, "Rewrite failed.\n");
+
+    if(in != stdin) fclose(in);
+    if(out != stdout && fclose(out) != 0) ok = 0;
+    return ok ? 0 : 1;
+}
+
+// program batch [file perintah] [perintah per batch]
+// Tanpa nama file (atau "-") perintah dibaca dari stdin (lihat batch.c).
+static int batch(Dictionary *dict, int argc, char **argv)
+{
+    FILE *in = argc > 0 && strcmp(argv[0], "-") != 0 ? fopen(argv[0], "r") : stdin;
+    if(!in)
+    {
+        fprintf(stderr, "Failed to open %s.\n", argv[0]);
         return 1;
     }
+    size_t batchSize = argc > 1 ? strtoul(argv[1], NULL, 10) : BATCH_COMMANDS;
 
-    loadFromFileSynonym(SYNONYM_FILE);
-    loadFromFileHistory(HISTORY_FILE);
-    menu();
-    freeMemorySynonym();
-    freeHistory();
-    freeTrieNode(rootTrie);
+    int ok = runBatch(dict, in, stdout, batchSize);
+    if(in != stdin) fclose(in);
+    return ok ? 0 : 1;
+}
+
+// program stats: bentuk struktur dan memori kamus setelah load
+static int stats(Dictionary *dict)
+{
+    printStats(dict, stdout);
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char **argv)
+{
+    Dictionary *dict = dictionaryCreate(SYNONYM_FILE, HISTORY_FILE);
+    if(!dict)
+    {
+        printf("Failed to allocate memory for dictionary.\n");
+        // Consider exiting or handling this critical failure appropriately
+        return 1;
+    }
+
+    loadDictionary(dict);
+    walOpen(dict);
+
+    int status = 0;
+    if(argc > 1 && strcmp(argv[1], "rewrite") == 0) status = rewrite(dict, argc - 2, argv + 2);
+    else if(argc > 1 && strcmp(argv[1], "batch") == 0) status = batch(dict, argc - 2, argv + 2);
+    else if(argc > 1 && strcmp(argv[1], "stats") == 0) status = stats(dict);
+    else menu(dict);
+
+    walClose(dict);
+    dictionaryFree(dict);
+    return status;
+}
@@ -0,0 +1,884 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "dictionary_private.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+// Snapshot biner kamus: header, tabel string, tabel entry, tabel sinonim
+// (index string), index string per posisi hash, entry milik tiap string,
+// teks semua string, lalu checksum per blok. Semua tabel berukuran
+// kelipatan 4/8 byte dan diletakkan berurutan, jadi tiap tabel tetap
+// ter-align.
+//
+// Kamus kosong (kasus biasa saat startup) tidak diisi dari snapshot sama
+// sekali: file di-mmap dan findWord langsung mencari di tabelnya (lihat
+// snapshotFindWord), jadi load hanya memeriksa header dan tabel checksum
+// blok. Isi file baru dicek per blok SNAPSHOT_BLOCK byte saat blok itu
+// pertama kali dibaca. WordEntry kata snapshot diisi saat kata itu pertama
+// dipakai; kata yang ditambahkan sesudahnya masuk hash table seperti biasa,
+// dan trie ditunda sampai pertama dipakai (lihat trieReady).
+
+static const char snapshotMagic[8] = {'S', 'Y', 'N', 'S', 'N', 'A', 'P', '\0'};
+
+typedef struct SnapshotChecksum
+{
+    uint64_t hash;
+    uint64_t length;
+    unsigned char tail[8];
+    size_t tailLen;
+} SnapshotChecksum;
+
+static void checksumInit(SnapshotChecksum *c)
+{
+    c->hash = 0xcbf29ce484222325ULL;
+    c->length = 0;
+    c->tailLen = 0;
+}
+
+static void checksumMix(SnapshotChecksum *c, uint64_t word)
+{
+    c->hash = (c->hash ^ word) * 0x100000001b3ULL;
+    c->hash ^= c->hash >> 29;
+}
+
+// FNV-1a yang membaca 8 byte sekaligus, cukup cepat untuk file ratusan MB
+static void checksumUpdate(SnapshotChecksum *c, const void *data, size_t size)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    c->length += size;
+    while(size)
+    {
+        if(c->tailLen || size < 8)
+        {
+            c->tail[c->tailLen++] = *p++;
+            size--;
+            if(c->tailLen == 8)
+            {
+                uint64_t word;
+                memcpy(&word, c->tail, 8);
+                checksumMix(c, word);
+                c->tailLen = 0;
+            }
+            continue;
+        }
+
+        uint64_t word;
+        memcpy(&word, p, 8);
+        checksumMix(c, word);
+        p += 8;
+        size -= 8;
+    }
+}
+
+static uint64_t checksumFinal(SnapshotChecksum *c)
+{
+    if(c->tailLen)
+    {
+        uint64_t word = 0;
+        memcpy(&word, c->tail, c->tailLen);
+        checksumMix(c, word);
+        c->tailLen = 0;
+    }
+    checksumMix(c, c->length);
+    return c->hash;
+}
+
+static uint64_t blockChecksum(const void *data, size_t size)
+{
+    SnapshotChecksum c;
+    checksumInit(&c);
+    checksumUpdate(&c, data, size);
+    return checksumFinal(&c);
+}
+
+int isSnapshotFile(const char *filename)
+{
+    size_t len = strlen(filename), extLen = strlen(SNAPSHOT_EXT);
+    return len >= extLen && strcmp(filename + len - extLen, SNAPSHOT_EXT) == 0;
+}
+
+// Snapshot hanya dipakai jika tidak lebih tua dari file teks, supaya
+// file teks yang diedit manual tetap terbaca
+int snapshotIsFresh(const char *snapshotFile, const char *textFile)
+{
+    struct stat snap, text;
+    if(stat(snapshotFile, &snap) != 0) return 0;
+    if(stat(textFile, &text) != 0) return 1;
+    return snap.st_mtime >= text.st_mtime;
+}
+
+// Kumpulan string unik selama menulis snapshot. String kamus sudah
+// ter-intern, jadi cukup dibedakan menurut pointernya.
+typedef struct SnapshotBuilder
+{
+    const char **keys;      // tabel pointer -> index (open addressing)
+    uint32_t *indexes;
+    size_t mapSize;
+    const char **strings;   // urutan string di snapshot
+    SnapshotString *table;
+    size_t stringCount, stringCap, tableCap;
+    SnapshotEntry *entries;
+    size_t entryCount, entryCap;
+    uint32_t *synonyms;
+    size_t synonymCount, synonymCap;
+    uint32_t *buckets;      // index string pertama per posisi hash, bucketCount + 1
+    size_t bucketCount;
+    uint32_t *entryOf;      // per string
+    uint64_t textSize;
+} SnapshotBuilder;
+
+static int reserveItems(void **items, size_t *cap, size_t needed, size_t itemSize)
+{
+    if(needed <= *cap) return 1;
+
+    size_t newCap = *cap ? *cap : 64;
+    while(newCap < needed) newCap *= 2;
+    void *grown = realloc(*items, newCap * itemSize);
+    if(!grown) return 0;
+    *items = grown;
+    *cap = newCap;
+    return 1;
+}
+
+static size_t pointerSlot(const char *str, size_t mask)
+{
+    return (size_t)(((uintptr_t)str >> 3) * 0x9E3779B97F4A7C15ULL) & mask;
+}
+
+static int growBuilderMap(SnapshotBuilder *b)
+{
+    size_t newSize = b->mapSize ? b->mapSize << 1 : 1024;
+    const char **keys = (const char **)calloc(newSize, sizeof(const char *));
+    uint32_t *indexes = (uint32_t *)malloc(newSize * sizeof(uint32_t));
+    if(!keys || !indexes)
+    {
+        free(keys);
+        free(indexes);
+        return 0;
+    }
+
+    for(size_t i = 0; i < b->mapSize; i++)
+    {
+        if(!b->keys[i]) continue;
+        size_t j = pointerSlot(b->keys[i], newSize - 1);
+        while(keys[j]) j = (j + 1) & (newSize - 1);
+        keys[j] = b->keys[i];
+        indexes[j] = b->indexes[i];
+    }
+
+    free(b->keys);
+    free(b->indexes);
+    b->keys = keys;
+    b->indexes = indexes;
+    b->mapSize = newSize;
+    return 1;
+}
+
+// Index string di snapshot; string baru ditambahkan ke tabel
+static uint32_t builderString(SnapshotBuilder *b, const char *str, int *ok)
+{
+    if(!str) return SNAPSHOT_NONE;
+    if(b->stringCount + 1 > b->mapSize / 2 && !growBuilderMap(b))
+    {
+        *ok = 0;
+        return SNAPSHOT_NONE;
+    }
+
+    size_t mask = b->mapSize - 1;
+    size_t i = pointerSlot(str, mask);
+    while(b->keys[i])
+    {
+        if(b->keys[i] == str) return b->indexes[i];
+        i = (i + 1) & mask;
+    }
+
+    if(b->stringCount >= SNAPSHOT_NONE ||
+       !reserveItems((void **)&b->strings, &b->stringCap, b->stringCount + 1, sizeof(const char *)) ||
+       !reserveItems((void **)&b->table, &b->tableCap, b->stringCount + 1, sizeof(SnapshotString)))
+    {
+        *ok = 0;
+        return SNAPSHOT_NONE;
+    }
+
+    size_t len = strlen(str);
+    if(b->textSize + len + 1 > UINT32_MAX)
+    {
+        *ok = 0;
+        return SNAPSHOT_NONE;
+    }
+
+    uint32_t index = (uint32_t)b->stringCount++;
+    b->strings[index] = str;
+    b->table[index].offset = (uint32_t)b->textSize;
+    b->table[index].hash = hash(str);
+    b->textSize += len + 1;
+
+    b->keys[i] = str;
+    b->indexes[i] = index;
+    return index;
+}
+
+static void freeBuilder(SnapshotBuilder *b)
+{
+    free(b->keys);
+    free(b->indexes);
+    free(b->strings);
+    free(b->table);
+    free(b->entries);
+    free(b->synonyms);
+    free(b->buckets);
+    free(b->entryOf);
+}
+
+// Susun ulang tabel string menurut posisi hash-nya (ukuran string pool
+// untuk sebanyak itu string), jadi string dengan posisi yang sama
+// berdampingan dan b->buckets cukup menyimpan awal tiap posisi. Kalau kamus
+// digabung (mergeSnapshot), internAdopt juga mengisi pool hampir berurutan.
+static int orderStrings(SnapshotBuilder *b)
+{
+    size_t mask = stringPoolSizeFor(b->stringCount) - 1;
+    uint32_t *slotStart = (uint32_t *)calloc(mask + 2, sizeof(uint32_t));
+    b->buckets = (uint32_t *)malloc((mask + 2) * sizeof(uint32_t));
+    b->bucketCount = mask + 1;
+    uint32_t *newIndex = (uint32_t *)malloc((b->stringCount ? b->stringCount : 1) * sizeof(uint32_t));
+    const char **strings = (const char **)malloc((b->stringCount ? b->stringCount : 1) * sizeof(const char *));
+    SnapshotString *table = (SnapshotString *)malloc((b->stringCount ? b->stringCount : 1) * sizeof(SnapshotString));
+    if(!slotStart || !newIndex || !strings || !table || !b->buckets)
+    {
+        free(slotStart);
+        free(newIndex);
+        free(strings);
+        free(table);
+        return 0;
+    }
+
+    // counting sort menurut mixHash(hash) & mask, posisi awalnya di pool
+    for(size_t i = 0; i < b->stringCount; i++) slotStart[(mixHash(b->table[i].hash) & mask) + 1]++;
+    for(size_t s = 0; s <= mask; s++) slotStart[s + 1] += slotStart[s];
+    memcpy(b->buckets, slotStart, (mask + 2) * sizeof(uint32_t));
+    for(size_t i = 0; i < b->stringCount; i++) newIndex[i] = slotStart[mixHash(b->table[i].hash) & mask]++;
+
+    uint64_t textSize = 0;
+    for(size_t i = 0; i < b->stringCount; i++)
+    {
+        strings[newIndex[i]] = b->strings[i];
+        table[newIndex[i]].hash = b->table[i].hash;
+    }
+    for(size_t i = 0; i < b->stringCount; i++)
+    {
+        table[i].offset = (uint32_t)textSize;
+        textSize += strlen(strings[i]) + 1;
+    }
+
+    for(size_t i = 0; i < b->entryCount; i++)
+    {
+        b->entries[i].word = newIndex[b->entries[i].word];
+        if(b->entries[i].trieKey != SNAPSHOT_NONE) b->entries[i].trieKey = newIndex[b->entries[i].trieKey];
+    }
+    for(size_t i = 0; i < b->synonymCount; i++) b->synonyms[i] = newIndex[b->synonyms[i]];
+
+    free(b->strings);
+    free(b->table);
+    b->strings = strings;
+    b->table = table;
+    b->stringCap = b->tableCap = b->stringCount;
+    free(slotStart);
+    free(newIndex);
+    return 1;
+}
+
+// Entry yang kata utamanya string i, untuk lookup kata dari file
+static int indexEntries(SnapshotBuilder *b)
+{
+    b->entryOf = (uint32_t *)malloc((b->stringCount ? b->stringCount : 1) * sizeof(uint32_t));
+    if(!b->entryOf) return 0;
+    memset(b->entryOf, 0xFF, b->stringCount * sizeof(uint32_t));
+    for(size_t i = 0; i < b->entryCount; i++) b->entryOf[b->entries[i].word] = (uint32_t)i;
+    return 1;
+}
+
+// Kumpulkan seluruh kamus ke tabel-tabel snapshot. Entry ditulis terurut
+// menurut kunci trie (wordIterNext) supaya saat load trie dibangun dari kiri
+// ke kanan dan jalur yang sama masih ada di cache. Kata dari snapshot yang
+// sedang dipakai ikut diisi di sini; jika ada bagiannya yang rusak,
+// snapshot baru tidak ditulis supaya kata itu tidak hilang diam-diam.
+static int buildSnapshot(Dictionary *dict, SnapshotBuilder *b)
+{
+    size_t count = dictionaryWordCount(dict);
+    if(!reserveItems((void **)&b->entries, &b->entryCap, count, sizeof(SnapshotEntry))) return 0;
+
+    WordIter it;
+    wordIterInit(dict, &it);
+    WordEntry *entry;
+    int ok = 1;
+    while(ok && b->entryCount < count && (entry = wordIterNext(dict, &it)))
+    {
+        SnapshotEntry *out = &b->entries[b->entryCount++];
+        out->word = builderString(b, entry->word, &ok);
+        out->trieKey = builderString(b, trieKeyOf(dict, entry->word), &ok);
+        out->synonymStart = (uint32_t)b->synonymCount;
+        out->synonymCount = 0;
+
+        SynonymIter syn;
+        synonymIterInit(entry, &syn);
+        for(const char *synonym; ok && (synonym = synonymNext(&syn));)
+        {
+            uint32_t index = builderString(b, synonym, &ok);
+            if(!ok || b->synonymCount >= SNAPSHOT_NONE ||
+               !reserveItems((void **)&b->synonyms, &b->synonymCap, b->synonymCount + 1, sizeof(uint32_t)))
+                ok = 0;
+            else
+            {
+                b->synonyms[b->synonymCount++] = index;
+                out->synonymCount++;
+            }
+        }
+    }
+    ok = ok && !it.failed && !snapshotDamaged(dict);
+    wordIterFree(&it);
+    return ok && orderStrings(b) && indexEntries(b);
+}
+
+// Seluruh isi file snapshot dalam satu buffer malloc sebesar *size byte;
+// NULL jika gagal. generation adalah generasi log terakhir yang sudah ada
+// di kamus (lihat wal.c), 0 jika tidak diketahui.
+char *snapshotImage(Dictionary *dict, uint64_t generation, size_t *size)
+{
+    SnapshotBuilder b = {0};
+    if(!buildSnapshot(dict, &b))
+    {
+        freeBuilder(&b);
+        return NULL;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.stringCount = b.stringCount;
+    header.entryCount = b.entryCount;
+    header.synonymCount = b.synonymCount;
+    header.bucketCount = b.bucketCount;
+    header.stringsOffset = sizeof(SnapshotHeader);
+    header.entriesOffset = header.stringsOffset + b.stringCount * sizeof(SnapshotString);
+    header.synonymsOffset = header.entriesOffset + b.entryCount * sizeof(SnapshotEntry);
+    header.bucketsOffset = header.synonymsOffset + b.synonymCount * sizeof(uint32_t);
+    header.entryOfOffset = header.bucketsOffset + (b.bucketCount + 1) * sizeof(uint32_t);
+    header.textOffset = header.entryOfOffset + b.stringCount * sizeof(uint32_t);
+    header.textSize = b.textSize;
+    header.blockSumsOffset = (header.textOffset + b.textSize + 7) & ~(uint64_t)7;
+    header.blockCount = (header.blockSumsOffset - header.headerSize + SNAPSHOT_BLOCK - 1) / SNAPSHOT_BLOCK;
+    header.fileSize = header.blockSumsOffset + header.blockCount * sizeof(uint64_t);
+    header.generation = generation;
+
+    char *image = (char *)calloc(1, (size_t)header.fileSize);
+    if(image)
+    {
+        memcpy(image + header.stringsOffset, b.table, b.stringCount * sizeof(SnapshotString));
+        memcpy(image + header.entriesOffset, b.entries, b.entryCount * sizeof(SnapshotEntry));
+        memcpy(image + header.synonymsOffset, b.synonyms, b.synonymCount * sizeof(uint32_t));
+        memcpy(image + header.bucketsOffset, b.buckets, (b.bucketCount + 1) * sizeof(uint32_t));
+        memcpy(image + header.entryOfOffset, b.entryOf, b.stringCount * sizeof(uint32_t));
+        for(size_t i = 0; i < b.stringCount; i++)
+            memcpy(image + header.textOffset + b.table[i].offset, b.strings[i], strlen(b.strings[i]) + 1);
+
+        uint64_t *sums = (uint64_t *)(image + header.blockSumsOffset);
+        uint64_t covered = header.blockSumsOffset - header.headerSize;
+        for(uint64_t i = 0; i < header.blockCount; i++)
+        {
+            uint64_t size = covered - i * SNAPSHOT_BLOCK < SNAPSHOT_BLOCK ? covered - i * SNAPSHOT_BLOCK : SNAPSHOT_BLOCK;
+            sums[i] = blockChecksum(image + header.headerSize + i * SNAPSHOT_BLOCK, (size_t)size);
+        }
+        header.checksum = blockChecksum(sums, (size_t)header.blockCount * sizeof(uint64_t));
+        memcpy(image, &header, sizeof(header));
+        *size = (size_t)header.fileSize;
+    }
+
+    freeBuilder(&b);
+    return image;
+}
+
+// Tulis snapshot ke file sementara lalu rename, jadi snapshot lama
+// (yang mungkin sedang di-mmap) tidak pernah terlihat setengah jadi
+int saveSnapshot(Dictionary *dict, const char *filename)
+{
+    size_t size;
+    char *image = snapshotImage(dict, 0, &size);
+    if(!image) return 0;
+    int ok = writeReplacement(filename, image, size);
+    free(image);
+    return ok;
+}
+
+// Tulis file teks (format saveToFileSynonym) dari hasil snapshotImage,
+// tanpa menyentuh kamus. Urutan kata dan sinonimnya sama persis.
+int saveSnapshotText(const char *image, const char *filename)
+{
+    const SnapshotHeader *header = (const SnapshotHeader *)image;
+    const SnapshotString *strings = (const SnapshotString *)(image + header->stringsOffset);
+    const SnapshotEntry *entries = (const SnapshotEntry *)(image + header->entriesOffset);
+    const uint32_t *synonyms = (const uint32_t *)(image + header->synonymsOffset);
+    const char *text = image + header->textOffset;
+
+    char *tmpName;
+    FILE *file = openReplacement(filename, &tmpName);
+    if(!file) return 0;
+    for(uint64_t i = 0; i < header->entryCount; i++)
+    {
+        const SnapshotEntry *entry = &entries[i];
+        fprintf(file, "%s :", text + strings[entry->word].offset);
+        for(uint32_t s = 0; s < entry->synonymCount; s++)
+            fprintf(file, s ? ", %s" : " %s", text + strings[synonyms[entry->synonymStart + s]].offset);
+        fputc('\n', file);
+    }
+    return commitReplacement(file, tmpName, filename, !ferror(file));
+}
+
+// Pastikan count item berukuran itemSize mulai dari offset ada di antara start dan end
+static int sectionFits(uint64_t offset, uint64_t count, size_t itemSize, uint64_t start, uint64_t end)
+{
+    if(offset < start || offset > end || offset % (itemSize < 8 ? itemSize : 8) != 0) return 0;
+    return count <= (end - offset) / itemSize;
+}
+
+// Cek header dan tabel checksum blok lalu isi idx dengan tabel-tabel di
+// dalam file. Isi tabelnya belum dicek; itu dilakukan per blok saat dibaca
+// (verifyRange), jadi biayanya tidak bergantung pada ukuran kamus.
+static int openIndex(const MappedFile *file, SnapshotIndex *idx)
+{
+    memset(idx, 0, sizeof(*idx));
+    if(file->size < sizeof(SnapshotHeader)) return 0;
+
+    const SnapshotHeader *h = (const SnapshotHeader *)file->data;
+    if(memcmp(h->magic, snapshotMagic, sizeof(h->magic)) != 0 ||
+       h->version != SNAPSHOT_VERSION || h->headerSize != sizeof(SnapshotHeader) ||
+       h->fileSize != file->size)
+        return 0;
+
+    // semua tabel harus berada di daerah yang dicek per blok
+    uint64_t covered = h->blockSumsOffset;
+    if(!sectionFits(h->blockSumsOffset, h->blockCount, sizeof(uint64_t), h->headerSize, file->size) ||
+       h->blockCount != (covered - h->headerSize + SNAPSHOT_BLOCK - 1) / SNAPSHOT_BLOCK ||
+       h->bucketCount == 0 || (h->bucketCount & (h->bucketCount - 1)) != 0 || h->bucketCount >= SNAPSHOT_NONE ||
+       !sectionFits(h->stringsOffset, h->stringCount, sizeof(SnapshotString), h->headerSize, covered) ||
+       !sectionFits(h->entriesOffset, h->entryCount, sizeof(SnapshotEntry), h->headerSize, covered) ||
+       !sectionFits(h->synonymsOffset, h->synonymCount, sizeof(uint32_t), h->headerSize, covered) ||
+       !sectionFits(h->bucketsOffset, h->bucketCount + 1, sizeof(uint32_t), h->headerSize, covered) ||
+       !sectionFits(h->entryOfOffset, h->stringCount, sizeof(uint32_t), h->headerSize, covered) ||
+       !sectionFits(h->textOffset, h->textSize, 1, h->headerSize, covered) ||
+       h->stringCount >= SNAPSHOT_NONE || h->entryCount >= SNAPSHOT_NONE || h->synonymCount >= SNAPSHOT_NONE)
+        return 0;
+
+    const uint64_t *sums = (const uint64_t *)(file->data + h->blockSumsOffset);
+    if(blockChecksum(sums, (size_t)h->blockCount * sizeof(uint64_t)) != h->checksum) return 0;
+
+    // teks diakhiri '\0', jadi setiap offset di dalam teks adalah string yang
+    // bisa dibaca sampai ujungnya sebelum bloknya dicek
+    const char *text = file->data + h->textOffset;
+    if(h->stringCount && (h->textSize == 0 || text[h->textSize - 1] != '\0')) return 0;
+
+    idx->strings = (const SnapshotString *)(file->data + h->stringsOffset);
+    idx->entries = (const SnapshotEntry *)(file->data + h->entriesOffset);
+    idx->synonyms = (const uint32_t *)(file->data + h->synonymsOffset);
+    idx->buckets = (const uint32_t *)(file->data + h->bucketsOffset);
+    idx->entryOf = (const uint32_t *)(file->data + h->entryOfOffset);
+    idx->text = text;
+    idx->blocks = file->data + h->headerSize;
+    idx->blockSums = sums;
+    idx->stringCount = h->stringCount;
+    idx->entryCount = h->entryCount;
+    idx->synonymCount = h->synonymCount;
+    idx->bucketCount = h->bucketCount;
+    idx->textSize = h->textSize;
+    idx->blockCount = h->blockCount;
+    idx->checked = (uint64_t *)calloc((size_t)(h->blockCount + 63) / 64 + 1, sizeof(uint64_t));
+    return idx->checked != NULL;
+}
+
+// Catat kerusakan sekali saja; kata di bagian yang rusak dianggap tidak ada
+static void markDamaged(SnapshotIndex *idx)
+{
+    if(!__atomic_exchange_n(&idx->damaged, 1, __ATOMIC_ACQ_REL))
+        fprintf(stderr, "The loaded snapshot is damaged; words stored in the damaged part are missing "
+                        "and the dictionary will not be saved over it.\n");
+}
+
+// Cek checksum blok yang memuat size byte mulai dari start, masing-masing
+// paling banyak sekali. Aman dipanggil banyak pembaca bersamaan: dua thread
+// yang mengecek blok yang sama hanya menghitung checksum yang sama dua kali.
+static int verifyRange(SnapshotIndex *idx, const void *start, size_t size)
+{
+    if(size == 0 || LOAD_ACQUIRE(&idx->allChecked)) return 1;
+
+    size_t offset = (size_t)((const char *)start - idx->blocks);
+    size_t covered = (size_t)((const char *)idx->blockSums - idx->blocks);
+    for(size_t b = offset / SNAPSHOT_BLOCK; b <= (offset + size - 1) / SNAPSHOT_BLOCK; b++)
+    {
+        uint64_t bit = 1ULL << (b & 63);
+        if(__atomic_load_n(&idx->checked[b / 64], __ATOMIC_ACQUIRE) & bit) continue;
+
+        size_t from = b * SNAPSHOT_BLOCK;
+        size_t length = covered - from < SNAPSHOT_BLOCK ? covered - from : SNAPSHOT_BLOCK;
+        if(blockChecksum(idx->blocks + from, length) != idx->blockSums[b])
+        {
+            markDamaged(idx);
+            return 0;
+        }
+        __atomic_fetch_or(&idx->checked[b / 64], bit, __ATOMIC_RELEASE);
+    }
+    return 1;
+}
+
+// Cek semua blok sekaligus, sebelum kata snapshot dijalani semuanya:
+// membaca file berurutan sekali lebih murah daripada mengecek tiap string
+// di tempat acak, dan sesudahnya mappedString tidak perlu strlen lagi
+static void verifyAll(SnapshotIndex *idx)
+{
+    size_t covered = (size_t)((const char *)idx->blockSums - idx->blocks);
+    if(!LOAD_ACQUIRE(&idx->allChecked) && verifyRange(idx, idx->blocks, covered))
+        STORE_RELEASE(&idx->allChecked, 1);
+}
+
+// String ke-i yang sudah dicek, NULL jika rusak
+static const char *mappedString(SnapshotIndex *idx, uint32_t i)
+{
+    if(i >= idx->stringCount || !verifyRange(idx, &idx->strings[i], sizeof(SnapshotString))) return NULL;
+
+    uint32_t offset = idx->strings[i].offset;
+    if(offset >= idx->textSize)
+    {
+        markDamaged(idx);
+        return NULL;
+    }
+    const char *str = idx->text + offset;
+    return LOAD_ACQUIRE(&idx->allChecked) || verifyRange(idx, str, strlen(str) + 1) ? str : NULL;
+}
+
+// Index string str di snapshot, SNAPSHOT_NONE jika tidak ada. String
+// dengan posisi hash yang sama berdampingan di tabel string, jadi cukup
+// membaca satu rentang.
+static uint32_t findMappedString(SnapshotIndex *idx, const char *str, unsigned int h)
+{
+    if(!idx->stringCount) return SNAPSHOT_NONE;
+
+    size_t home = mixHash(h) & (idx->bucketCount - 1);
+    if(!verifyRange(idx, &idx->buckets[home], 2 * sizeof(uint32_t))) return SNAPSHOT_NONE;
+    uint32_t first = idx->buckets[home], last = idx->buckets[home + 1];
+    if(first > last || last > idx->stringCount)
+    {
+        markDamaged(idx);
+        return SNAPSHOT_NONE;
+    }
+    if(!verifyRange(idx, &idx->strings[first], (last - first) * sizeof(SnapshotString))) return SNAPSHOT_NONE;
+
+    for(uint32_t i = first; i < last; i++)
+    {
+        if(idx->strings[i].hash != h) continue;
+        const char *candidate = mappedString(idx, i);
+        if(candidate && strcmp(candidate, str) == 0) return i;
+    }
+    return SNAPSHOT_NONE;
+}
+
+// Entry snapshot yang kata utamanya word, SNAPSHOT_NONE jika tidak ada
+static uint32_t findMappedEntry(SnapshotIndex *idx, const char *word, unsigned int h)
+{
+    uint32_t s = findMappedString(idx, word, h);
+    if(s == SNAPSHOT_NONE || !verifyRange(idx, &idx->entryOf[s], sizeof(uint32_t))) return SNAPSHOT_NONE;
+
+    uint32_t e = idx->entryOf[s];
+    if(e != SNAPSHOT_NONE && e >= idx->entryCount)
+    {
+        markDamaged(idx);
+        return SNAPSHOT_NONE;
+    }
+    return e;
+}
+
+// Isi WordEntry milik entry ke-i dari tabelnya di file. Sinonim disimpan
+// dari yang terbaru, jadi ditambahkan dari belakang supaya urutan bacanya
+// sama seperti saat disimpan. 0 jika bagian file itu rusak.
+static int fillEntry(Dictionary *dict, size_t i)
+{
+    SnapshotIndex *idx = &dict->mapped;
+    const SnapshotEntry *e = &idx->entries[i];
+    if(!verifyRange(idx, e, sizeof(*e))) return 0;
+
+    const char *word = mappedString(idx, e->word);
+    if(!word || e->synonymStart > idx->synonymCount || e->synonymCount > idx->synonymCount - e->synonymStart)
+    {
+        markDamaged(idx);
+        return 0;
+    }
+    const uint32_t *synonyms = idx->synonyms + e->synonymStart;
+    if(!verifyRange(idx, synonyms, e->synonymCount * sizeof(uint32_t))) return 0;
+
+    // entry belum terlihat oleh thread lain, jadi tidak ada yang dipensiunkan
+    WordEntry *entry = &idx->words[i];
+    entry->word = word;
+    synonymReserve(dict, entry, e->synonymCount);
+    for(uint32_t j = e->synonymCount; j-- > 0;)
+    {
+        const char *synonym = mappedString(idx, synonyms[j]);
+        if(!synonym)
+        {
+            free(entry->synonyms);
+            memset(entry, 0, sizeof(*entry));
+            return 0;
+        }
+        synonymInsert(dict, entry, synonym);
+    }
+    return 1;
+}
+
+// WordEntry snapshot ke-i, diisi oleh thread pertama yang memakainya
+// (pembaca maupun penulis); NULL jika sudah dihapus atau rusak
+static WordEntry *mappedEntry(Dictionary *dict, size_t i)
+{
+    SnapshotIndex *idx = &dict->mapped;
+    unsigned char *state = &idx->state[i];
+    for(;;)
+    {
+        unsigned char current = LOAD_ACQUIRE(state);
+        if(current == SNAPSHOT_ENTRY_READY) return &idx->words[i];
+        if(current == SNAPSHOT_ENTRY_GONE) return NULL;
+        if(current == SNAPSHOT_ENTRY_NEW &&
+           __atomic_compare_exchange_n(state, &current, SNAPSHOT_ENTRY_BUSY, 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+        {
+            int ok = fillEntry(dict, i);
+            if(!ok) __atomic_fetch_sub(&idx->live, 1, __ATOMIC_RELAXED);
+            STORE_RELEASE(state, ok ? SNAPSHOT_ENTRY_READY : SNAPSHOT_ENTRY_GONE);
+        }
+        // selain itu thread lain sedang mengisinya, tunggu sebentar
+    }
+}
+
+// Kata utama dari snapshot yang sedang dilayani, NULL jika tidak ada.
+// Aturan pemanggilnya sama dengan hashTableFindHashed.
+WordEntry *snapshotFindWord(Dictionary *dict, const char *word, unsigned int h)
+{
+    if(!dict->mapped.words) return NULL;
+    uint32_t e = findMappedEntry(&dict->mapped, word, h);
+    return e == SNAPSHOT_NONE ? NULL : mappedEntry(dict, e);
+}
+
+// Lepas kata word dari snapshot dan kembalikan entry-nya. Memori entry
+// tetap milik snapshot (pembaca mungkin masih memegangnya), hanya tidak
+// bisa ditemukan lagi. Dipanggil dengan dictWriteBegin dipegang.
+WordEntry *snapshotRemoveWord(Dictionary *dict, const char *word, unsigned int h)
+{
+    if(!dict->mapped.words) return NULL;
+    uint32_t e = findMappedEntry(&dict->mapped, word, h);
+    WordEntry *entry = e == SNAPSHOT_NONE ? NULL : mappedEntry(dict, e);
+    if(!entry) return NULL;
+
+    STORE_RELEASE(&dict->mapped.state[e], SNAPSHOT_ENTRY_GONE);
+    __atomic_fetch_sub(&dict->mapped.live, 1, __ATOMIC_RELAXED);
+    return entry;
+}
+
+// Kata snapshot berikutnya yang masih ada, mulai dari *pos (awalnya 0),
+// sekaligus mengisinya; *key (jika tidak NULL) diisi kunci trie-nya. Dipakai
+// oleh hashTableNext dan trieReady, yang memang harus melihat semua kata.
+WordEntry *snapshotNextWord(Dictionary *dict, size_t *pos, const char **key)
+{
+    SnapshotIndex *idx = &dict->mapped;
+    if(*pos == 0 && idx->entryCount) verifyAll(idx);
+    while(*pos < idx->entryCount)
+    {
+        size_t i = (*pos)++;
+        WordEntry *entry = mappedEntry(dict, i);
+        if(!entry) continue;
+        if(key)
+        {
+            uint32_t trieKey = idx->entries[i].trieKey;
+            *key = trieKey == SNAPSHOT_NONE ? NULL : mappedString(idx, trieKey);
+        }
+        return entry;
+    }
+    return NULL;
+}
+
+// String di snapshot yang sama dengan str, NULL jika tidak ada. Dipakai
+// internString dan internFind supaya string yang sama selalu punya satu
+// pointer, baik sudah masuk pool maupun belum.
+const char *snapshotFindString(Dictionary *dict, const char *str, unsigned int h)
+{
+    SnapshotIndex *idx = &dict->mapped;
+    if(!idx->words) return NULL;
+    uint32_t s = findMappedString(idx, str, h);
+    return s == SNAPSHOT_NONE ? NULL : idx->text + idx->strings[s].offset;
+}
+
+size_t snapshotWordCount(Dictionary *dict)
+{
+    return __atomic_load_n(&dict->mapped.live, __ATOMIC_RELAXED);
+}
+
+int snapshotOwnsEntry(const Dictionary *dict, const WordEntry *entry)
+{
+    const SnapshotIndex *idx = &dict->mapped;
+    return idx->words && entry >= idx->words && entry < idx->words + idx->entryCount;
+}
+
+// 1 jika str ada di dalam snapshot yang di-mmap, bukan milik pool
+int snapshotOwnsString(const Dictionary *dict, const char *str)
+{
+    const MappedFile *file = &dict->snapshot;
+    return file->data && str >= file->data && str < file->data + file->size;
+}
+
+// 1 jika ada bagian snapshot yang rusak; kamus tidak boleh disimpan
+int snapshotDamaged(Dictionary *dict)
+{
+    return __atomic_load_n(&dict->mapped.damaged, __ATOMIC_ACQUIRE);
+}
+
+// Cek semua blok dan index sekaligus, untuk mergeSnapshot
+static int checkAll(SnapshotIndex *idx)
+{
+    verifyAll(idx);
+    if(!idx->allChecked) return 0;
+
+    for(uint64_t i = 0; i < idx->stringCount; i++)
+        if(idx->strings[i].offset >= idx->textSize) return 0;
+    for(uint64_t i = 0; i < idx->entryCount; i++)
+    {
+        const SnapshotEntry *e = &idx->entries[i];
+        if(e->word >= idx->stringCount || (e->trieKey != SNAPSHOT_NONE && e->trieKey >= idx->stringCount) ||
+           e->synonymStart > idx->synonymCount || e->synonymCount > idx->synonymCount - e->synonymStart)
+            return 0;
+    }
+    for(uint64_t i = 0; i < idx->synonymCount; i++)
+        if(idx->synonyms[i] >= idx->stringCount) return 0;
+    return 1;
+}
+
+// Gabungkan snapshot ke kamus yang sudah berisi: semua isinya dicek dulu,
+// jadi snapshot rusak tidak pernah meninggalkan kamus setengah terisi, lalu
+// disalin ke hash table seperti file teks. String tetap dipakai dari file.
+static int mergeSnapshot(Dictionary *dict, SnapshotIndex *idx)
+{
+    if(!checkAll(idx)) return 0;
+
+    const char **interned = (const char **)malloc((idx->stringCount ? idx->stringCount : 1) * sizeof(const char *));
+    if(!interned) return 0;
+    internReserve(dict, dict->strings.count + idx->stringCount);
+    for(uint64_t i = 0; i < idx->stringCount; i++)
+        interned[i] = internAdopt(dict, idx->text + idx->strings[i].offset, idx->strings[i].hash);
+
+    hashTableReserve(dict, dict->index.count + idx->entryCount);
+    for(uint64_t i = 0; i < idx->entryCount; i++)
+    {
+        const SnapshotEntry *e = &idx->entries[i];
+        const char *word = interned[e->word];
+        if(!word) continue;
+
+        WordEntry *entry = hashTableFindHashed(dict, word, idx->strings[e->word].hash);
+        if(!entry)
+        {
+            entry = (WordEntry *)slabAlloc(&dict->entrySlab);
+            if(!entry) break;
+            entry->word = word;
+            entry->synonyms = NULL;
+            entry->next = NULL;
+            entry->inlineCount = 0;
+            entry->inlineUsed = 0;
+            if(!hashTableInsertHashed(dict, entry, idx->strings[e->word].hash))
+            {
+                slabFree(&dict->entrySlab, entry);
+                continue;
+            }
+            insertTrieKey(dict, e->trieKey != SNAPSHOT_NONE ? interned[e->trieKey] : NULL, entry);
+        }
+
+        synonymReserve(dict, entry, e->synonymCount);
+        for(uint32_t j = e->synonymCount; j-- > 0;)
+            appendSynonym(dict, entry, interned[idx->synonyms[e->synonymStart + j]]);
+    }
+
+    free(interned);
+    free(idx->checked);
+    idx->checked = NULL;
+    return 1;
+}
+
+// Layani kamus kosong langsung dari snapshot: hanya array WordEntry dan
+// keadaannya yang dialokasikan (calloc, halamannya baru diisi saat dipakai)
+static int serveSnapshot(Dictionary *dict, SnapshotIndex *idx)
+{
+    size_t count = idx->entryCount ? (size_t)idx->entryCount : 1;
+    idx->words = (WordEntry *)calloc(count, sizeof(WordEntry));
+    idx->state = (unsigned char *)calloc(count, 1);
+    if(!idx->words || !idx->state)
+    {
+        free(idx->words);
+        free(idx->state);
+        return 0;
+    }
+    idx->live = idx->entryCount;
+    dict->mapped = *idx;
+    dict->triePending = idx->entryCount > 0;
+    return 1;
+}
+
+// Pakai snapshot untuk kamus. File tetap di-mmap sampai closeSnapshot
+// karena kata, sinonim dan label trie menunjuk langsung ke teks di dalamnya.
+int loadSnapshot(Dictionary *dict, const char *filename)
+{
+    if(dict->snapshot.data)
+    {
+        printf("Snapshot already loaded; %s ignored.\n", filename);
+        return 0;
+    }
+
+    MappedFile file;
+    if(!mapFile(filename, &file)) return 0;
+    SnapshotIndex idx;
+    if(!openIndex(&file, &idx))
+    {
+        free(idx.checked);
+        printf("Snapshot %s is invalid or from another version, ignored.\n", filename);
+        unmapFile(&file);
+        return 0;
+    }
+
+    // kamus kosong (kasus biasa saat startup) dilayani dari file; string
+    // yang sudah ada di pool harus tetap satu-satunya salinan, jadi kamus
+    // yang sudah berisi digabung
+    int serve = dict->index.count == 0 && dict->strings.count == 0;
+    if(!(serve ? serveSnapshot(dict, &idx) : mergeSnapshot(dict, &idx)))
+    {
+        free(idx.checked);
+        printf(serve ? "Failed to allocate memory for loading %s.\n"
+                     : "Snapshot %s is damaged or memory ran out, ignored.\n", filename);
+        unmapFile(&file);
+        return 0;
+    }
+
+    if(serve) dict->wordGeneration = ((const SnapshotHeader *)file.data)->generation;
+#ifndef _WIN32
+    // setelah load, isi file dibaca acak oleh lookup
+    if(file.mapped) madvise((void *)file.data, file.size, MADV_NORMAL);
+#endif
+    dict->snapshot = file;
+    return 1;
+}
+
+// Dipanggil setelah freeStringPool, saat tidak ada lagi yang menunjuk ke
+// snapshot. Entry yang dihapus sudah memensiunkan set sinonimnya sendiri.
+void closeSnapshot(Dictionary *dict)
+{
+    for(size_t i = 0; i < dict->mapped.entryCount; i++)
+        if(dict->mapped.state[i] == SNAPSHOT_ENTRY_READY) free(dict->mapped.words[i].synonyms);
+    free(dict->mapped.words);
+    free(dict->mapped.state);
+    free(dict->mapped.checked);
+    memset(&dict->mapped, 0, sizeof(dict->mapped));
+    if(dict->snapshot.data) unmapFile(&dict->snapshot);
+}
@@ -0,0 +1,439 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dictionary_private.h"
+
+// Statistik untuk mencari tahu kenapa kamus melambat: jumlah panggilan dan
+// histogram latensi per operasi, counter jalur panas (langkah rantai hash,
+// alokasi, ...), serta bentuk index, trie dan memori saat printStats.
+//
+// Setiap thread menulis ke shard miliknya sendiri dengan load/store biasa,
+// tanpa atomic read-modify-write, jadi pembaca yang berjalan bersamaan tidak
+// berebut cache line. printStats menjumlahkan semua shard; shard thread yang
+// selesai digabung ke retiredStats.
+//
+// Membaca jam lebih mahal dari satu lookup, jadi latensi findWord dan
+// findWords hanya diukur 1 dari SYNONYM_STATS_SAMPLE panggilan (default
+// STATS_SAMPLE, dibulatkan ke pangkat dua). Bahkan dua panggilan fungsi per
+// findWord sudah terlihat pada kamus besar, karena lookup yang berurutan
+// tidak lagi saling tumpang tindih di CPU; karena itu findWord hanya
+// menambah statsLookups milik thread-nya, dan langkah rantai index hanya
+// dihitung pada lookup yang diukur. Operasi lain selalu diukur, dan jumlah
+// panggilan selalu tepat. SYNONYM_STATS=0 mematikan semuanya saat runtime;
+// -DSYNONYM_NO_STATS membuangnya dari build, dan printStats hanya
+// menampilkan bentuk struktur.
+
+// Histogram log-linear: nilai di bawah 16 ns per nanodetik, di atasnya 8
+// bucket per pangkat dua (galat paling banyak 6%)
+#define LATENCY_BUCKETS (16 + 60 * 8)
+
+static const char *opNames[STATS_OPS] = {
+    "findWord", "findWords", "add word", "add synonym", "delete word", "delete synonym", "load", "save",
+};
+
+typedef struct StatsShard
+{
+    uint64_t calls[STATS_OPS];
+    uint64_t timed[STATS_OPS];
+    uint64_t totalNs[STATS_OPS];
+    uint64_t maxNs[STATS_OPS];
+    uint64_t latency[STATS_OPS][LATENCY_BUCKETS];
+    uint64_t counters[STATS_COUNTERS];
+    unsigned tick;              // findWords sejak sampel terakhir, hanya dibaca pemilik
+    const uint64_t *lookups;    // statsLookups milik thread pemilik
+    struct StatsShard *next;
+} StatsShard;
+
+// Pemilik shard satu-satunya penulis; printStats membaca bersamaan
+#define STAT_ADD(field, n) __atomic_store_n(&(field), (field) + (n), __ATOMIC_RELAXED)
+#define STAT_READ(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+
+static unsigned statsSample = STATS_SAMPLE;
+
+#ifndef SYNONYM_NO_STATS
+
+STATS_THREAD uint64_t statsLookups = UINT64_MAX;   // lookup pertama masuk jalur lambat
+STATS_THREAD int statsTracing;
+uint64_t statsLookupMask = STATS_SAMPLE - 1;
+
+static StatsShard *shards;          // shard thread yang masih berjalan
+static StatsShard retiredStats;     // jumlah dari thread yang sudah selesai
+static int statsOff;
+
+#ifndef _WIN32
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t statsOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t statsKey;
+static __thread StatsShard *localShard;
+#define STATS_LOCK() pthread_mutex_lock(&statsLock)
+#define STATS_UNLOCK() pthread_mutex_unlock(&statsLock)
+#else
+static int statsReady;
+static StatsShard *localShard;
+#define STATS_LOCK()
+#define STATS_UNLOCK()
+#endif
+
+static void mergeShard(StatsShard *into, const StatsShard *from)
+{
+    for(int op = 0; op < STATS_OPS; op++)
+    {
+        STAT_ADD(into->calls[op], STAT_READ(from->calls[op]));
+        STAT_ADD(into->timed[op], STAT_READ(from->timed[op]));
+        STAT_ADD(into->totalNs[op], STAT_READ(from->totalNs[op]));
+        uint64_t max = STAT_READ(from->maxNs[op]);
+        if(max > into->maxNs[op]) STAT_ADD(into->maxNs[op], max - into->maxNs[op]);
+        for(int b = 0; b < LATENCY_BUCKETS; b++) STAT_ADD(into->latency[op][b], STAT_READ(from->latency[op][b]));
+    }
+    for(int c = 0; c < STATS_COUNTERS; c++) STAT_ADD(into->counters[c], STAT_READ(from->counters[c]));
+    if(from->lookups) STAT_ADD(into->calls[STATS_FIND], STAT_READ(*from->lookups) + 1);
+}
+
+#ifndef _WIN32
+// Thread selesai: angkanya dipindah ke retiredStats
+static void retireShard(void *arg)
+{
+    StatsShard *shard = (StatsShard *)arg;
+    STATS_LOCK();
+    StatsShard **link = &shards;
+    while(*link && *link != shard) link = &(*link)->next;
+    if(*link) *link = shard->next;
+    mergeShard(&retiredStats, shard);
+    STATS_UNLOCK();
+    free(shard);
+}
+#endif
+
+static void statsSetup(void)
+{
+    const char *env = getenv("SYNONYM_STATS");
+    int off = env && strcmp(env, "0") == 0;
+    env = getenv("SYNONYM_STATS_SAMPLE");
+    if(env && atoi(env) > 0)
+    {
+        statsSample = 1;
+        while(statsSample < (unsigned)atoi(env) && statsSample < (1u << 30)) statsSample *= 2;
+        __atomic_store_n(&statsLookupMask, statsSample - 1, __ATOMIC_RELAXED);
+    }
+#ifndef _WIN32
+    if(pthread_key_create(&statsKey, retireShard) != 0) off = 1;
+#endif
+    __atomic_store_n(&statsOff, off, __ATOMIC_RELAXED);
+}
+
+// Shard thread ini, dibuat saat pertama dipakai; NULL jika statistik mati
+static StatsShard *statsShard(void)
+{
+    if(localShard) return localShard;
+    // sudah diketahui mati: jangan lewat pthread_once di setiap lookup
+    if(__atomic_load_n(&statsOff, __ATOMIC_RELAXED)) return NULL;
+#ifndef _WIN32
+    pthread_once(&statsOnce, statsSetup);
+#else
+    if(!statsReady)
+    {
+        statsSetup();
+        statsReady = 1;
+    }
+#endif
+    if(statsOff) return NULL;
+
+    StatsShard *shard = (StatsShard *)calloc(1, sizeof(StatsShard));
+    if(!shard) return NULL;
+    shard->lookups = &statsLookups;
+    STATS_LOCK();
+    shard->next = shards;
+    shards = shard;
+    STATS_UNLOCK();
+#ifndef _WIN32
+    pthread_setspecific(statsKey, shard);
+#endif
+    localShard = shard;
+    return shard;
+}
+
+static uint64_t statsNow(void)
+{
+    struct timespec ts;
+#ifndef _WIN32
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static unsigned latencyBucket(uint64_t ns)
+{
+    if(ns < 16) return (unsigned)ns;
+    unsigned e = 63 - (unsigned)__builtin_clzll(ns);
+    return 16 + (e - 4) * 8 + (unsigned)((ns >> (e - 3)) & 7);
+}
+
+// Hitung satu panggilan op. Mengembalikan waktu mulai jika panggilan ini
+// diukur, 0 jika tidak.
+uint64_t statsStart(int op)
+{
+    StatsShard *shard = statsShard();
+    if(!shard) return 0;
+    STAT_ADD(shard->calls[op], 1);
+    if(op == STATS_FIND_BATCH)
+    {
+        if(++shard->tick < statsSample) return 0;
+        shard->tick = 0;
+    }
+    return statsNow();
+}
+
+// findWord yang kena giliran diukur (lihat statsLookupStart); jumlahnya
+// sudah ada di statsLookups
+uint64_t statsSampleLookup(void)
+{
+    if(!statsShard()) return 0;
+    statsTracing = 1;
+    return statsNow();
+}
+
+void statsEnd(int op, uint64_t start)
+{
+    uint64_t ns = statsNow() - start;
+    statsTracing = 0;
+    StatsShard *shard = localShard;
+    STAT_ADD(shard->timed[op], 1);
+    STAT_ADD(shard->totalNs[op], ns);
+    if(ns > shard->maxNs[op]) STAT_ADD(shard->maxNs[op], ns - shard->maxNs[op]);
+    STAT_ADD(shard->latency[op][latencyBucket(ns)], 1);
+}
+
+void statsCount(int counter, uint64_t n)
+{
+    StatsShard *shard = statsShard();
+    if(shard) STAT_ADD(shard->counters[counter], n);
+}
+
+// Satu penelusuran rantai index dengan steps perbandingan, hanya selama
+// findWord yang diukur
+void statsWalk(uint64_t steps)
+{
+    StatsShard *shard = statsShard();
+    if(!shard) return;
+    STAT_ADD(shard->counters[STATS_CHAIN_WALKS], 1);
+    STAT_ADD(shard->counters[STATS_CHAIN_STEPS], steps);
+}
+
+// Jumlah semua shard ke total; 0 jika statistik mati
+static int collectStats(StatsShard *total)
+{
+    if(!statsShard()) return 0;
+    STATS_LOCK();
+    mergeShard(total, &retiredStats);
+    for(StatsShard *shard = shards; shard; shard = shard->next) mergeShard(total, shard);
+    STATS_UNLOCK();
+    return 1;
+}
+
+#else
+
+uint64_t statsStart(int op)
+{
+    (void)op;
+    return 0;
+}
+
+void statsEnd(int op, uint64_t start)
+{
+    (void)op;
+    (void)start;
+}
+
+void statsCount(int counter, uint64_t n)
+{
+    (void)counter;
+    (void)n;
+}
+
+void statsWalk(uint64_t steps)
+{
+    (void)steps;
+}
+
+uint64_t statsSampleLookup(void)
+{
+    return 0;
+}
+
+static int collectStats(StatsShard *total)
+{
+    (void)total;
+    return 0;
+}
+
+#endif
+
+// Nilai tengah bucket histogram
+static uint64_t bucketValue(unsigned bucket)
+{
+    if(bucket < 16) return bucket;
+    unsigned e = (bucket - 16) / 8 + 4, sub = (bucket - 16) % 8;
+    return ((8ULL + sub) << (e - 3)) + (1ULL << (e - 3)) / 2;
+}
+
+// Nilai sampel ke-ceil(q * timed), tidak pernah di atas max: nilai tengah
+// bucket bisa lebih besar dari sampel terbesar yang jatuh di bucket itu
+static uint64_t percentile(const uint64_t *latency, uint64_t timed, double q, uint64_t max)
+{
+    uint64_t rank = (uint64_t)(q * timed);
+    if((double)rank < q * timed) rank++;
+    if(rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for(unsigned b = 0; b < LATENCY_BUCKETS; b++)
+        if((seen += latency[b]) >= rank) return bucketValue(b) < max ? bucketValue(b) : max;
+    return max;
+}
+
+static void formatNs(double ns, char *buffer, size_t size)
+{
+    if(ns < 1e3) snprintf(buffer, size, "%.0f ns", ns);
+    else if(ns < 1e6) snprintf(buffer, size, "%.1f us", ns / 1e3);
+    else if(ns < 1e9) snprintf(buffer, size, "%.1f ms", ns / 1e6);
+    else snprintf(buffer, size, "%.2f s", ns / 1e9);
+}
+
+static void printBytes(FILE *out, const char *label, size_t bytes, const char *note)
+{
+    fprintf(out, "  %-26s %10.1f KB%s\n", label, bytes / 1024.0, note);
+}
+
+static void printStructures(Dictionary *dict, FILE *out)
+{
+    IndexStats index;
+    TrieStats trie;
+    size_t setBytes = 0, sets = 0;
+
+    // penulis ditahan selama struktur dibaca; pembaca tetap jalan
+    dictWriteBegin(dict);
+    hashTableStats(dict, &index);
+    trieStats(dict, &trie);
+    // kata snapshot yang belum dipakai tidak diisi hanya untuk dihitung
+    HashTableIter it;
+    hashTableIterInit(&it);
+    it.mapped = SIZE_MAX;
+    for(WordEntry *entry; (entry = hashTableNext(dict, &it));)
+    {
+        size_t bytes = synonymSetBytes(entry);
+        setBytes += bytes;
+        sets += bytes > 0;
+    }
+    size_t poolBytes = dict->strings.size * sizeof(PoolSlot);
+    size_t graph = graphBytes(dict);
+    size_t retired = dict->retiredCount, retiredBytes = dict->retiredCap * sizeof(RetiredNode);
+    size_t wordBytes = dict->wordArena.reserved, wordBlocks = dict->wordArena.blockCount;
+    size_t trieBytes = dict->trieArena.reserved, trieBlocks = dict->trieArena.blockCount;
+    size_t snapshotBytes = dict->snapshot.size;
+    size_t served = snapshotWordCount(dict);
+    size_t servedBytes = dict->mapped.entryCount * (sizeof(WordEntry) + 1);
+    dictWriteEnd(dict);
+    size_t records;
+    size_t history = historyBytes(dict, &records);
+
+#ifndef WORD_INDEX_OPEN
+    fprintf(out, "Index (chaining): %zu entries in %zu buckets, load %.2f\n", index.entries, index.slots,
+            index.slots ? (double)index.entries / index.slots : 0.0);
+    fprintf(out, "  non-empty buckets %.1f%%, longest chain %zu, mean chain %.2f\n",
+            index.slots ? 100.0 * index.used / index.slots : 0.0, index.longest,
+            index.used ? (double)index.total / index.used : 0.0);
+    fprintf(out, "  chain length:");
+#else
+    fprintf(out, "Index (open addressing): %zu entries in %zu slots, load %.2f, %zu tombstones\n", index.entries,
+            index.slots, index.slots ? (double)(index.used + index.tombstones) / index.slots : 0.0, index.tombstones);
+    fprintf(out, "  longest probe %zu, mean probe %.2f\n", index.longest,
+            index.used ? (double)index.total / index.used : 0.0);
+    fprintf(out, "  probe distance:");
+#endif
+    size_t counted = 0;
+    for(int i = 0; i <= STATS_CHAIN_HISTOGRAM; i++) counted += index.histogram[i];
+    for(int i = 0; i <= STATS_CHAIN_HISTOGRAM; i++)
+        fprintf(out, " %d%s:%.1f%%", i, i == STATS_CHAIN_HISTOGRAM ? "+" : "",
+                counted ? 100.0 * index.histogram[i] / counted : 0.0);
+    fputc('\n', out);
+
+    if(dict->mapped.words)
+        fprintf(out, "Snapshot: %zu words served from the mapped file\n", served);
+
+    fprintf(out, "Trie: %zu nodes, %zu words, depth %zu, %zu of %zu child slots used\n", trie.nodes, trie.words,
+            trie.maxDepth, trie.children, trie.childSlots);
+
+    char note[64];
+    fprintf(out, "Memory:\n");
+    snprintf(note, sizeof(note), "  (%zu blocks)", wordBlocks);
+    printBytes(out, "entries and strings", wordBytes, note);
+    snprintf(note, sizeof(note), "  (%zu blocks)", trieBlocks);
+    printBytes(out, "trie", trieBytes, note);
+    printBytes(out, "word index", index.bytes, "");
+    printBytes(out, "string pool", poolBytes, "");
+    snprintf(note, sizeof(note), "  (%zu sets)", sets);
+    printBytes(out, "synonym sets", setBytes, note);
+    printBytes(out, "reverse synonym edges", graph, dict->graphReady ? "" : "  (not built)");
+    snprintf(note, sizeof(note), "  (%zu records)", records);
+    printBytes(out, "history", history, note);
+    snprintf(note, sizeof(note), "  (%zu waiting)", retired);
+    printBytes(out, "retired nodes", retiredBytes, note);
+    if(snapshotBytes) printBytes(out, "snapshot (mapped)", snapshotBytes, "");
+    if(servedBytes) printBytes(out, "snapshot entries", servedBytes, "  (filled on first use)");
+    printBytes(out, "total", wordBytes + trieBytes + index.bytes + poolBytes + setBytes + graph + history +
+               retiredBytes + snapshotBytes + servedBytes, "");
+}
+
+// Laporan lengkap: bentuk struktur, lalu latensi per operasi dan counter
+void printStats(Dictionary *dict, FILE *out)
+{
+    printStructures(dict, out);
+
+    StatsShard *total = (StatsShard *)calloc(1, sizeof(StatsShard));
+    if(!total || !collectStats(total))
+    {
+#ifdef SYNONYM_NO_STATS
+        fprintf(out, "Operation statistics are not compiled in (SYNONYM_NO_STATS).\n");
+#else
+        fprintf(out, "Operation statistics are off (SYNONYM_STATS=0).\n");
+#endif
+        free(total);
+        return;
+    }
+
+    fprintf(out, "Operations (findWord and findWords timed 1 in %u calls):\n", statsSample);
+    fprintf(out, "  %-15s %12s %10s %10s %10s %10s %10s %10s\n", "", "calls", "timed", "mean", "p50", "p99",
+            "p99.9", "max");
+    for(int op = 0; op < STATS_OPS; op++)
+    {
+        if(!total->calls[op]) continue;
+        char mean[16] = "-", p50[16] = "-", p99[16] = "-", p999[16] = "-", max[16] = "-";
+        uint64_t timed = total->timed[op];
+        if(timed)
+        {
+            formatNs((double)total->totalNs[op] / timed, mean, sizeof(mean));
+            formatNs((double)percentile(total->latency[op], timed, 0.5, total->maxNs[op]), p50, sizeof(p50));
+            formatNs((double)percentile(total->latency[op], timed, 0.99, total->maxNs[op]), p99, sizeof(p99));
+            formatNs((double)percentile(total->latency[op], timed, 0.999, total->maxNs[op]), p999, sizeof(p999));
+            formatNs((double)total->maxNs[op], max, sizeof(max));
+        }
+        fprintf(out, "  %-15s %12llu %10llu %10s %10s %10s %10s %10s\n", opNames[op],
+                (unsigned long long)total->calls[op], (unsigned long long)timed, mean, p50, p99, p999, max);
+    }
+
+    const uint64_t *c = total->counters;
+    fprintf(out, "Counters:\n");
+    fprintf(out, "  sampled index chain walks  %10llu  (%.2f compared per walk)\n",
+            (unsigned long long)c[STATS_CHAIN_WALKS],
+            c[STATS_CHAIN_WALKS] ? (double)c[STATS_CHAIN_STEPS] / c[STATS_CHAIN_WALKS] : 0.0);
+    fprintf(out, "  lookup retries             %10llu\n", (unsigned long long)c[STATS_FIND_RETRIES]);
+    fprintf(out, "  words looked up in batches %10llu\n", (unsigned long long)c[STATS_BATCH_WORDS]);
+    fprintf(out, "  rehash moves               %10llu\n", (unsigned long long)c[STATS_REHASH_MOVES]);
+    fprintf(out, "  arena blocks               %10llu\n", (unsigned long long)c[STATS_ARENA_BLOCKS]);
+    fprintf(out, "  arena allocations          %10llu\n", (unsigned long long)c[STATS_ARENA_ALLOCS]);
+    fprintf(out, "  slab reuses                %10llu\n", (unsigned long long)c[STATS_SLAB_REUSES]);
+    fprintf(out, "  synonym set allocations    %10llu\n", (unsigned long long)c[STATS_SET_ALLOCS]);
+    fprintf(out, "  retired nodes              %10llu\n", (unsigned long long)c[STATS_RETIRED]);
+    free(total);
+}
@@ -0,0 +1,480 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "dictionary.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+// Mode rewrite: teks besar dibaca per blok, setiap kata dicari di kamus, lalu
+// ditulis lagi dengan sinonimnya (STREAM_ANNOTATE) atau diganti sinonim
+// terbarunya (STREAM_REPLACE).
+//
+// Empat tahap berjalan di thread sendiri dan saling mengoper blok:
+// baca -> tokenize -> lookup -> tulis. Hanya ada STREAM_BLOCKS blok yang
+// dipakai bergiliran, jadi memori tetap sama berapa pun besar masukannya.
+//
+// Token adalah deretan huruf, angka, byte non-ASCII, '-' dan '\'' yang
+// diawali dan diakhiri huruf/angka/byte non-ASCII. Token dinormalisasi
+// dengan trim_and_tocapital, sama seperti kata yang dimasukkan dari menu.
+
+typedef struct StreamToken
+{
+    size_t offset;          // posisi di data
+    size_t len;
+    size_t word;            // posisi salinan yang sudah dinormalisasi di words
+} StreamToken;
+
+typedef struct StreamBlock
+{
+    char *data;             // teks masukan, selalu berakhir di batas token
+    size_t len, cap;
+    char *words;            // token yang sudah dinormalisasi, dipisah '\0'
+    size_t wordsLen, wordsCap;
+    StreamToken *tokens;
+    size_t tokenCount, tokenCap;
+    const char **lookups;   // pointer ke words untuk findWords, kapasitas tokenCap
+    WordEntry **entries;
+    char *out;
+    size_t outLen, outCap;
+    int last;               // blok terakhir (akhir masukan atau error)
+} StreamBlock;
+
+typedef struct StreamJob
+{
+    Dictionary *dict;
+    FILE *in;
+    FILE *out;
+    int mode;
+    char *carry;            // potongan token di akhir blok sebelumnya
+    size_t carryLen, carryCap;
+    int failed;
+    StreamStats stats;
+} StreamJob;
+
+static int isTokenStart(unsigned char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+static int isTokenByte(unsigned char c)
+{
+    return isTokenStart(c) || c == '-' || c == '\'';
+}
+
+static int reserveBytes(char **buffer, size_t *cap, size_t needed)
+{
+    if(needed <= *cap) return 1;
+
+    size_t newCap = *cap ? *cap : 4096;
+    while(newCap < needed) newCap *= 2;
+    char *grown = (char *)realloc(*buffer, newCap);
+    if(!grown) return 0;
+    *buffer = grown;
+    *cap = newCap;
+    return 1;
+}
+
+static int appendOut(StreamBlock *block, const char *text, size_t len)
+{
+    if(len == 0) return 1;
+    if(!reserveBytes(&block->out, &block->outCap, block->outLen + len)) return 0;
+    memcpy(block->out + block->outLen, text, len);
+    block->outLen += len;
+    return 1;
+}
+
+static void freeBlock(StreamBlock *block)
+{
+    free(block->data);
+    free(block->words);
+    free(block->tokens);
+    free(block->lookups);
+    free(block->entries);
+    free(block->out);
+}
+
+// Isi blok dengan sisa blok sebelumnya lalu baca sampai sekitar
+// STREAM_BLOCK_BYTES. Potongan setelah pemisah terakhir disimpan untuk blok
+// berikutnya, jadi tidak ada token yang terbelah. Mengembalikan 0 jika gagal.
+static int readBlock(StreamJob *job, StreamBlock *block)
+{
+    block->len = 0;
+    block->last = 0;
+    if(!reserveBytes(&block->data, &block->cap, job->carryLen + STREAM_BLOCK_BYTES)) return 0;
+    if(job->carryLen) memcpy(block->data, job->carry, job->carryLen);
+    block->len = job->carryLen;
+    job->carryLen = 0;
+
+    for(;;)
+    {
+        size_t got = fread(block->data + block->len, 1, block->cap - block->len, job->in);
+        block->len += got;
+        if(got == 0 || block->len < block->cap)
+        {
+            if(ferror(job->in)) return 0;
+            if(feof(job->in))
+            {
+                block->last = 1;
+                return 1;
+            }
+            continue;
+        }
+
+        size_t split = block->len;
+        while(split > 0 && isTokenByte((unsigned char)block->data[split - 1])) split--;
+        if(split > 0)
+        {
+            size_t tail = block->len - split;
+            if(!reserveBytes(&job->carry, &job->carryCap, tail)) return 0;
+            memcpy(job->carry, block->data + split, tail);
+            job->carryLen = tail;
+            block->len = split;
+            return 1;
+        }
+
+        // satu token memenuhi seluruh blok: perbesar sampai token selesai
+        if(!reserveBytes(&block->data, &block->cap, block->cap * 2)) return 0;
+    }
+}
+
+static int pushStreamToken(StreamBlock *block, size_t offset, size_t len)
+{
+    if(block->tokenCount == block->tokenCap)
+    {
+        size_t cap = block->tokenCap ? block->tokenCap * 2 : 4096;
+        StreamToken *tokens = (StreamToken *)realloc(block->tokens, cap * sizeof(StreamToken));
+        if(!tokens) return 0;
+        block->tokens = tokens;
+        const char **lookups = (const char **)realloc(block->lookups, cap * sizeof(const char *));
+        if(!lookups) return 0;
+        block->lookups = lookups;
+        WordEntry **entries = (WordEntry **)realloc(block->entries, cap * sizeof(WordEntry *));
+        if(!entries) return 0;
+        block->entries = entries;
+        block->tokenCap = cap;
+    }
+    if(!reserveBytes(&block->words, &block->wordsCap, block->wordsLen + len + 1)) return 0;
+
+    char *word = block->words + block->wordsLen;
+    memcpy(word, block->data + offset, len);
+    word[len] = '\0';
+    trim_and_tocapital(word);
+
+    StreamToken *token = &block->tokens[block->tokenCount++];
+    token->offset = offset;
+    token->len = len;
+    token->word = block->wordsLen;
+    block->wordsLen += strlen(word) + 1;
+    return 1;
+}
+
+static int tokenizeBlock(StreamBlock *block)
+{
+    block->tokenCount = 0;
+    block->wordsLen = 0;
+
+    const unsigned char *data = (const unsigned char *)block->data;
+    size_t p = 0, len = block->len;
+    while(p < len)
+    {
+        while(p < len && !isTokenStart(data[p])) p++;
+        if(p == len) break;
+
+        size_t start = p;
+        while(p < len && isTokenByte(data[p])) p++;
+        size_t end = p;
+        while(!isTokenStart(data[end - 1])) end--;      // '-' / '\'' di akhir bukan bagian kata
+        if(!pushStreamToken(block, start, end - start)) return 0;
+        p = end;
+    }
+
+    // words bisa dipindah realloc, jadi pointer baru diambil setelah semua token masuk
+    for(size_t i = 0; i < block->tokenCount; i++)
+        block->lookups[i] = block->words + block->tokens[i].word;
+    return 1;
+}
+
+// Tulis token beserta sinonimnya (atau sinonim penggantinya) ke out
+static int renderToken(StreamBlock *block, const StreamToken *token, const WordEntry *entry, int mode)
+{
+    const char *original = block->data + token->offset;
+    SynonymIter syn;
+    const char *synonym = NULL;
+    if(entry)
+    {
+        synonymIterInit(entry, &syn);
+        synonym = synonymNext(&syn);
+    }
+
+    if(mode == STREAM_REPLACE)
+    {
+        if(!synonym) return appendOut(block, original, token->len);
+
+        // huruf pertama mengikuti kata aslinya: kecil jika aslinya berubah saat dikapitalkan
+        char head[5], first[4];
+        size_t headLen = token->len < 4 ? token->len : 4;
+        memcpy(head, original, headLen);
+        head[headLen] = '\0';
+        size_t n = upperFirst(head, first);
+        int lower = memcmp(first, head, n) != 0;
+
+        size_t at = block->outLen;
+        if(!appendOut(block, synonym, strlen(synonym))) return 0;
+        n = lower ? lowerFirst(synonym, first) : upperFirst(synonym, first);
+        memcpy(block->out + at, first, n);
+        return 1;
+    }
+
+    if(!appendOut(block, original, token->len)) return 0;
+    if(!synonym) return 1;
+
+    char separator = '[';
+    for(; synonym; synonym = synonymNext(&syn))
+    {
+        if(!appendOut(block, &separator, 1) || !appendOut(block, synonym, strlen(synonym))) return 0;
+        separator = '|';
+    }
+    return appendOut(block, "]", 1);
+}
+
+// Cari token per STREAM_RESOLVE_BATCH lalu langsung susun keluarannya,
+// selagi entry-nya masih di cache; sinonim terbaru setiap entry di-prefetch
+// dulu. Sinonim dibaca di dalam dictReadBegin/dictReadEnd yang sama dengan
+// lookup-nya.
+static int resolveBlock(Dictionary *dict, StreamBlock *block, int mode, StreamStats *stats)
+{
+    block->outLen = 0;
+    int ok = 1;
+    size_t gap = 0;
+
+    dictReadBegin();
+    for(size_t first = 0; first < block->tokenCount && ok; first += STREAM_RESOLVE_BATCH)
+    {
+        size_t end = first + STREAM_RESOLVE_BATCH;
+        if(end > block->tokenCount) end = block->tokenCount;
+        stats->matched += findWords(dict, block->lookups + first, end - first, block->entries + first);
+        for(size_t i = first; i < end; i++)
+        {
+            if(!block->entries[i]) continue;
+            SynonymIter syn;
+            synonymIterInit(block->entries[i], &syn);
+            if(syn.next) __builtin_prefetch(syn.items[syn.next - 1]);
+        }
+
+        for(size_t i = first; i < end && ok; i++)
+        {
+            const StreamToken *token = &block->tokens[i];
+            ok = appendOut(block, block->data + gap, token->offset - gap) &&
+                 renderToken(block, token, block->entries[i], mode);
+            gap = token->offset + token->len;
+        }
+    }
+    dictReadEnd();
+
+    stats->tokens += block->tokenCount;
+    return ok && appendOut(block, block->data + gap, block->len - gap);
+}
+
+static int writeBlock(StreamJob *job, StreamBlock *block)
+{
+    job->stats.bytesIn += block->len;
+    job->stats.bytesOut += block->outLen;
+    if(block->outLen == 0) return 1;
+    return fwrite(block->out, 1, block->outLen, job->out) == block->outLen;
+}
+
+#ifndef _WIN32
+// Antrian blok di antara dua tahap. Jumlah blok tetap STREAM_BLOCKS, jadi
+// antrian tidak pernah penuh dan hanya pengambil yang perlu menunggu.
+typedef struct BlockQueue
+{
+    StreamBlock *items[STREAM_BLOCKS];
+    size_t head, count;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+} BlockQueue;
+
+static void queueInit(BlockQueue *queue)
+{
+    queue->head = queue->count = 0;
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->ready, NULL);
+}
+
+static void queueDestroy(BlockQueue *queue)
+{
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->ready);
+}
+
+static void queuePush(BlockQueue *queue, StreamBlock *block)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->items[(queue->head + queue->count++) % STREAM_BLOCKS] = block;
+    pthread_cond_signal(&queue->ready);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static StreamBlock *queuePop(BlockQueue *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    while(queue->count == 0) pthread_cond_wait(&queue->ready, &queue->lock);
+    StreamBlock *block = queue->items[queue->head];
+    queue->head = (queue->head + 1) % STREAM_BLOCKS;
+    queue->count--;
+    pthread_mutex_unlock(&queue->lock);
+    return block;
+}
+
+typedef struct StreamPipeline
+{
+    StreamJob *job;
+    BlockQueue free, read, tokenized, resolved;
+} StreamPipeline;
+
+// Setelah ada yang gagal, tahap lain hanya mengoper blok sampai blok terakhir
+static void *readStage(void *arg)
+{
+    StreamPipeline *pipe = (StreamPipeline *)arg;
+    for(;;)
+    {
+        StreamBlock *block = queuePop(&pipe->free);
+        if(LOAD_ACQUIRE(&pipe->job->failed) || !readBlock(pipe->job, block))
+        {
+            STORE_RELEASE(&pipe->job->failed, 1);
+            block->len = 0;
+            block->last = 1;
+        }
+        int last = block->last;
+        queuePush(&pipe->read, block);
+        if(last) return NULL;
+    }
+}
+
+static void *tokenizeStage(void *arg)
+{
+    StreamPipeline *pipe = (StreamPipeline *)arg;
+    for(;;)
+    {
+        StreamBlock *block = queuePop(&pipe->read);
+        if(!LOAD_ACQUIRE(&pipe->job->failed) && !tokenizeBlock(block))
+            STORE_RELEASE(&pipe->job->failed, 1);
+        int last = block->last;
+        queuePush(&pipe->tokenized, block);
+        if(last) return NULL;
+    }
+}
+
+static void *resolveStage(void *arg)
+{
+    StreamPipeline *pipe = (StreamPipeline *)arg;
+    StreamJob *job = pipe->job;
+    for(;;)
+    {
+        StreamBlock *block = queuePop(&pipe->tokenized);
+        if(!LOAD_ACQUIRE(&job->failed) && !resolveBlock(job->dict, block, job->mode, &job->stats))
+            STORE_RELEASE(&job->failed, 1);
+        int last = block->last;
+        queuePush(&pipe->resolved, block);
+        if(last) return NULL;
+    }
+}
+
+// Tahap tulis berjalan di thread pemanggil
+static void writeStage(StreamPipeline *pipe)
+{
+    for(;;)
+    {
+        StreamBlock *block = queuePop(&pipe->resolved);
+        if(!LOAD_ACQUIRE(&pipe->job->failed) && !writeBlock(pipe->job, block))
+            STORE_RELEASE(&pipe->job->failed, 1);
+        int last = block->last;
+        queuePush(&pipe->free, block);
+        if(last) return;
+    }
+}
+
+static int streamThreadsEnabled(void)
+{
+    const char *env = getenv("SYNONYM_STREAM_THREADS");
+    return !(env && atoi(env) == 1);
+}
+
+// Jalankan keempat tahap di thread masing-masing. Mengembalikan 0 jika
+// thread tidak bisa dibuat; masukan belum tersentuh, jadi pemanggil bisa
+// mengulang tanpa thread.
+static int streamPipelined(StreamJob *job, StreamBlock *blocks)
+{
+    StreamPipeline pipe;
+    pipe.job = job;
+    queueInit(&pipe.free);
+    queueInit(&pipe.read);
+    queueInit(&pipe.tokenized);
+    queueInit(&pipe.resolved);
+    for(int i = 0; i < STREAM_BLOCKS; i++) queuePush(&pipe.free, &blocks[i]);
+
+    // dimulai dari hilir, jadi pembaca baru jalan setelah semua tahap lain siap
+    void *(*stages[])(void *) = {resolveStage, tokenizeStage, readStage};
+    BlockQueue *inputs[] = {&pipe.tokenized, &pipe.read, NULL};
+    pthread_t threads[3];
+    int started = 0;
+    for(; started < 3; started++)
+        if(pthread_create(&threads[started], NULL, stages[started], &pipe) != 0) break;
+
+    if(started == 3) writeStage(&pipe);
+    else if(started > 0)
+    {
+        // hentikan tahap yang sudah jalan dengan blok terakhir yang kosong
+        StreamBlock *block = queuePop(&pipe.free);
+        block->len = 0;
+        block->last = 1;
+        queuePush(inputs[started - 1], block);
+    }
+
+    for(int t = 0; t < started; t++) pthread_join(threads[t], NULL);
+    queueDestroy(&pipe.free);
+    queueDestroy(&pipe.read);
+    queueDestroy(&pipe.tokenized);
+    queueDestroy(&pipe.resolved);
+    return started == 3;
+}
+#endif
+
+// Baca teks dari in sampai habis dan tulis hasilnya ke out. mode adalah
+// STREAM_ANNOTATE atau STREAM_REPLACE. stats boleh NULL.
+// Mengembalikan 1 jika seluruh masukan berhasil diproses.
+int streamRewrite(Dictionary *dict, FILE *in, FILE *out, int mode, StreamStats *stats)
+{
+    StreamJob job;
+    memset(&job, 0, sizeof(job));
+    job.dict = dict;
+    job.in = in;
+    job.out = out;
+    job.mode = mode;
+
+    StreamBlock blocks[STREAM_BLOCKS];
+    memset(blocks, 0, sizeof(blocks));
+
+    int done = 0;
+#ifndef _WIN32
+    if(streamThreadsEnabled()) done = streamPipelined(&job, blocks);
+#endif
+
+    for(int last = 0; !done && !last && !job.failed;)
+    {
+        StreamBlock *block = &blocks[0];
+        if(!readBlock(&job, block) || !tokenizeBlock(block) ||
+           !resolveBlock(dict, block, mode, &job.stats) || !writeBlock(&job, block))
+            job.failed = 1;
+        last = block->last;
+    }
+
+    for(int i = 0; i < STREAM_BLOCKS; i++) freeBlock(&blocks[i]);
+    free(job.carry);
+    if(fflush(out) != 0) job.failed = 1;
+    if(stats) *stats = job.stats;
+    return !job.failed;
+}
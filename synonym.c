@@ -4,10 +4,7 @@
 #include <time.h>
 #include <unistd.h>
 #include <ctype.h>
-#include "dictionary.h"
-
-WordEntry* hashTable[HASH_SIZE] = {0};
-TrieNode *rootTrie = NULL;
+#include "dictionary_private.h"
 
 static inline void clearScreen(void) {
 #ifdef _WIN32
@@ -22,518 +19,487 @@ static inline void pauseProgram(void) {
     while (getchar() != '\n');
 }
 
-void trim(char *word)
-{
-    if(word == NULL || *word == '\0') return;
-
-    char *start = word;
-    while(isspace((unsigned char)*start)) start++;
-
-    char *end = start + strlen(start) - 1;
-    while(end > start && isspace((unsigned char)*end)) end--;
-    
-    *(end + 1) = 0;
-
-    if(start != word) memmove(word, start, end - start + 2);
-}
-
-void trim_and_tolower(char *word) 
-{
-    trim(word);
-
-    for(int i = 0; word[i]; i++) word[i] = tolower((unsigned char)word[i]);
-}
-
-void trim_and_tocapital(char *word)
-{
-    trim(word);
-
-    word[0] = toupper((unsigned char)word[0]);
-    for(int i = 1; word[i]; i++) word[i] = tolower((unsigned char)word[i]);
-}
-
-// Fungsi hash 'sederhana'
-unsigned int hash(const char *str)
+// Buat entry kata utama
+WordEntry *createWordEntry(Dictionary *dict, const char *word)
 {
-    unsigned int hash = 5381;
-    int c;
-    while ((c = *str++))
+    WordEntry *entry = (WordEntry *)slabAlloc(&dict->entrySlab);
+    if(!entry) return NULL;
+    entry->word = internString(dict, word);
+    if(!entry->word)
     {
-        hash = ((hash << 5) + hash) + c;
+        slabFree(&dict->entrySlab, entry);
+        return NULL;
     }
-    return hash % HASH_SIZE;
+    entry->synonyms = NULL;
+    entry->next = NULL;
+    entry->inlineCount = 0;
+    entry->inlineUsed = 0;
+    return entry;
 }
 
-// Buat node sinonim
-SynonymNode *createSynonymNode(const char *word)
+// Cari kata di hash table. Aman dipanggil dari banyak thread sekaligus
+// selama pemanggil berada di dalam dictReadBegin/dictReadEnd (atau memegang
+// dictWriteBegin), karena entry yang dihapus baru dilepas setelah itu.
+WordEntry *findWord(Dictionary *dict, const char *word)
 {
-    SynonymNode *node = (SynonymNode *)malloc(sizeof(SynonymNode));
-    node->word = strdup(word);
-    node->next = NULL;
-    return node;
+    STATS_LOOKUP_BEGIN();
+    WordEntry *entry = hashTableFind(dict, word);
+    STATS_END(STATS_FIND);
+    return entry;
 }
 
-// Buat entry kata utama
-WordEntry *createWordEntry(const char *word)
+// Cari banyak kata sekaligus (mis. semua kata satu dokumen); entries[i]
+// berisi entry untuk words[i] atau NULL. Lebih cepat dari findWord berulang
+// karena cache miss antar kata saling tumpang tindih. Mengembalikan jumlah
+// kata yang ditemukan.
+size_t findWords(Dictionary *dict, const char *const *words, size_t count, WordEntry **entries)
 {
-    WordEntry *entry = (WordEntry *)malloc(sizeof(WordEntry));
-    entry->word = strdup(word);
-    entry->synonyms = NULL;
-    entry->next = NULL;
-    return entry;
+    STATS_BEGIN(STATS_FIND_BATCH);
+    hashTableFindBatch(dict, words, count, entries);
+    STATS_END(STATS_FIND_BATCH);
+    STATS_COUNT(STATS_BATCH_WORDS, count);
+
+    size_t found = 0;
+    for(size_t i = 0; i < count; i++)
+        if(entries[i]) found++;
+    return found;
 }
 
-// Cari kata di hash table
-WordEntry *findWord(const char *word)
+// Masukkan entry baru ke hash table dan trie tanpa cek duplikat
+WordEntry *insertWordEntry(Dictionary *dict, const char *word)
 {
-    unsigned int index = hash(word);
-    WordEntry *entry = hashTable[index];
-    while (entry != NULL)
+    WordEntry *newEntry = createWordEntry(dict, word);
+    if(!newEntry) return NULL;
+    if(!hashTableInsert(dict, newEntry))
     {
-        if (strcmp(entry->word, word) == 0)
-            return entry;
-        entry = entry->next;
+        internRelease(dict, newEntry->word);
+        slabFree(&dict->entrySlab, newEntry);
+        return NULL;
     }
-    return NULL;
+
+    insertToTrie(dict, newEntry);
+    return newEntry;
 }
 
-TrieNode *createTrieNode()
+// Tambahkan sinonim (string hasil internString) ke entry; pegangan
+// internString pindah ke entry, atau dilepas jika sinonim sudah ada (atau
+// gagal alokasi) dan hasilnya NULL
+const char *appendSynonym(Dictionary *dict, WordEntry *entry, const char *interned)
 {
-    TrieNode *newNode = (TrieNode*)malloc(sizeof(TrieNode));
-    if(newNode)
+    if(!interned) return NULL;
+    if(!synonymInsert(dict, entry, interned))
     {
-        newNode->isEndOfWord = 0;
-        for(int i = 0; i < ALPHABET_SIZE; i++)
-            newNode->children[i] = NULL;
+        internRelease(dict, interned);
+        return NULL;
     }
+    graphLink(dict, entry, interned);
+    return interned;
 }
 
-void insertToTrie(TrieNode *root, const char *word)
+// Tambah kata baru; dipanggil dengan dictWriteBegin dipegang.
+// Mengembalikan EDIT_OK, EDIT_EXISTS, atau EDIT_FAILED jika alokasi gagal.
+int addWordLocked(Dictionary *dict, const char *word, const int condition)
 {
-    if(word == NULL || word[0] == '\0' || root == NULL) return;
-
-    TrieNode *curr = root;
-    char *wordCopy = NULL;
-
-    wordCopy = strdup(word);
-    if(wordCopy == NULL)
-    {
-        perror("Failed to allocate memory for word copy in insertToTrie");
-        return;
-    }
+    STATS_BEGIN(STATS_ADD_WORD);
+    if (findWord(dict, word)) return STATS_RETURN(STATS_ADD_WORD, EDIT_EXISTS);
 
-    trim_and_tolower(wordCopy);
-
-    const char *currentChar = wordCopy;
-    while(*currentChar)
-    {
-        int index = *currentChar - 'a';
-        
-        if(index < 0 || index >= ALPHABET_SIZE)
-        {
-            fprintf(stderr, "Warning: Character '%c' out of 'a'-'z' range in insertToTrie after tolower. Skipping.\n", *currentChar);
-            currentChar++;
-            continue;
-        }
-        if(curr->children[index] == NULL)
-        {
-            curr->children[index] = createTrieNode();
-            if(!curr->children[index])
-            {
-                fprintf(stderr, "Failed to create TrieNode in insertToTrie.\n");
-                free(wordCopy); // Clean up allocated copy
-                return;
-            }
-        }
-        curr = curr->children[index];
-        currentChar++;
-    }
-    curr->isEndOfWord = 1;
+    WordEntry *newEntry = insertWordEntry(dict, word);
+    if(!newEntry) return STATS_RETURN(STATS_ADD_WORD, EDIT_FAILED);
+    walAppend(dict, WAL_OP_ADD_WORD, newEntry->word, NULL);
 
-    free(wordCopy);
-    wordCopy = NULL;
+    if(condition) pushHistory(dict, WAL_OP_ADD_WORD, newEntry->word, NULL);
+    return STATS_RETURN(STATS_ADD_WORD, EDIT_OK);
 }
 
 // Tambah kata baru ke hash table
-void addWord(const char *word, const int condition)
+void addWord(Dictionary *dict, const char *word, const int condition)
 {
-    if (findWord(word)){
+    dictWriteBegin(dict);
+    int status = addWordLocked(dict, word, condition);
+    dictWriteEnd(dict);
+    if(status == EDIT_EXISTS)
+    {
         printf("Entry word '%s' already exists.\n", word);
         sleep(0.7);
-        return; // return if already exists
     }
+}
 
-    unsigned int index = hash(word);
-    WordEntry *newEntry = createWordEntry(word);
-
-    newEntry->next = hashTable[index];
-    hashTable[index] = newEntry;
-
-    insertToTrie(rootTrie, word);
+// Tambah sinonim; dipanggil dengan dictWriteBegin dipegang. Mengembalikan
+// EDIT_OK, EDIT_NO_ENTRY, EDIT_EXISTS, atau EDIT_FAILED.
+int addSynonymLocked(Dictionary *dict, const char *word, const char *synonym, const int condition)
+{
+    STATS_BEGIN(STATS_ADD_SYNONYM);
+    WordEntry *entry = findWord(dict, word);
+    if (!entry) return STATS_RETURN(STATS_ADD_SYNONYM, EDIT_NO_ENTRY);
 
-    if(condition)
+    const char *interned = internString(dict, synonym);
+    if(!interned) return STATS_RETURN(STATS_ADD_SYNONYM, EDIT_FAILED);
+    if(synonymContains(entry, interned))
     {
-        int len = snprintf(NULL, 0, "create a new entry '%s' into the dictionary", newEntry->word);
-        char *action = malloc(len + 1);
-        if (action) {
-            snprintf(action, len + 1, "create a new entry '%s' into the dictionary", newEntry->word);
-            pushHistory(action);
-            free(action);
-        }
+        internRelease(dict, interned);
+        return STATS_RETURN(STATS_ADD_SYNONYM, EDIT_EXISTS);
     }
+    const char *newSyn = appendSynonym(dict, entry, interned);
+    if(!newSyn) return STATS_RETURN(STATS_ADD_SYNONYM, EDIT_FAILED);
+    walAppend(dict, WAL_OP_ADD_SYNONYM, entry->word, newSyn);
+
+    if(condition) pushHistory(dict, WAL_OP_ADD_SYNONYM, entry->word, newSyn);
+    return STATS_RETURN(STATS_ADD_SYNONYM, EDIT_OK);
 }
 
 // Tambah sinonim untuk sebuah kata
-void addSynonym(const char *word, const char *synonym, const int condition)
+void addSynonym(Dictionary *dict, const char *word, const char *synonym, const int condition)
 {
-    WordEntry *entry = findWord(word);
-    if (!entry)
-    {
-        printf("Word Entry '%s' does not exists.\n", word);
-        return;
-    }
+    dictWriteBegin(dict);
+    int status = addSynonymLocked(dict, word, synonym, condition);
+    dictWriteEnd(dict);
+    if(status == EDIT_NO_ENTRY) printf("Word Entry '%s' does not exists.\n", word);
+}
 
-    SynonymNode *syn = entry->synonyms;
-    while(syn)
-    {
-        if(strcmp(syn->word, synonym) == 0) return;
-        syn = syn->next;
-    }
+// Hapus entry dari hash table dan trie beserta sinonimnya; 0 jika tidak ada.
+// Node dan string yang tidak dipegang lagi dipensiunkan, bukan langsung
+// dilepas: pembaca lain mungkin masih memegangnya (lihat epoch.c).
+int removeWordEntry(Dictionary *dict, const char *word)
+{
+    WordEntry *current = hashTableRemove(dict, word);
+    if(current == NULL) return 0;
 
-    SynonymNode *newSyn = createSynonymNode(synonym);
-    newSyn->next = entry->synonyms;
-    entry->synonyms = newSyn;
+    // trie harus selalu berisi kata yang sama dengan hash table
+    deleteFromTrie(dict, current->word);
 
-    if(condition)
+    SynonymIter syn;
+    synonymIterInit(current, &syn);
+    for(const char *synonym; (synonym = synonymNext(&syn));)
     {
-        int len = snprintf(NULL, 0, "add synonym %s to %s", newSyn->word, entry->word);
-        char *action = malloc(len + 1);
-        if (action) {
-            snprintf(action, len + 1, "add synonym %s to %s", newSyn->word, entry->word);
-            pushHistory(action);
-            free(action); // Jangan lupa membebaskan memori
-        }
+        graphUnlink(dict, current, synonym);
+        internRelease(dict, synonym);
     }
+    internRelease(dict, current->word);
+    retireNode(dict, NULL, current->synonyms);
+    if(!snapshotOwnsEntry(dict, current)) retireNode(dict, &dict->entrySlab, current);
+    return 1;
 }
 
-void deleteWordEntry(const char *word)
+// Lepas satu sinonim dari entry; 0 jika sinonim tidak ada
+int removeSynonym(Dictionary *dict, WordEntry *entry, const char *synonym)
 {
-    if (word == NULL || word[0] == '\0') {
-        printf("Error: Cannot delete an empty or NULL word.\n");
-        return;
-    }
+    // sinonim yang belum pernah di-intern pasti tidak ada di entry mana pun
+    const char *interned = internFind(dict, synonym);
+    if(!interned || !synonymErase(entry, interned)) return 0;
 
-    unsigned int index = hash(word);
-    WordEntry *current = hashTable[index];
-    WordEntry *prev = NULL;
+    graphUnlink(dict, entry, interned);
+    internRelease(dict, interned);
+    return 1;
+}
 
-    while(current != NULL && strcmp(current->word, word) != 0)
-    {
-        prev = current;
-        current = current->next;
-    }
+// Hapus entry beserta log dan history-nya; dipanggil dengan dictWriteBegin
+// dipegang. Mengembalikan EDIT_OK atau EDIT_NOT_FOUND.
+int deleteWordLocked(Dictionary *dict, const char *word)
+{
+    STATS_BEGIN(STATS_DELETE_WORD);
+    if(!removeWordEntry(dict, word)) return STATS_RETURN(STATS_DELETE_WORD, EDIT_NOT_FOUND);
+    walAppend(dict, WAL_OP_DELETE_WORD, word, NULL);
+    pushHistory(dict, WAL_OP_DELETE_WORD, word, NULL);
+    return STATS_RETURN(STATS_DELETE_WORD, EDIT_OK);
+}
 
-    if(current == NULL)
-    {
-        printf("Word entry '%s' not found for deletion.\n", word);
+void deleteWordEntry(Dictionary *dict, const char *word)
+{
+    if (word == NULL || word[0] == '\0') {
+        printf("Error: Cannot delete an empty or NULL word.\n");
         return;
     }
 
-    if(prev == NULL)
-    {
-        hashTable[index] = current->next;
-    } 
-    else
-    {
-        prev->next = current->next;
-    } 
-
-    SynonymNode *syn = current->synonyms;
-    while(syn != NULL)
-    {
-        SynonymNode *synTemp = syn;
-        syn = syn->next;
-
-        free(synTemp->word);
-        synTemp->word = NULL;
-        free(synTemp);
-        synTemp = NULL;
-    }
-    current->synonyms = NULL;
-
-    free(current->word);
-    current->word = NULL;
-
-    free(current);
-    current = NULL;
+    dictWriteBegin(dict);
+    int status = deleteWordLocked(dict, word);
+    dictWriteEnd(dict);
+    if(status == EDIT_NOT_FOUND) printf("Word entry '%s' not found for deletion.\n", word);
+}
 
-    int len = snprintf(NULL, 0, "Delete %s from word entry", word);
-    char *action = malloc(len + 1);
-    if(action)
-    {
-        snprintf(action, len + 1, "Delete %s from word entry", word);
-        pushHistory(action);
-        free(action);
-    }
+// Hapus satu sinonim beserta log dan history-nya; dipanggil dengan
+// dictWriteBegin dipegang. Mengembalikan EDIT_OK, EDIT_NO_ENTRY, atau
+// EDIT_NOT_FOUND jika sinonimnya tidak ada.
+int deleteSynonymLocked(Dictionary *dict, const char *word, const char *synonym)
+{
+    STATS_BEGIN(STATS_DELETE_SYNONYM);
+    WordEntry *entry = findWord(dict, word);
+    if(!entry) return STATS_RETURN(STATS_DELETE_SYNONYM, EDIT_NO_ENTRY);
+    if(!removeSynonym(dict, entry, synonym)) return STATS_RETURN(STATS_DELETE_SYNONYM, EDIT_NOT_FOUND);
+    walAppend(dict, WAL_OP_DELETE_SYNONYM, word, synonym);
+    pushHistory(dict, WAL_OP_DELETE_SYNONYM, word, synonym);
+    return STATS_RETURN(STATS_DELETE_SYNONYM, EDIT_OK);
 }
 
-void deleteSynonym(const char *word, const char *synonym)
+void deleteSynonym(Dictionary *dict, const char *word, const char *synonym)
 {
     if (word == NULL || word[0] == '\0' || synonym == NULL || synonym[0] == '\0') {
         printf("Error: Word or synonym to delete cannot be empty or NULL.\n");
         return;
     }
 
-    WordEntry *entry = findWord(word);
-    if(!entry)
-    {
-        printf("Word entry '%s' not found.\n", word);
-        return;
-    }
-
-    SynonymNode *currentSyn = entry->synonyms;
-    SynonymNode *prevSyn = NULL;
+    dictWriteBegin(dict);
+    int status = deleteSynonymLocked(dict, word, synonym);
+    dictWriteEnd(dict);
 
-    while (currentSyn != NULL && strcmp(currentSyn->word, synonym) != 0)
-    {
-        prevSyn = currentSyn;
-        currentSyn = currentSyn->next;
-    }
-    
-    if(currentSyn == NULL)
-    {
+    if(status == EDIT_NO_ENTRY)
+        printf("Word entry '%s' not found.\n", word);
+    else if(status == EDIT_NOT_FOUND)
         printf("Synonym '%s' not found for word '%s'.\n", synonym, word);
-        return;
-    }
-
-    if(prevSyn == NULL) 
-    {
-        entry->synonyms = currentSyn->next;
-    }
-    else 
-    {
-        prevSyn->next = currentSyn->next;    
-    }
-
-    free(currentSyn->word);
-    currentSyn->word = NULL;
-    free(currentSyn);
-    currentSyn = NULL;
+    else
+        printf("Synonym '%s' deleted successfully from word '%s'.\n", synonym, word);
+}
 
-    printf("Synonym '%s' deleted successfully from word '%s'.\n", synonym, word);
+static int printSuggestion(const char *word, int distance, void *ctx)
+{
+    (void)distance;
+    int *order = (int *)ctx;
+    if(++*order == 1) printf("Mungkin maksud Anda:\n");
+    char first[4];
+    size_t n = upperFirst(word, first);
+    printf("%d. %.*s%s\n", *order, (int)n, first, word + n);
+    return 1;
+}
 
-    int len = snprintf(NULL, 0, "Delete %s from %s", synonym, word);
-    char *action = malloc(len + 1);
-    if (action)
-    {
-        snprintf(action, len + 1, "Delete %s from %s", synonym, word);
-        pushHistory(action);
-        free(action);
-    }
+// Saran kata untuk word yang tidak ditemukan: yang paling dekat dulu,
+// jarak edit baru dinaikkan jika belum ada kata yang cocok
+static void printSuggestions(Dictionary *dict, const char *word)
+{
+    int order = 0;
+    for(int distance = 1; distance <= TRIE_FUZZY_DISTANCE && order == 0; distance++)
+        trieFuzzy(dict, word, distance, TRIE_COMPLETE_LIMIT, printSuggestion, &order);
 }
 
 // Tampilkan sinonim dari kata tertentu
-void printSynonyms(const char *word)
+void printSynonyms(Dictionary *dict, const char *word)
 {
-    WordEntry *entry = findWord(word);
+    dictReadBegin();
+    WordEntry *entry = findWord(dict, word);
     if (!entry)
     {
+        dictReadEnd();
         printf("Kata '%s' tidak ditemukan.\n", word);
+        printSuggestions(dict, word);
         return;
     }
 
     printf("Sinonim dari '%s': ", word);
-    SynonymNode *temp = entry->synonyms;
-    if(!temp) {printf("No synonyms recorded.\n");}
+    SynonymIter syn;
+    synonymIterInit(entry, &syn);
+    const char *synonym = synonymNext(&syn);
+    if(!synonym) {dictReadEnd(); printf("No synonyms recorded.\n");}
     else 
     {
-        printf("%s", temp->word);
-        temp = temp->next;
-        while (temp)
+        printf("%s", synonym);
+        while ((synonym = synonymNext(&syn)))
         {
-            printf(", %s", temp->word);
-            temp = temp->next;
+            printf(", %s", synonym);
         }
+        dictReadEnd();
         printf("\n");
         pauseProgram();
     }
 }
 
-// Tampilkan semua kata dan sinonim
-void printAllWords(void)
+// Tampilkan semua kata dan sinonim, terurut
+void printAllWords(Dictionary *dict)
 {
+    // iterator berjalan di trie dan array bucket langsung, jadi penulis ditahan dulu
+    dictWriteBegin(dict);
     // int order = 1;
-    for (int i = 0; i < HASH_SIZE; i++)
-    {
-        WordEntry *entry = hashTable[i];
-        while (entry)
+    WordIter it;
+    wordIterInit(dict, &it);
+    WordEntry *entry;
+    while ((entry = wordIterNext(dict, &it)))
+    {
+        printf("%s: ", entry->word);
+        SynonymIter syn;
+        synonymIterInit(entry, &syn);
+        const char *synonym = synonymNext(&syn);
+        if(!synonym)
         {
-            printf("%s: ", entry->word);
-            SynonymNode *syn = entry->synonyms;
-            if(!syn)
-            {
-                printf("Synonym not found.\n");
-            }
-            else
+            printf("Synonym not found.\n");
+        }
+        else
+        {
+            printf("%s", synonym);
+            while ((synonym = synonymNext(&syn)))
             {
-                printf("%s", syn->word);
-                syn = syn->next;
-                while (syn)
-                {
-                    printf(", %s", syn->word);
-                    syn = syn->next;
-                }
+                printf(", %s", synonym);
             }
-            printf("\n");
-            entry = entry->next;
         }
+        printf("\n");
         // if(entry) printf("%d. %s\n", order++, entry->word);
     }
+    wordIterFree(&it);
+    dictWriteEnd(dict);
 }
 
-void printAllWordsTrieUtil(TrieNode *root, char *buffer, int depth)
+// Cetak satu kata hasil trie dengan huruf pertama kapital
+static int printTrieWord(const char *word, void *ctx)
 {
-    if(root->isEndOfWord)
-    {
-        buffer[depth] = '\0';
-        printf("%s\n", buffer);
-    }
+    int *order = (int *)ctx;
+    char first[4];
+    size_t n = upperFirst(word, first);
+    printf("%d. %.*s%s\n", ++*order, (int)n, first, word + n);
+    return 1;
+}
 
-    for(int i = 0; i < ALPHABET_SIZE; i++)
-    {
-        if(root->children[i]) 
-        {
-            buffer[depth] = 'a' + i;
-            printAllWordsTrieUtil(root->children[i], buffer, depth + 1);
-        }
-    }
+// Tampilkan beberapa kata pertama yang berawalan prefix
+void printCompletions(Dictionary *dict, const char *prefix)
+{
+    int order = 0;
+    if(!trieComplete(dict, prefix, TRIE_COMPLETE_LIMIT, printTrieWord, &order))
+        printf("Tidak ada kata berawalan '%s'.\n", prefix);
 }
 
-void printAllWordsTrie(TrieNode *root)
+static int printListedWord(const char *word, void *ctx)
 {
-    if(!root) return;
-    
-    char buffer[31];
+    int *order = (int *)ctx;
+    printf("%d. %s\n", ++*order, word);
+    return 1;
+}
 
-    for (int i = 0; i < ALPHABET_SIZE; i++)
-    {
-        if(root->children[i])
-        {
-            printf("\n---%c---\n", 'A' + i);
-            buffer[0] = 'A' + i;
-            printAllWordsTrieUtil(root->children[i], buffer, 1);    
-        }
-    }
+// Tampilkan kata utama yang mencantumkan word sebagai sinonim
+void printListedBy(Dictionary *dict, const char *word)
+{
+    int order = 0;
+    printf("Kata yang mencantumkan '%s':\n", word);
+    if(!synonymListedBy(dict, word, printListedWord, &order))
+        printf("Tidak ada kata yang mencantumkan '%s'.\n", word);
 }
 
-// Simpan data ke file
-void saveToFileSynonym(const char *filename)
+static int printRelatedWord(const char *word, int hops, void *ctx)
 {
-    FILE *file = fopen(filename, "w");
-    if (!file)
+    int *order = (int *)ctx;
+    printf("%d. %s (%d)\n", ++*order, word, hops);
+    return 1;
+}
+
+// Tampilkan kata yang terhubung dengan word paling jauh maxHops langkah,
+// beserta jaraknya
+void printRelated(Dictionary *dict, const char *word, int maxHops)
+{
+    int order = 0;
+    printf("Kata yang berhubungan dengan '%s' (jarak):\n", word);
+    if(!relatedWords(dict, word, maxHops, printRelatedWord, &order))
+        printf("Tidak ada kata yang berhubungan dengan '%s'.\n", word);
+}
+
+// Tampilkan kata di antara from dan to per halaman
+void printWordRange(Dictionary *dict, const char *from, const char *to)
+{
+    TrieCursor cursor;
+    if(!trieCursorInit(&cursor, from, to[0] ? to : NULL))
     {
-        printf("Failed to open file to save synonym.\n");
+        printf("Failed to allocate memory for range cursor.\n");
         return;
     }
 
-    for (int i = 0; i < HASH_SIZE; i++)
+    int order = 0;
+    while(trieCursorNext(dict, &cursor, TRIE_PAGE_SIZE, printTrieWord, &order) && !cursor.done)
     {
-        WordEntry *entry = hashTable[i];
-        while (entry)
-        {
-            fprintf(file, "%s :", entry->word);
-            SynonymNode *syn = entry->synonyms;
-            while (syn)
-            {
-                fprintf(file, " %s", syn->word);
-                if (syn->next)
-                    fprintf(file, ",");
-                syn = syn->next;
-            }
-            fprintf(file, "\n");
-            entry = entry->next;
-        }
+        printf("-- Enter untuk halaman berikutnya, q untuk berhenti --");
+        int c = getchar();
+        if(c != '\n') while (getchar() != '\n');
+        if(c == 'q' || c == 'Q') break;
     }
-    fclose(file);
+    if(order == 0) printf("Tidak ada kata di antara '%s' dan '%s'.\n", from, to);
+    trieCursorFree(&cursor);
 }
 
-// Free memory semua node
-void freeMemorySynonym(void)
+// Simpan data ke file; nama berakhiran SNAPSHOT_EXT ditulis sebagai snapshot biner.
+// Kata ditulis terurut, jadi menyimpan kamus yang sama selalu menghasilkan file
+// yang sama. File lama baru diganti setelah file baru lengkap. Mengembalikan 1
+// jika berhasil.
+int saveToFileSynonym(Dictionary *dict, const char *filename)
 {
-    for (int i = 0; i < HASH_SIZE; i++)
+    STATS_BEGIN(STATS_SAVE);
+    if(isSnapshotFile(filename))
     {
-        WordEntry *entry = hashTable[i];
-        while (entry)
-        {
-            WordEntry *temp = entry;
-            SynonymNode *syn = entry->synonyms;
-            while (syn)
-            {
-                SynonymNode *tempSyn = syn;
-                syn = syn->next;
-                free(tempSyn->word);
-                free(tempSyn);
-            }
-            entry = entry->next;
-            free(temp->word);
-            free(temp);
-        }
+        if(saveSnapshot(dict, filename)) return STATS_RETURN(STATS_SAVE, 1);
+        printf("Failed to save snapshot %s.\n", filename);
+        return STATS_RETURN(STATS_SAVE, 0);
     }
-}
-
-void freeTrieNode(TrieNode *root)
-{
-    if(root == NULL) return;
-    for(int i = 0; i < ALPHABET_SIZE; i++)
-        freeTrieNode(root->children[i]);
-    free(root);
-}
 
-// Fungsi untuk load data dari file
-void loadFromFileSynonym(const char *filename)
-{
-    const int condition = 0;
-    FILE *file = fopen(filename, "r");
+    char *tmpName;
+    FILE *file = openReplacement(filename, &tmpName);
     if (!file)
     {
-        printf("Failed to open file %s for synonym.\n", filename);
-        return;
+        printf("Failed to open file to save synonym.\n");
+        return STATS_RETURN(STATS_SAVE, 0);
     }
 
-    char line[1024];
-    while (fgets(line, sizeof(line), file))
+    WordIter it;
+    wordIterInit(dict, &it);
+    WordEntry *entry;
+    while ((entry = wordIterNext(dict, &it)))
     {
-        char *token;
-        char *word = strtok(line, ":\n");
-        if (word)
+        fprintf(file, "%s :", entry->word);
+        SynonymIter syn;
+        synonymIterInit(entry, &syn);
+        const char *synonym = synonymNext(&syn);
+        while (synonym)
         {
-            trim_and_tocapital(word);
-            addWord(word, condition);
-
-            token = strtok(NULL, "\n");
-            if (token)
-            {
-                char *synonym = strtok(token, ",");
-                while (synonym != NULL)
-                {
-                    while (*synonym == ' ')
-                        synonym++;
-                    addSynonym(word, synonym, condition);
-                    synonym = strtok(NULL, ",");
-                }
-            }
+            fprintf(file, " %s", synonym);
+            synonym = synonymNext(&syn);
+            if (synonym)
+                fprintf(file, ",");
         }
+        fprintf(file, "\n");
     }
-    fclose(file);
+    int complete = !it.failed && !snapshotDamaged(dict);  // kata di blok rusak tidak ikut tertulis
+    wordIterFree(&it);
+
+    if(commitReplacement(file, tmpName, filename, complete && !ferror(file))) return STATS_RETURN(STATS_SAVE, 1);
+    printf("Failed to save synonym to %s.\n", filename);
+    return STATS_RETURN(STATS_SAVE, 0);
+}
+
+// Free memory semua node: entry dan string ada di wordArena, jadi cukup
+// lepas blok-bloknya; hanya set sinonim yang besar yang di-free satu per satu.
+// String dari snapshot baru boleh dilepas setelah tidak ada yang memakainya,
+// dan entry snapshot dilepas closeSnapshot tanpa diisi dulu.
+void freeMemorySynonym(Dictionary *dict)
+{
+    epochShutdown(dict);
+
+    HashTableIter it;
+    hashTableIterInit(&it);
+    it.mapped = SIZE_MAX;
+    WordEntry *entry;
+    while((entry = hashTableNext(dict, &it))) free(entry->synonyms);
+
+    freeHashTable(dict);
+    graphReset(dict);
+    freeStringPool(dict);
+    closeSnapshot(dict);
+    arenaFree(&dict->wordArena);
+    slabReset(&dict->entrySlab);
+}
+
+// Baca satu jawaban dari stdin berapa pun panjangnya, tanpa '\n'. Jika
+// input habis atau memori tidak cukup, jawabannya kosong.
+static void readAnswer(char **line, size_t *cap)
+{
+    if(readLine(stdin, line, cap) <= 0) (*line)[0] = '\0';
 }
 
 // Main menu program
-void menu(void)
+void menu(Dictionary *dict)
 {
     int choice;
-    char word[100], synonym[100];
+    size_t wordCap = 256, synonymCap = 256;
+    char *word = (char *)malloc(wordCap), *synonym = (char *)malloc(synonymCap);
     const int condition = 1;
 
+    if(!word || !synonym)
+    {
+        fprintf(stderr, "Failed to allocate memory for menu input.\n");
+        free(word);
+        free(synonym);
+        return;
+    }
+
     do
     {
         printf("Menu:\n");
@@ -546,6 +512,13 @@ void menu(void)
         printf("7. Delete synonym from entry words\n");
         printf("8. View history\n");
         printf("9. Save and exit\n");
+        printf("10. Find words by prefix\n");
+        printf("11. View words between two words\n");
+        printf("12. Find entry words that list a synonym\n");
+        printf("13. Find related words\n");
+        printf("14. View history between two times\n");
+        printf("15. View history of a word\n");
+        printf("16. View statistics\n");
         printf("Pilihan: ");
         scanf("%d", &choice);
         getchar(); // consume newline
@@ -553,67 +526,123 @@ void menu(void)
         switch (choice)
         {
         case 1:
-            printAllWords();
+            printAllWords(dict);
             pauseProgram();
             break;
         case 2:
-            printAllWordsTrie(rootTrie);
+            printAllWordsTrie(dict);
             pauseProgram();
             break;
         case 3:
             printf("Enter entry word: ");
-            fgets(word, sizeof(word), stdin);
-            word[strcspn(word, "\n")] = 0;
+            readAnswer(&word, &wordCap);
             trim_and_tocapital(word);
-            printSynonyms(word);
+            printSynonyms(dict, word);
             break;
         case 4:
             printf("Enter new entry: ");
-            fgets(word, sizeof(word), stdin);
-            word[strcspn(word, "\n")] = 0;
+            readAnswer(&word, &wordCap);
             trim_and_tocapital(word);
-            addWord(word, condition);
+            addWord(dict, word, condition);
             break;
         case 5:
             printf("Enter entry word: ");
-            fgets(word, sizeof(word), stdin);
-            word[strcspn(word, "\n")] = 0;
+            readAnswer(&word, &wordCap);
             trim_and_tocapital(word);
 
             printf("Enter new synoynm word: ");
-            fgets(synonym, sizeof(synonym), stdin);
-            synonym[strcspn(synonym, "\n")] = 0;
+            readAnswer(&synonym, &synonymCap);
             trim_and_tocapital(synonym);
-            addSynonym(word, synonym, condition);
+            addSynonym(dict, word, synonym, condition);
             break;
         case 6:
             printf("Enter entry word for delete: ");
-            fgets(word, sizeof(word), stdin);
-            word[strcspn(word, "\n")] = 0;
+            readAnswer(&word, &wordCap);
             trim_and_tocapital(word);
-            deleteWordEntry(word);
+            deleteWordEntry(dict, word);
             break;
         case 7:
             printf("Enter entry word: ");
-            fgets(word, sizeof(word) ,stdin);
-            word[strcspn(word, "\n")] = 0;
+            readAnswer(&word, &wordCap);
             trim_and_tocapital(word); 
 
             printf("Enter synonym word to delete: ");
-            fgets(synonym, sizeof(synonym), stdin);
-            synonym[strcspn(synonym, "\n")] = 0;
+            readAnswer(&synonym, &synonymCap);
             trim_and_tocapital(synonym);
 
-            deleteSynonym(word, synonym);
+            deleteSynonym(dict, word, synonym);
             break;
         case 8:
-            printHistory();
+            printHistory(dict);
             pauseProgram();
             break;
         case 9:
-            saveToFileSynonym(SYNONYM_FILE);
-            saveToFileHistory(HISTORY_FILE);
-            printf("Data disimpan.\n");
+            // semua perubahan sudah ada di log, cukup pastikan log sampai ke disk
+            if(walSync(dict)) printf("Data disimpan.\n");
+            else printf("Failed to write %s.\n", dict->walFile);
+            break;
+        case 10:
+            printf("Enter prefix: ");
+            readAnswer(&word, &wordCap);
+            trim(word);
+            printCompletions(dict, word);
+            pauseProgram();
+            break;
+        case 11:
+            printf("Enter first word: ");
+            readAnswer(&word, &wordCap);
+            trim(word);
+
+            printf("Enter last word (empty = until the end): ");
+            readAnswer(&synonym, &synonymCap);
+            trim(synonym);
+
+            printWordRange(dict, word, synonym);
+            pauseProgram();
+            break;
+        case 12:
+            printf("Enter synonym word: ");
+            readAnswer(&word, &wordCap);
+            trim_and_tocapital(word);
+            printListedBy(dict, word);
+            pauseProgram();
+            break;
+        case 13:
+        {
+            int hops = 0;
+            printf("Enter word: ");
+            readAnswer(&word, &wordCap);
+            trim_and_tocapital(word);
+
+            printf("Enter maximum hops: ");
+            scanf("%d", &hops);
+            getchar(); // consume newline
+            printRelated(dict, word, hops);
+            pauseProgram();
+            break;
+        }
+        case 14:
+            printf("Enter start time (YYYY-MM-DD [HH:MM:SS]): ");
+            readAnswer(&word, &wordCap);
+            trim(word);
+
+            printf("Enter end time (empty = now): ");
+            readAnswer(&synonym, &synonymCap);
+            trim(synonym);
+
+            printHistoryBetween(dict, word, synonym);
+            pauseProgram();
+            break;
+        case 15:
+            printf("Enter word: ");
+            readAnswer(&word, &wordCap);
+            trim_and_tocapital(word);
+            printHistoryForWord(dict, word);
+            pauseProgram();
+            break;
+        case 16:
+            printStats(dict, stdout);
+            pauseProgram();
             break;
         default:
             printf("Pilihan tidak valid.\n");
@@ -621,4 +650,7 @@ void menu(void)
         sleep(1);
         clearScreen();
     } while (choice != 9);
+
+    free(word);
+    free(synonym);
 }
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dictionary.h"
+
+// Himpunan sinonim per kata utama.
+//
+// Sampai SYNONYM_INLINE sinonim disimpan langsung di WordEntry dan dicari
+// dengan membandingkan pointer satu per satu. Setelah itu sinonim pindah ke
+// SynonymSet: array items sesuai urutan ditambahkan plus index hash
+// (pointer ter-intern -> posisi), jadi cek duplikat, tambah, dan hapus
+// semuanya O(1).
+//
+// Sinonim yang dihapus hanya diganti NULL di tempatnya, tidak digeser, jadi
+// pembaca tanpa lock (synonymIterInit/synonymNext) tidak pernah melihat
+// urutan yang berubah di tengah jalan. Slot NULL dibuang saat set dibangun
+// ulang karena penuh; set lama dipensiunkan lewat epoch (lihat epoch.c).
+// Fungsi yang mengubah set dipanggil dengan dictWriteBegin dipegang.
+
+static size_t setBytes(uint32_t cap, uint32_t indexSize)
+{
+    return sizeof(SynonymSet) + cap * sizeof(const char *) + indexSize * sizeof(uint32_t);
+}
+
+// Index paling sedikit dua kali kapasitas, jadi terisi paling banyak setengah
+static uint32_t indexSizeFor(uint32_t cap)
+{
+    uint32_t size = 8;
+    while(size < cap * 2) size <<= 1;
+    return size;
+}
+
+// Posisi word di items, -1 jika tidak ada. Slot index yang posisinya sudah
+// NULL tetap dilewati supaya rantai probe tidak putus.
+static long setFind(const SynonymSet *set, const char *word)
+{
+    for(size_t i = pointerHash(word) & set->mask; set->index[i]; i = (i + 1) & set->mask)
+        if(set->items[set->index[i] - 1] == word) return (long)set->index[i] - 1;
+    return -1;
+}
+
+// Tambah word di akhir items; word belum ada dan used < cap
+static void setPut(SynonymSet *set, const char *word)
+{
+    size_t i = pointerHash(word) & set->mask;
+    while(set->index[i] && set->items[set->index[i] - 1]) i = (i + 1) & set->mask;
+
+    set->items[set->used] = word;
+    set->index[i] = set->used + 1;
+    set->count++;
+    STORE_RELEASE(&set->used, set->used + 1);
+}
+
+// Set baru berkapasitas cap berisi sinonim yang masih ada dari items[0..used), urutan tetap
+static SynonymSet *buildSet(const char *const *items, uint32_t used, uint32_t cap)
+{
+    uint32_t indexSize = indexSizeFor(cap);
+    SynonymSet *set = (SynonymSet *)malloc(setBytes(cap, indexSize));
+    if(!set) return NULL;
+    STATS_COUNT(STATS_SET_ALLOCS, 1);
+
+    set->count = 0;
+    set->used = 0;
+    set->cap = cap;
+    set->mask = indexSize - 1;
+    set->index = (uint32_t *)(set->items + cap);
+    memset(set->index, 0, indexSize * sizeof(uint32_t));
+
+    for(uint32_t i = 0; i < used; i++)
+        if(items[i]) setPut(set, items[i]);
+    return set;
+}
+
+// Pindahkan sinonim entry ke set baru berkapasitas cap lalu umumkan ke pembaca
+static SynonymSet *rebuildSet(Dictionary *dict, WordEntry *entry, uint32_t cap)
+{
+    SynonymSet *old = entry->synonyms;
+    SynonymSet *set = old ? buildSet(old->items, old->used, cap)
+                          : buildSet(entry->inlineSynonyms, entry->inlineUsed, cap);
+    if(!set)
+    {
+        fprintf(stderr, "Failed to allocate memory for synonyms.\n");
+        return NULL;
+    }
+
+    // sinonim inline dibiarkan: pembaca yang sedang membacanya tetap benar
+    STORE_RELEASE(&entry->synonyms, set);
+    if(old) retireNode(dict, NULL, old);
+    return set;
+}
+
+size_t synonymCount(const WordEntry *entry)
+{
+    return entry->synonyms ? entry->synonyms->count : entry->inlineCount;
+}
+
+// 1 jika entry punya sinonim interned (dibandingkan pointernya)
+int synonymContains(const WordEntry *entry, const char *interned)
+{
+    if(entry->synonyms) return setFind(entry->synonyms, interned) >= 0;
+
+    for(uint32_t i = 0; i < entry->inlineUsed; i++)
+        if(entry->inlineSynonyms[i] == interned) return 1;
+    return 0;
+}
+
+// Siapkan tempat untuk count sinonim tambahan sekaligus (mis. satu baris file)
+void synonymReserve(Dictionary *dict, WordEntry *entry, size_t count)
+{
+    SynonymSet *set = entry->synonyms;
+    if(!set && entry->inlineUsed + count <= SYNONYM_INLINE) return;
+    if(set && set->used + count <= set->cap) return;
+    rebuildSet(dict, entry, (uint32_t)(synonymCount(entry) + count));
+}
+
+// Tambahkan sinonim interned; 0 jika sudah ada atau gagal alokasi
+int synonymInsert(Dictionary *dict, WordEntry *entry, const char *interned)
+{
+    if(synonymContains(entry, interned)) return 0;
+
+    SynonymSet *set = entry->synonyms;
+    if(!set && entry->inlineUsed < SYNONYM_INLINE)
+    {
+        entry->inlineSynonyms[entry->inlineUsed] = interned;
+        entry->inlineCount++;
+        STORE_RELEASE(&entry->inlineUsed, entry->inlineUsed + 1);
+        return 1;
+    }
+
+    if(!set || set->used == set->cap)
+    {
+        uint32_t cap = (uint32_t)(synonymCount(entry) + 1) * 2;
+        if(cap < SYNONYM_INLINE * 2) cap = SYNONYM_INLINE * 2;
+        if(!(set = rebuildSet(dict, entry, cap))) return 0;
+    }
+    setPut(set, interned);
+    return 1;
+}
+
+// Hapus sinonim interned; 0 jika tidak ada
+int synonymErase(WordEntry *entry, const char *interned)
+{
+    SynonymSet *set = entry->synonyms;
+    if(set)
+    {
+        long pos = setFind(set, interned);
+        if(pos < 0) return 0;
+        STORE_RELEASE(&set->items[pos], NULL);
+        set->count--;
+        return 1;
+    }
+
+    for(uint32_t i = 0; i < entry->inlineUsed; i++)
+    {
+        if(entry->inlineSynonyms[i] != interned) continue;
+        STORE_RELEASE(&entry->inlineSynonyms[i], NULL);
+        entry->inlineCount--;
+        return 1;
+    }
+    return 0;
+}
+
+// Pembaca boleh memakai iterator tanpa lock di dalam dictReadBegin/dictReadEnd.
+// Urutannya dari sinonim terbaru ke yang terlama.
+void synonymIterInit(const WordEntry *entry, SynonymIter *it)
+{
+    SynonymSet *set = LOAD_ACQUIRE(&entry->synonyms);
+    if(set)
+    {
+        it->items = set->items;
+        it->next = LOAD_ACQUIRE(&set->used);
+    }
+    else
+    {
+        it->items = entry->inlineSynonyms;
+        it->next = LOAD_ACQUIRE(&entry->inlineUsed);
+    }
+}
+
+const char *synonymNext(SynonymIter *it)
+{
+    while(it->next > 0)
+    {
+        const char *word = LOAD_ACQUIRE(&it->items[--it->next]);
+        if(word) return word;
+    }
+    return NULL;
+}
+
+// Byte heap milik set sinonim entry, 0 selama sinonimnya inline
+size_t synonymSetBytes(const WordEntry *entry)
+{
+    const SynonymSet *set = entry->synonyms;
+    return set ? setBytes(set->cap, set->mask + 1) : 0;
+}
@@ -0,0 +1,651 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "dictionary.h"
+
+// Normalisasi dan hash kata: trim, huruf kecil/kapital, dan djb2.
+//
+// Setiap fungsi punya versi skalar dan, di x86, versi SSE2 dan AVX2 yang
+// dipilih sekali saat pertama dipakai sesuai CPU. Semua versi memberi hasil
+// yang sama persis dengan versi skalar: spasi = isspace di locale "C"
+// (' ', \t, \n, \v, \f, \r), huruf kecil A-Z dikerjakan kernel, dan djb2
+// memakai char bertanda seperti sebelumnya.
+//
+// Kata berisi byte >= 0x80 dibaca sebagai UTF-8 oleh foldUtf8 setelah
+// kernel: huruf Latin, Yunani dan Kiril dijadikan huruf kecil, dan huruf
+// ASCII yang diikuti tanda diakritik gabung (mis. "e" + U+0301) disatukan
+// menjadi huruf jadinya ("é"), seperti NFC. Pasangan huruf besar/kecil yang
+// dipakai selalu sama panjang dalam UTF-8, jadi semuanya bisa di tempat.
+// Urutan byte yang bukan UTF-8 sah dibiarkan apa adanya.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(__CHAR_UNSIGNED__)
+#define TEXT_SIMD 1
+#include <immintrin.h>
+#endif
+
+#define DJB2_SEED 5381
+
+enum { KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2 };
+
+typedef struct TextKernels
+{
+    const char *name;
+    int isa;
+    size_t (*skipSpace)(const char *s, size_t len);     // indeks byte bukan spasi pertama
+    size_t (*trimEnd)(const char *s, size_t len);       // panjang tanpa spasi di belakang
+    size_t (*lower)(char *s, size_t len);               // indeks byte >= 0x80 pertama, atau len
+    unsigned int (*hash)(unsigned int h, const char *s, size_t len);
+} TextKernels;
+
+static int isSpaceByte(unsigned char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static size_t skipSpaceScalar(const char *s, size_t len)
+{
+    size_t i = 0;
+    while(i < len && isSpaceByte((unsigned char)s[i])) i++;
+    return i;
+}
+
+static size_t trimEndScalar(const char *s, size_t len)
+{
+    while(len > 0 && isSpaceByte((unsigned char)s[len - 1])) len--;
+    return len;
+}
+
+static size_t lowerScalar(char *s, size_t len)
+{
+    size_t high = len;
+    for(size_t i = 0; i < len; i++)
+    {
+        if(s[i] >= 'A' && s[i] <= 'Z') s[i] += 'a' - 'A';
+        else if((unsigned char)s[i] >= 0x80 && high == len) high = i;
+    }
+    return high;
+}
+
+static unsigned int hashScalar(unsigned int h, const char *s, size_t len)
+{
+    for(size_t i = 0; i < len; i++)
+    {
+        int c = s[i];
+        h = ((h << 5) + h) + c;
+    }
+    return h;
+}
+
+#ifdef TEXT_SIMD
+
+// 33^n mod 2^32, untuk menggabungkan hash beberapa blok sekaligus
+static const unsigned int pow33[33] = {
+    1u, 33u, 1089u, 35937u,
+    1185921u, 39135393u, 1291467969u, 3963737313u,
+    1954312449u, 67801377u, 2237445441u, 821255521u,
+    1331628417u, 994064801u, 2739367361u, 204809697u,
+    2463752705u, 3994427937u, 2967103041u, 3425119841u,
+    1359805057u, 1923893921u, 3358957249u, 3471406817u,
+    2887275265u, 790803233u, 326702913u, 2191261537u,
+    3592153985u, 2576964513u, 3435450305u, 1700710369u,
+    288867329u,
+};
+
+// Versi SSE2 juga dipakai untuk sisa < 32 byte di versi AVX2. Disisipkan
+// (always_inline) supaya di sana ikut dikompilasi dengan encoding VEX:
+// memanggil kode SSE lama dari kode AVX membuat CPU menunggu transisi.
+#define SSE2_KERNEL static inline __attribute__((target("sse2"), always_inline))
+
+// Byte spasi diubah ke -128..-124 (\t..\r) lalu dibandingkan bertanda,
+// karena SSE2/AVX2 tidak punya perbandingan byte tak bertanda
+SSE2_KERNEL unsigned int spaceMask16(const char *s)
+{
+    __m128i v = _mm_loadu_si128((const __m128i *)s);
+    __m128i space = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    __m128i ctrl = _mm_cmplt_epi8(_mm_add_epi8(v, _mm_set1_epi8((char)(128 - '\t'))),
+                                  _mm_set1_epi8((char)(-128 + 5)));
+    return (unsigned int)_mm_movemask_epi8(_mm_or_si128(space, ctrl));
+}
+
+SSE2_KERNEL size_t skipSpaceSse2(const char *s, size_t len)
+{
+    size_t i = 0;
+    for(; i + 16 <= len; i += 16)
+    {
+        unsigned int other = ~spaceMask16(s + i) & 0xFFFF;
+        if(other) return i + __builtin_ctz(other);
+    }
+    return i + skipSpaceScalar(s + i, len - i);
+}
+
+SSE2_KERNEL size_t trimEndSse2(const char *s, size_t len)
+{
+    for(; len >= 16; len -= 16)
+    {
+        unsigned int other = ~spaceMask16(s + len - 16) & 0xFFFF;
+        if(other) return len - 16 + (32 - __builtin_clz(other));
+    }
+    return trimEndScalar(s, len);
+}
+
+// A-Z digeser ke -128..-103 supaya bisa dipilih dengan satu perbandingan bertanda
+SSE2_KERNEL size_t lowerSse2(char *s, size_t len)
+{
+    size_t i = 0, high = len;
+    for(; i + 16 <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i upper = _mm_cmplt_epi8(_mm_add_epi8(v, _mm_set1_epi8((char)(128 - 'A'))),
+                                       _mm_set1_epi8((char)(-128 + 26)));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(v);
+        if(mask && high == len) high = i + __builtin_ctz(mask);
+        v = _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+        _mm_storeu_si128((__m128i *)(s + i), v);
+    }
+    size_t rest = lowerScalar(s + i, len - i);
+    return high < len ? high : i + rest;
+}
+
+// SSE2 tidak punya perkalian 32-bit per lane; dua _mm_mul_epu32 untuk lane genap dan ganjil
+SSE2_KERNEL __m128i mulLo32(__m128i a, __m128i b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// djb2 per blok 16 byte: h' = h * 33^16 + sum(c[i] * 33^(15 - i)).
+// Dua _mm_madd_epi16 menggabungkan byte menjadi 4 lane (masing-masing 4
+// byte), lane itu dijumlah lintas blok dengan faktor 33^16, dan bobot
+// 33^12, 33^8, 33^4, 1 baru dipakai sekali di akhir.
+SSE2_KERNEL unsigned int hashSse2(unsigned int h, const char *s, size_t len)
+{
+    if(len < 16) return hashScalar(h, s, len);
+
+    const __m128i pairs = _mm_set1_epi32((1 << 16) | 33);          // c0 * 33 + c1
+    const __m128i quads = _mm_set1_epi32((1 << 16) | (33 * 33));   // d0 * 33^2 + d1
+    const unsigned int p16 = pow33[16];
+    const __m128i step = _mm_set1_epi32((int)p16);
+    __m128i acc = _mm_setzero_si128();
+
+    size_t i = 0;
+    for(; i + 16 <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);   // char bertanda -> 16 bit
+        __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8);
+        __m128i d = _mm_packs_epi32(_mm_madd_epi16(lo, pairs), _mm_madd_epi16(hi, pairs));
+        acc = _mm_add_epi32(mulLo32(acc, step), _mm_madd_epi16(d, quads));
+        h *= p16;
+    }
+
+    unsigned int lanes[4];
+    _mm_storeu_si128((__m128i *)lanes, acc);
+    h += lanes[0] * pow33[12] + lanes[1] * pow33[8] + lanes[2] * pow33[4] + lanes[3];
+    return hashScalar(h, s + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static unsigned int spaceMask32(const char *s)
+{
+    __m256i v = _mm256_loadu_si256((const __m256i *)s);
+    __m256i space = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+    __m256i ctrl = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-128 + 5)),
+                                     _mm256_add_epi8(v, _mm256_set1_epi8((char)(128 - '\t'))));
+    return (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(space, ctrl));
+}
+
+__attribute__((target("avx2")))
+static size_t skipSpaceAvx2(const char *s, size_t len)
+{
+    size_t i = 0;
+    for(; i + 32 <= len; i += 32)
+    {
+        unsigned int other = ~spaceMask32(s + i);
+        if(other) return i + __builtin_ctz(other);
+    }
+    return i + skipSpaceSse2(s + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static size_t trimEndAvx2(const char *s, size_t len)
+{
+    for(; len >= 32; len -= 32)
+    {
+        unsigned int other = ~spaceMask32(s + len - 32);
+        if(other) return len - 32 + (32 - __builtin_clz(other));
+    }
+    return trimEndSse2(s, len);
+}
+
+__attribute__((target("avx2")))
+static size_t lowerAvx2(char *s, size_t len)
+{
+    size_t i = 0, high = len;
+    for(; i + 32 <= len; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-128 + 26)),
+                                          _mm256_add_epi8(v, _mm256_set1_epi8((char)(128 - 'A'))));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(v);
+        if(mask && high == len) high = i + __builtin_ctz(mask);
+        v = _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+        _mm256_storeu_si256((__m256i *)(s + i), v);
+    }
+    size_t rest = lowerSse2(s + i, len - i);
+    return high < len ? high : i + rest;
+}
+
+// Seperti hashSse2, tapi 32 byte per putaran dengan dua akumulator 8 lane
+// (masing-masing 2 byte per lane) supaya latensi perkalian tidak berantai
+__attribute__((target("avx2")))
+static unsigned int hashAvx2(unsigned int h, const char *s, size_t len)
+{
+    if(len < 32) return hashSse2(h, s, len);
+
+    const __m256i pairs = _mm256_set1_epi32((1 << 16) | 33);
+    const unsigned int p32 = pow33[32];
+    const __m256i step = _mm256_set1_epi32((int)p32);
+    __m256i first = _mm256_setzero_si256(), second = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for(; i + 32 <= len; i += 32)
+    {
+        __m256i a = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(s + i)));
+        __m256i b = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(s + i + 16)));
+        first = _mm256_add_epi32(_mm256_mullo_epi32(first, step), _mm256_madd_epi16(a, pairs));
+        second = _mm256_add_epi32(_mm256_mullo_epi32(second, step), _mm256_madd_epi16(b, pairs));
+        h *= p32;
+    }
+
+    unsigned int lanesFirst[8], lanesSecond[8];
+    _mm256_storeu_si256((__m256i *)lanesFirst, first);
+    _mm256_storeu_si256((__m256i *)lanesSecond, second);
+    for(int k = 0; k < 8; k++)
+        h += lanesFirst[k] * pow33[30 - 2 * k] + lanesSecond[k] * pow33[14 - 2 * k];
+    return hashSse2(h, s + i, len - i);
+}
+
+#endif /* TEXT_SIMD */
+
+static const TextKernels kernelTable[] = {
+    {"scalar", KERNEL_SCALAR, skipSpaceScalar, trimEndScalar, lowerScalar, hashScalar},
+#ifdef TEXT_SIMD
+    {"sse2", KERNEL_SSE2, skipSpaceSse2, trimEndSse2, lowerSse2, hashSse2},
+    {"avx2", KERNEL_AVX2, skipSpaceAvx2, trimEndAvx2, lowerAvx2, hashAvx2},
+#endif
+};
+
+#define KERNEL_COUNT (sizeof(kernelTable) / sizeof(kernelTable[0]))
+
+static const TextKernels *activeKernels;
+
+static int kernelSupported(const TextKernels *k)
+{
+#ifdef TEXT_SIMD
+    __builtin_cpu_init();
+    if(k->isa == KERNEL_SSE2) return __builtin_cpu_supports("sse2");
+    if(k->isa == KERNEL_AVX2) return __builtin_cpu_supports("avx2");
+#endif
+    return k->isa == KERNEL_SCALAR;
+}
+
+// Versi terbaik yang didukung CPU, atau SYNONYM_TEXT_KERNEL jika diisi.
+// Beberapa thread boleh memilih bersamaan: hasilnya selalu sama.
+static const TextKernels *textKernels(void)
+{
+    const TextKernels *k = LOAD_ACQUIRE(&activeKernels);
+    if(k) return k;
+
+    k = &kernelTable[0];
+    for(size_t i = 1; i < KERNEL_COUNT; i++)
+        if(kernelSupported(&kernelTable[i])) k = &kernelTable[i];
+
+    const char *env = getenv("SYNONYM_TEXT_KERNEL");
+    for(size_t i = 0; env && i < KERNEL_COUNT; i++)
+        if(strcmp(env, kernelTable[i].name) == 0 && kernelSupported(&kernelTable[i])) k = &kernelTable[i];
+
+    STORE_RELEASE(&activeKernels, k);
+    return k;
+}
+
+const char *textKernelName(void)
+{
+    return textKernels()->name;
+}
+
+// Pilih versi kernel ("scalar", "sse2", "avx2"); 0 jika tidak ada atau tidak didukung CPU
+int textUseKernel(const char *name)
+{
+    for(size_t i = 0; i < KERNEL_COUNT; i++)
+    {
+        if(strcmp(name, kernelTable[i].name) != 0) continue;
+        if(!kernelSupported(&kernelTable[i])) return 0;
+        STORE_RELEASE(&activeKernels, &kernelTable[i]);
+        return 1;
+    }
+    return 0;
+}
+
+// UTF-8 ---------------------------------------------------------------
+
+// Huruf kecil (base) + tanda diakritik gabung (mark) -> huruf jadi, dari
+// komposisi NFC Unicode, dibatasi ke huruf Latin sampai U+024F. Terurut
+// menurut mark lalu base.
+static const struct
+{
+    uint16_t mark;
+    char base;
+    uint16_t composed;
+} composeTable[] = {
+    {0x0300, 'a', 0x00E0}, {0x0300, 'e', 0x00E8}, {0x0300, 'i', 0x00EC}, {0x0300, 'n', 0x01F9}, {0x0300, 'o', 0x00F2},
+    {0x0300, 'u', 0x00F9},
+    {0x0301, 'a', 0x00E1}, {0x0301, 'c', 0x0107}, {0x0301, 'e', 0x00E9}, {0x0301, 'g', 0x01F5}, {0x0301, 'i', 0x00ED},
+    {0x0301, 'l', 0x013A}, {0x0301, 'n', 0x0144}, {0x0301, 'o', 0x00F3}, {0x0301, 'r', 0x0155}, {0x0301, 's', 0x015B},
+    {0x0301, 'u', 0x00FA}, {0x0301, 'y', 0x00FD}, {0x0301, 'z', 0x017A},
+    {0x0302, 'a', 0x00E2}, {0x0302, 'c', 0x0109}, {0x0302, 'e', 0x00EA}, {0x0302, 'g', 0x011D}, {0x0302, 'h', 0x0125},
+    {0x0302, 'i', 0x00EE}, {0x0302, 'j', 0x0135}, {0x0302, 'o', 0x00F4}, {0x0302, 's', 0x015D}, {0x0302, 'u', 0x00FB},
+    {0x0302, 'w', 0x0175}, {0x0302, 'y', 0x0177},
+    {0x0303, 'a', 0x00E3}, {0x0303, 'i', 0x0129}, {0x0303, 'n', 0x00F1}, {0x0303, 'o', 0x00F5}, {0x0303, 'u', 0x0169},
+    {0x0304, 'a', 0x0101}, {0x0304, 'e', 0x0113}, {0x0304, 'i', 0x012B}, {0x0304, 'o', 0x014D}, {0x0304, 'u', 0x016B},
+    {0x0304, 'y', 0x0233},
+    {0x0306, 'a', 0x0103}, {0x0306, 'e', 0x0115}, {0x0306, 'g', 0x011F}, {0x0306, 'i', 0x012D}, {0x0306, 'o', 0x014F},
+    {0x0306, 'u', 0x016D},
+    {0x0307, 'a', 0x0227}, {0x0307, 'c', 0x010B}, {0x0307, 'e', 0x0117}, {0x0307, 'g', 0x0121}, {0x0307, 'o', 0x022F},
+    {0x0307, 'z', 0x017C},
+    {0x0308, 'a', 0x00E4}, {0x0308, 'e', 0x00EB}, {0x0308, 'i', 0x00EF}, {0x0308, 'o', 0x00F6}, {0x0308, 'u', 0x00FC},
+    {0x0308, 'y', 0x00FF},
+    {0x030A, 'a', 0x00E5}, {0x030A, 'u', 0x016F},
+    {0x030B, 'o', 0x0151}, {0x030B, 'u', 0x0171},
+    {0x030C, 'a', 0x01CE}, {0x030C, 'c', 0x010D}, {0x030C, 'd', 0x010F}, {0x030C, 'e', 0x011B}, {0x030C, 'g', 0x01E7},
+    {0x030C, 'h', 0x021F}, {0x030C, 'i', 0x01D0}, {0x030C, 'j', 0x01F0}, {0x030C, 'k', 0x01E9}, {0x030C, 'l', 0x013E},
+    {0x030C, 'n', 0x0148}, {0x030C, 'o', 0x01D2}, {0x030C, 'r', 0x0159}, {0x030C, 's', 0x0161}, {0x030C, 't', 0x0165},
+    {0x030C, 'u', 0x01D4}, {0x030C, 'z', 0x017E},
+    {0x031B, 'o', 0x01A1}, {0x031B, 'u', 0x01B0},
+    {0x0326, 's', 0x0219}, {0x0326, 't', 0x021B},
+    {0x0327, 'c', 0x00E7}, {0x0327, 'e', 0x0229}, {0x0327, 'g', 0x0123}, {0x0327, 'k', 0x0137}, {0x0327, 'l', 0x013C},
+    {0x0327, 'n', 0x0146}, {0x0327, 'r', 0x0157}, {0x0327, 's', 0x015F}, {0x0327, 't', 0x0163},
+    {0x0328, 'a', 0x0105}, {0x0328, 'e', 0x0119}, {0x0328, 'i', 0x012F}, {0x0328, 'o', 0x01EB}, {0x0328, 'u', 0x0173},
+};
+
+#define COMPOSE_COUNT (sizeof(composeTable) / sizeof(composeTable[0]))
+
+static uint32_t composeMark(char base, uint32_t mark)
+{
+    size_t lo = 0, hi = COMPOSE_COUNT;
+    while(lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        int cmp = composeTable[mid].mark != mark ? (composeTable[mid].mark < mark ? -1 : 1)
+                                                 : composeTable[mid].base - base;
+        if(cmp == 0) return composeTable[mid].composed;
+        if(cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return 0;
+}
+
+// Satu karakter dari s (len > 0); *size = panjangnya dalam byte. Urutan yang
+// tidak sah (termasuk encoding terlalu panjang dan surrogate) dibaca sebagai
+// satu byte dengan kode -1.
+static int32_t utf8Decode(const unsigned char *s, size_t len, size_t *size)
+{
+    *size = 1;
+    if(s[0] < 0x80) return s[0];
+
+    size_t n = s[0] >= 0xF0 ? 4 : s[0] >= 0xE0 ? 3 : s[0] >= 0xC2 ? 2 : 0;
+    if(n == 0 || s[0] > 0xF4 || n > len) return -1;
+    int32_t c = s[0] & (0x7F >> n);
+    for(size_t i = 1; i < n; i++)
+    {
+        if((s[i] & 0xC0) != 0x80) return -1;
+        c = (c << 6) | (s[i] & 0x3F);
+    }
+    if((n == 3 && c < 0x800) || (n == 4 && (c < 0x10000 || c > 0x10FFFF)) || (c >= 0xD800 && c <= 0xDFFF))
+        return -1;
+    *size = n;
+    return c;
+}
+
+static size_t utf8Encode(uint32_t c, char *out)
+{
+    if(c < 0x80)
+    {
+        out[0] = (char)c;
+        return 1;
+    }
+    if(c < 0x800)
+    {
+        out[0] = (char)(0xC0 | (c >> 6));
+        out[1] = (char)(0x80 | (c & 0x3F));
+        return 2;
+    }
+    if(c < 0x10000)
+    {
+        out[0] = (char)(0xE0 | (c >> 12));
+        out[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (c & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (c >> 18));
+    out[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (c & 0x3F));
+    return 4;
+}
+
+// Pasangan huruf besar/kecil yang berselang-seling: besar di kode genap
+// (odd = 0) atau ganjil (odd = 1)
+static int inAlternating(uint32_t c, uint32_t from, uint32_t to, int odd)
+{
+    return c >= from && c <= to && (int)(c & 1) == odd;
+}
+
+// Huruf kecil dari c, atau c sendiri jika tidak punya pasangan yang sama
+// panjang. Latin-1, Latin Extended-A/B (sebagian), Latin Extended
+// Additional (Vietnam), Yunani dan Kiril. Sigma akhir dilipat ke σ seperti
+// case folding Unicode, supaya "ΟΔΌΣ" dan "οδός" menjadi kata yang sama.
+static uint32_t lowerCodepoint(uint32_t c)
+{
+    if(c < 0x80) return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+    if(c >= 0xC0 && c <= 0xDE && c != 0xD7) return c + 0x20;
+    if(c == 0x178) return 0xFF;
+    if(inAlternating(c, 0x100, 0x12F, 0) || inAlternating(c, 0x132, 0x137, 0) ||
+       inAlternating(c, 0x139, 0x148, 1) || inAlternating(c, 0x14A, 0x177, 0) ||
+       inAlternating(c, 0x179, 0x17E, 1) || inAlternating(c, 0x200, 0x21F, 0) ||
+       inAlternating(c, 0x222, 0x233, 0) || inAlternating(c, 0x1E00, 0x1E95, 0) ||
+       inAlternating(c, 0x1EA0, 0x1EFF, 0))
+        return c + 1;
+    switch(c)
+    {
+    case 0x386: return 0x3AC;
+    case 0x388: return 0x3AD;
+    case 0x389: return 0x3AE;
+    case 0x38A: return 0x3AF;
+    case 0x38C: return 0x3CC;
+    case 0x38E: return 0x3CD;
+    case 0x38F: return 0x3CE;
+    case 0x3C2: return 0x3C3;
+    }
+    if(c >= 0x391 && c <= 0x3AB && c != 0x3A2) return c + 0x20;
+    if(c >= 0x410 && c <= 0x42F) return c + 0x20;
+    if(c >= 0x400 && c <= 0x40F) return c + 0x50;
+    return c;
+}
+
+// Kebalikan lowerCodepoint, ditambah sigma akhir (ς -> Σ)
+static uint32_t upperCodepoint(uint32_t c)
+{
+    if(c < 0x80) return c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c;
+    if(c >= 0xE0 && c <= 0xFE && c != 0xF7) return c - 0x20;
+    if(c == 0xFF) return 0x178;
+    if(inAlternating(c, 0x101, 0x12F, 1) || inAlternating(c, 0x133, 0x137, 1) ||
+       inAlternating(c, 0x13A, 0x148, 0) || inAlternating(c, 0x14B, 0x177, 1) ||
+       inAlternating(c, 0x17A, 0x17E, 0) || inAlternating(c, 0x201, 0x21F, 1) ||
+       inAlternating(c, 0x223, 0x233, 1) || inAlternating(c, 0x1E01, 0x1E95, 1) ||
+       inAlternating(c, 0x1EA1, 0x1EFF, 1))
+        return c - 1;
+    switch(c)
+    {
+    case 0x3AC: return 0x386;
+    case 0x3AD: return 0x388;
+    case 0x3AE: return 0x389;
+    case 0x3AF: return 0x38A;
+    case 0x3CC: return 0x38C;
+    case 0x3CD: return 0x38E;
+    case 0x3CE: return 0x38F;
+    case 0x3C2: return 0x3A3;
+    }
+    if(c >= 0x3B1 && c <= 0x3CB && c != 0x3C2) return c - 0x20;
+    if(c >= 0x430 && c <= 0x44F) return c - 0x20;
+    if(c >= 0x450 && c <= 0x45F) return c - 0x50;
+    return c;
+}
+
+// Byte awal karakter yang mungkin diubah foldUtf8: U+00C0..U+043F (Latin,
+// tanda diakritik gabung, Yunani, Kiril) dan U+1xxx (Latin Extended
+// Additional). Byte lanjutan tidak pernah termasuk.
+static int mayFold(unsigned char c)
+{
+    return (c >= 0xC3 && c <= 0xD0) || c == 0xE1;
+}
+
+// Bagian UTF-8 dari normalisasi, setelah kernel mengecilkan A-Z; from =
+// byte >= 0x80 pertama. Di tempat, dan hasilnya tidak pernah lebih panjang:
+// byte yang pasti tidak berubah dilompati (atau digeser sekaligus setelah
+// ada yang memendek). Mengembalikan panjang baru.
+static size_t foldUtf8(char *s, size_t len, size_t from)
+{
+    const unsigned char *in = (const unsigned char *)s;
+    size_t r = from, w = from;
+    while(r < len)
+    {
+        // ASCII sudah dikecilkan kernel: lompati 8 byte sekaligus
+        size_t start = r;
+        for(uint64_t block; r + 8 <= len; r += 8)
+        {
+            memcpy(&block, in + r, 8);
+            if(block & 0x8080808080808080ULL) break;
+        }
+        while(r < len && !mayFold(in[r])) r++;
+        if(w != start) memmove(s + w, s + start, r - start);
+        w += r - start;
+        if(r == len) break;
+
+        size_t size;
+        int32_t c = utf8Decode(in + r, len - r, &size);
+        if(c < 0)
+        {
+            s[w++] = s[r++];
+            continue;
+        }
+
+        uint32_t folded = lowerCodepoint((uint32_t)c);
+        // tanda diakritik setelah huruf ASCII: gabungkan, huruf itu ditulis ulang
+        if(c >= 0x300 && c <= 0x36F && w > 0 && s[w - 1] >= 'a' && s[w - 1] <= 'z')
+        {
+            uint32_t composed = composeMark(s[w - 1], (uint32_t)c);
+            if(composed)
+            {
+                w--;
+                folded = composed;
+            }
+        }
+        if(w == r && folded == (uint32_t)c)
+        {
+            r += size;
+            w += size;
+            continue;
+        }
+        r += size;
+        w += utf8Encode(folded, s + w);
+    }
+    s[w] = '\0';
+    return w;
+}
+
+// Huruf pertama word dalam huruf besar (upper = 1) atau kecil ke first
+// (paling banyak 4 byte). Mengembalikan panjang huruf itu di word, yang
+// selalu sama dengan panjangnya di first; 0 jika word kosong.
+static size_t caseFirst(const char *word, char *first, int upper)
+{
+    if(word[0] == '\0') return 0;
+    size_t size;
+    int32_t c = utf8Decode((const unsigned char *)word, strnlen(word, 4), &size);
+    if(c < 0)
+    {
+        first[0] = word[0];
+        return 1;
+    }
+    return utf8Encode(upper ? upperCodepoint((uint32_t)c) : lowerCodepoint((uint32_t)c), first);
+}
+
+size_t upperFirst(const char *word, char *first)
+{
+    return caseFirst(word, first, 1);
+}
+
+size_t lowerFirst(const char *word, char *first)
+{
+    return caseFirst(word, first, 0);
+}
+
+// Trim di tempat dan kembalikan panjang barunya
+static size_t trimLength(const TextKernels *k, char *word)
+{
+    size_t len = strlen(word);
+    size_t start = k->skipSpace(word, len);
+    size_t newLen = k->trimEnd(word + start, len - start);
+    if(start) memmove(word, word + start, newLen);
+    word[newLen] = '\0';
+    return newLen;
+}
+
+void trim(char *word)
+{
+    if(word == NULL || *word == '\0') return;
+    trimLength(textKernels(), word);
+}
+
+// Trim dan huruf kecil; mengembalikan panjang baru
+static size_t trimAndFold(char *word)
+{
+    const TextKernels *k = textKernels();
+    size_t len = trimLength(k, word);
+    size_t high = k->lower(word, len);
+    if(high < len) len = foldUtf8(word, len, high);
+    return len;
+}
+
+void trim_and_tolower(char *word)
+{
+    trimAndFold(word);
+}
+
+void trim_and_tocapital(char *word)
+{
+    trimAndFold(word);
+    if((unsigned char)word[0] < 0x80)
+    {
+        word[0] = toupper((unsigned char)word[0]);
+        return;
+    }
+    char first[4];
+    memcpy(word, first, upperFirst(word, first));
+}
+
+// Fungsi hash 'sederhana' (djb2), index bucket diambil oleh hashtable.c
+unsigned int hash(const char *str)
+{
+    return hashBytes(str, strlen(str));
+}
+
+// Sama dengan hash(), untuk pemanggil yang sudah tahu panjang str.
+// Kata pendek langsung dihitung skalar: blok SIMD belum terisi penuh.
+unsigned int hashBytes(const char *str, size_t len)
+{
+    if(len < 16) return hashScalar(DJB2_SEED, str, len);
+    return textKernels()->hash(DJB2_SEED, str, len);
+}
@@ -0,0 +1,1440 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "dictionary_private.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+// Radix tree (trie dengan path compression). Tiap node menyimpan potongan
+// kunci (label) dan array anak yang terurut menurut byte pertama label.
+// Kunci adalah kata dalam huruf kecil (lihat text.c) sebagai byte UTF-8
+// apa adanya, termasuk tanda hubung, apostrof dan spasi. Huruf beraksen
+// atau huruf non-Latin hanya menambah satu atau dua node per byte, dan
+// urutan byte UTF-8 sama dengan urutan kode Unicode.
+//
+// Label tidak disalin: ia menunjuk ke kunci ter-intern di offset sesuai
+// kedalaman node. Karena semua kunci yang lewat node punya awalan yang
+// sama, label anak bisa "diperpanjang ke kiri" saat dua node digabung.
+// Label selalu menunjuk ke kunci kata yang masih ada di bawah node itu,
+// jadi kunci kata yang dihapus bisa dilepas (lihat moveLabelsOff).
+
+// Trie mengubah node di tempat (label, array anak), jadi tidak ikut skema
+// tanpa lock milik hash table: penelusuran memegang read lock kamus, insert
+// dan delete memegang write lock.
+#ifndef _WIN32
+#define trieReadLock(dict) pthread_rwlock_rdlock(&(dict)->trieLock)
+#define trieWriteLock(dict) pthread_rwlock_wrlock(&(dict)->trieLock)
+#define trieUnlock(dict) pthread_rwlock_unlock(&(dict)->trieLock)
+#else
+#define trieReadLock(dict) ((void)0)
+#define trieWriteLock(dict) ((void)0)
+#define trieUnlock(dict) ((void)0)
+#endif
+
+// Array anak diambil dari slab per kelas kapasitas (2, 4, ..., 256).
+// Di belakang array pointer disimpan byte pertama label tiap anak, jadi
+// mencari anak cukup membaca satu blok tanpa menyentuh node anaknya.
+#define CHILD_KEYS(node) ((unsigned char *)((node)->children + (node)->childCap))
+
+static int childClass(unsigned int cap)
+{
+    int k = 0;
+    while((2u << k) < cap) k++;
+    return k;
+}
+
+static TrieNode **allocChildren(Dictionary *dict, unsigned int cap)
+{
+    Slab *slab = &dict->childSlabs[childClass(cap)];
+    if(!slab->arena) slabInit(slab, (sizeof(TrieNode *) + 1) * cap, &dict->trieArena);
+    return (TrieNode **)slabAlloc(slab);
+}
+
+static void freeChildren(Dictionary *dict, TrieNode **children, unsigned int cap)
+{
+    if(children) slabFree(&dict->childSlabs[childClass(cap)], children);
+}
+
+TrieNode *createTrieNode(Dictionary *dict)
+{
+    TrieNode *newNode = (TrieNode*)slabAlloc(&dict->trieSlab);
+    if(newNode)
+    {
+        newNode->label = "";
+        newNode->labelLen = 0;
+        newNode->children = NULL;
+        newNode->childCount = 0;
+        newNode->childCap = 0;
+        newNode->entry = NULL;
+    }
+    return newNode;
+}
+
+static void releaseTrieNode(Dictionary *dict, TrieNode *node)
+{
+    freeChildren(dict, node->children, node->childCap);
+    slabFree(&dict->trieSlab, node);
+}
+
+// Cari posisi anak yang labelnya diawali byte c (binary search).
+// Jika tidak ada, *found = 0 dan hasilnya posisi sisip.
+static unsigned int findChild(const TrieNode *node, unsigned char c, int *found)
+{
+    const unsigned char *keys = node->childCap ? CHILD_KEYS(node) : NULL;
+    unsigned int lo = 0, hi = node->childCount;
+    while(lo < hi)
+    {
+        unsigned int mid = (lo + hi) / 2;
+        unsigned char m = keys[mid];
+        if(m == c)
+        {
+            *found = 1;
+            return mid;
+        }
+        if(m < c) lo = mid + 1;
+        else hi = mid;
+    }
+    *found = 0;
+    return lo;
+}
+
+static int insertChild(Dictionary *dict, TrieNode *node, unsigned int pos, TrieNode *child, unsigned char key)
+{
+    if(node->childCount == node->childCap)
+    {
+        unsigned int cap = node->childCap ? node->childCap * 2 : 2;
+        TrieNode **children = allocChildren(dict, cap);
+        if(!children) return 0;
+        if(node->childCount)
+        {
+            memcpy(children, node->children, node->childCount * sizeof(TrieNode *));
+            memcpy(children + cap, CHILD_KEYS(node), node->childCount);
+        }
+        freeChildren(dict, node->children, node->childCap);
+        node->children = children;
+        node->childCap = cap;
+    }
+
+    unsigned char *keys = CHILD_KEYS(node);
+    unsigned int tail = node->childCount - pos;
+    memmove(&node->children[pos + 1], &node->children[pos], tail * sizeof(TrieNode *));
+    memmove(&keys[pos + 1], &keys[pos], tail);
+    node->children[pos] = child;
+    keys[pos] = key;
+    node->childCount++;
+    return 1;
+}
+
+static void removeChild(Dictionary *dict, TrieNode *node, unsigned int pos)
+{
+    unsigned char *keys = CHILD_KEYS(node);
+    unsigned int tail = node->childCount - pos - 1;
+    memmove(&node->children[pos], &node->children[pos + 1], tail * sizeof(TrieNode *));
+    memmove(&keys[pos], &keys[pos + 1], tail);
+    node->childCount--;
+    if(node->childCount == 0)
+    {
+        freeChildren(dict, node->children, node->childCap);
+        node->children = NULL;
+        node->childCap = 0;
+    }
+}
+
+// Kunci trie disimpan lewat internString supaya label bisa menunjuk ke sana.
+// Pegangannya milik trie selama kata ada di sana.
+static const char *makeTrieKey(Dictionary *dict, const char *word)
+{
+    char *wordCopy = strdup(word);
+    if(wordCopy == NULL)
+    {
+        perror("Failed to allocate memory for word copy in insertToTrie");
+        return NULL;
+    }
+
+    trim_and_tolower(wordCopy);
+
+    const char *key = wordCopy[0] ? internString(dict, wordCopy) : NULL;
+    free(wordCopy);
+    return key;
+}
+
+// Salinan kunci sementara untuk pencarian dan hapus (tidak di-intern)
+static char *copyQueryKey(const char *word)
+{
+    char *key = strdup(word ? word : "");
+    if(key) trim_and_tolower(key);
+    return key;
+}
+
+// Kunci trie ter-intern untuk sebuah kata tanpa menambah pegangan; NULL
+// jika kata kosong atau kuncinya belum pernah di-intern
+const char *trieKeyOf(Dictionary *dict, const char *word)
+{
+    if(word == NULL || word[0] == '\0') return NULL;
+
+    char *key = copyQueryKey(word);
+    const char *interned = key && key[0] ? internFind(dict, key) : NULL;
+    free(key);
+    return interned;
+}
+
+void insertToTrie(Dictionary *dict, WordEntry *entry)
+{
+    if(entry == NULL || entry->word[0] == '\0' || dict->trie == NULL) return;
+
+    const char *key = makeTrieKey(dict, entry->word);
+    if(!key) return;
+
+    insertTrieKey(dict, key, entry);
+}
+
+// Kata utama selalu kapital (trim_and_tocapital), jadi dua entry tidak
+// pernah berbagi kunci. Jika itu terjadi juga, node tetap menunjuk ke entry
+// pertama dan trieWords tidak bertambah, sehingga wordIterInit tahu trie
+// tidak memuat semua kata.
+static int setNodeEntry(Dictionary *dict, TrieNode *node, WordEntry *entry)
+{
+    if(node->entry) return 0;
+    node->entry = entry;
+    dict->trieWords++;
+    return 1;
+}
+
+// 1 jika entry tersimpan di trie
+static int insertKey(Dictionary *dict, TrieNode *root, const char *key, WordEntry *entry)
+{
+    TrieNode *node = root;
+    const char *rest = key;
+    while(*rest)
+    {
+        int found;
+        unsigned int pos = findChild(node, (unsigned char)*rest, &found);
+        if(!found)
+        {
+            TrieNode *leaf = createTrieNode(dict);
+            if(!leaf || !insertChild(dict, node, pos, leaf, (unsigned char)*rest))
+            {
+                fprintf(stderr, "Failed to create TrieNode in insertToTrie.\n");
+                if(leaf) releaseTrieNode(dict, leaf);
+                return 0;
+            }
+            leaf->label = rest;
+            leaf->labelLen = (unsigned int)strlen(rest);
+            return setNodeEntry(dict, leaf, entry);
+        }
+
+        TrieNode *child = node->children[pos];
+        unsigned int common = 1;
+        while(common < child->labelLen && rest[common] == child->label[common]) common++;
+
+        if(common < child->labelLen)
+        {
+            // pecah label anak: node tengah mengambil awalan yang sama
+            TrieNode *mid = createTrieNode(dict);
+            if(!mid || !insertChild(dict, mid, 0, child, (unsigned char)child->label[common]))
+            {
+                fprintf(stderr, "Failed to create TrieNode in insertToTrie.\n");
+                if(mid) releaseTrieNode(dict, mid);
+                return 0;
+            }
+            mid->label = child->label;
+            mid->labelLen = common;
+            child->label += common;
+            child->labelLen -= common;
+            node->children[pos] = mid;
+            child = mid;
+        }
+
+        node = child;
+        rest += common;
+    }
+    return setNodeEntry(dict, node, entry);
+}
+
+// Indeks akhiran: kunci trie dikelompokkan menurut TRIE_SUFFIX_BYTES byte
+// terakhirnya, untuk bagian trieFuzzy jarak 2 yang tidak bisa dipangkas
+// dari depan (lihat fuzzySuffixMatches). Indeks baru dibangun oleh
+// pencarian jarak 2 pertama dan sejak itu ikut diperbarui insert dan
+// delete di bawah write lock trie. Kunci yang lebih pendek tidak dimasukkan.
+#define SUFFIX_LOAD 4           // rata-rata kunci per bucket sebelum bucket digandakan
+
+static SuffixBucket *suffixBucket(const SuffixIndex *index, const char *key, size_t len)
+{
+    unsigned int h = mixHash(hashBytes(key + len - TRIE_SUFFIX_BYTES, TRIE_SUFFIX_BYTES));
+    return &index->buckets[h & index->mask];
+}
+
+static int suffixPut(SuffixIndex *index, const char *key)
+{
+    size_t len = strlen(key);
+    if(len < TRIE_SUFFIX_BYTES) return 1;
+
+    SuffixBucket *bucket = suffixBucket(index, key, len);
+    if(bucket->count == bucket->cap)
+    {
+        uint32_t cap = bucket->cap ? bucket->cap * 2 : 4;
+        const char **keys = (const char **)realloc(bucket->keys, cap * sizeof(const char *));
+        if(!keys) return 0;
+        bucket->keys = keys;
+        bucket->cap = cap;
+    }
+    bucket->keys[bucket->count++] = key;
+    index->count++;
+    return 1;
+}
+
+static void suffixFree(SuffixIndex *index)
+{
+    for(size_t i = 0; index->buckets && i <= index->mask; i++) free(index->buckets[i].keys);
+    free(index->buckets);
+    memset(index, 0, sizeof(*index));
+}
+
+static int suffixInit(SuffixIndex *index, size_t buckets)
+{
+    memset(index, 0, sizeof(*index));
+    index->buckets = (SuffixBucket *)calloc(buckets, sizeof(SuffixBucket));
+    index->mask = buckets - 1;
+    return index->buckets != NULL;
+}
+
+// Pindahkan semua kunci ke bucket dua kali lebih banyak; gagal = tetap yang lama
+static void suffixGrow(SuffixIndex *index)
+{
+    SuffixIndex grown;
+    if(!suffixInit(&grown, (index->mask + 1) * 2)) return;
+    for(size_t i = 0; i <= index->mask; i++)
+        for(uint32_t j = 0; j < index->buckets[i].count; j++)
+            if(!suffixPut(&grown, index->buckets[i].keys[j]))
+            {
+                suffixFree(&grown);
+                return;
+            }
+    suffixFree(index);
+    *index = grown;
+}
+
+static void suffixAdd(Dictionary *dict, const char *key)
+{
+    SuffixIndex *index = &dict->trieSuffixes;
+    if(!index->buckets) return;
+
+    if(index->count >= (index->mask + 1) * SUFFIX_LOAD) suffixGrow(index);
+    if(!suffixPut(index, key))
+    {
+        // indeks yang kehilangan satu kunci memberi hasil fuzzy yang salah:
+        // buang saja, pencarian jarak 2 berikutnya membangunnya lagi
+        fprintf(stderr, "Failed to add a word to the trie suffix index.\n");
+        suffixFree(index);
+    }
+}
+
+static void suffixRemove(Dictionary *dict, const char *key)
+{
+    SuffixIndex *index = &dict->trieSuffixes;
+    size_t len = strlen(key);
+    if(!index->buckets || len < TRIE_SUFFIX_BYTES) return;
+
+    SuffixBucket *bucket = suffixBucket(index, key, len);
+    for(uint32_t i = 0; i < bucket->count; i++)
+    {
+        if(strcmp(bucket->keys[i], key) != 0) continue;
+        bucket->keys[i] = bucket->keys[--bucket->count];
+        index->count--;
+        return;
+    }
+}
+
+// Snapshot yang dilayani dari file tidak membangun trie saat load
+// (triePending): kata-katanya, ditambah kata yang ditambahkan sesudahnya
+// (trieSeeds), baru dimasukkan di sini oleh fungsi trie pertama yang
+// membaca trie, pembaca maupun penulis. Menambah dan menghapus kata tidak
+// memicunya, jadi replay log saat startup tidak membangun trie. Kunci
+// snapshot di-pin, jadi tidak ada pegangan string yang berubah.
+static void trieReady(Dictionary *dict)
+{
+    if(!LOAD_ACQUIRE(&dict->triePending)) return;
+
+    trieWriteLock(dict);
+    if(dict->triePending)
+    {
+        size_t pos = 0;
+        const char *key;
+        for(WordEntry *entry; (entry = snapshotNextWord(dict, &pos, &key));)
+            if(key && key[0]) insertKey(dict, dict->trie, key, entry);
+
+        for(size_t i = 0; i < dict->trieSeedCount; i++)
+            if(!insertKey(dict, dict->trie, dict->trieSeeds[i].key, dict->trieSeeds[i].entry))
+                internRelease(dict, dict->trieSeeds[i].key);
+        free(dict->trieSeeds);
+        dict->trieSeeds = NULL;
+        dict->trieSeedCount = dict->trieSeedCap = 0;
+        STORE_RELEASE(&dict->triePending, 0);
+    }
+    trieUnlock(dict);
+}
+
+// Simpan kunci untuk trieReady selama trie belum dibangun; 0 jika trie
+// sudah dibangun atau seeds tidak bisa diperbesar. Dipanggil dengan trie
+// write lock dipegang.
+static int seedTrieKey(Dictionary *dict, const char *key, WordEntry *entry)
+{
+    if(!dict->triePending) return 0;
+    if(dict->trieSeedCount == dict->trieSeedCap)
+    {
+        size_t cap = dict->trieSeedCap ? dict->trieSeedCap * 2 : 64;
+        TrieSeed *seeds = (TrieSeed *)realloc(dict->trieSeeds, cap * sizeof(TrieSeed));
+        if(!seeds) return 0;
+        dict->trieSeeds = seeds;
+        dict->trieSeedCap = cap;
+    }
+    dict->trieSeeds[dict->trieSeedCount++] = (TrieSeed){key, entry};
+    return 1;
+}
+
+// Lepas kunci word dari seeds; 1 jika trie belum dibangun, jadi tidak ada
+// yang perlu dihapus dari trie. Dipanggil dengan trie write lock dipegang.
+static int unseedTrieKey(Dictionary *dict, const char *word)
+{
+    if(!dict->triePending) return 0;
+    for(size_t i = 0; i < dict->trieSeedCount; i++)
+    {
+        if(strcmp(dict->trieSeeds[i].entry->word, word) != 0) continue;
+        internRelease(dict, dict->trieSeeds[i].key);
+        dict->trieSeeds[i] = dict->trieSeeds[--dict->trieSeedCount];
+        break;
+    }
+    return 1;
+}
+
+// Sisipkan kunci yang sudah dinormalisasi. Trie mengambil alih satu
+// pegangan key (internString), karena label node menunjuk ke dalamnya;
+// jika entry tidak disimpan, pegangan itu langsung dilepas.
+void insertTrieKey(Dictionary *dict, const char *key, WordEntry *entry)
+{
+    if(key == NULL) return;
+
+    int stored = 0;
+    if(key[0] != '\0' && dict->trie != NULL)
+    {
+        if(LOAD_ACQUIRE(&dict->triePending))
+        {
+            trieWriteLock(dict);
+            stored = seedTrieKey(dict, key, entry);
+            trieUnlock(dict);
+        }
+        if(!stored)
+        {
+            trieReady(dict);
+            trieWriteLock(dict);
+            stored = insertKey(dict, dict->trie, key, entry);
+            if(stored) suffixAdd(dict, key);
+            trieUnlock(dict);
+        }
+    }
+    if(!stored) internRelease(dict, key);
+}
+
+// Gabungkan node (bukan akhir kata, satu anak) dengan anaknya
+static void mergeWithChild(Dictionary *dict, TrieNode *parent, unsigned int pos)
+{
+    TrieNode *node = parent->children[pos];
+    TrieNode *child = node->children[0];
+
+    child->label -= node->labelLen;
+    child->labelLen += node->labelLen;
+    parent->children[pos] = child;
+
+    node->childCount = 0;
+    releaseTrieNode(dict, node);
+}
+
+static int deleteKey(Dictionary *dict, TrieNode *root, char *key, const char *word)
+{
+    TrieNode *parent = NULL, *grandParent = NULL;
+    unsigned int parentPos = 0, pos = 0;
+    TrieNode *node = root;
+    const char *rest = key;
+    while(*rest)
+    {
+        int found;
+        unsigned int childPos = findChild(node, (unsigned char)*rest, &found);
+        TrieNode *child = found ? node->children[childPos] : NULL;
+        if(!child || strncmp(rest, child->label, child->labelLen) != 0) return 0;
+
+        grandParent = parent;
+        parentPos = pos;
+        parent = node;
+        pos = childPos;
+        node = child;
+        rest += child->labelLen;
+    }
+
+    // node milik entry lain dengan kunci yang sama (lihat setNodeEntry)
+    if(!node->entry || strcmp(node->entry->word, word) != 0) return 0;
+
+    node->entry = NULL;
+    dict->trieWords--;
+    if(node == root) return 1;
+
+    if(node->childCount == 0)
+    {
+        removeChild(dict, parent, pos);
+        releaseTrieNode(dict, node);
+
+        // parent mungkin sekarang hanya jalan lewat ke satu anak
+        if(grandParent && !parent->entry && parent->childCount == 1)
+            mergeWithChild(dict, grandParent, parentPos);
+    }
+    else if(node->childCount == 1)
+    {
+        mergeWithChild(dict, parent, pos);
+    }
+    return 1;
+}
+
+static int labelIn(const TrieNode *node, const char *key, size_t len)
+{
+    uintptr_t label = (uintptr_t)node->label, start = (uintptr_t)key;
+    return label >= start && label < start + len;
+}
+
+// Setelah kata dengan kunci dead dihapus, node di jalur dead yang labelnya
+// masih menunjuk ke dead dipindah ke kunci lain yang melewati node yang
+// sama: kunci di bawah anak pertamanya, atau kunci kata milik node itu
+// sendiri jika node itu daun. Teks labelnya tidak berubah.
+static void moveLabelsOff(Dictionary *dict, TrieNode *root, const char *dead)
+{
+    size_t len = strlen(dead);
+    TrieNode *node = root;
+    const char *rest = dead;
+    while(*rest)
+    {
+        int found;
+        unsigned int pos = findChild(node, (unsigned char)*rest, &found);
+        if(!found) return;
+        TrieNode *child = node->children[pos];
+        if(strncmp(rest, child->label, child->labelLen) != 0) return;
+
+        if(labelIn(child, dead, len))
+        {
+            // turun lewat anak pertama sampai label yang bukan di dead
+            size_t offset = 0;
+            TrieNode *other = child;
+            while(labelIn(other, dead, len) && other->childCount)
+            {
+                offset += other->labelLen;
+                other = other->children[0];
+            }
+
+            const char *label = other->label - offset;
+            if(labelIn(other, dead, len))
+            {
+                const char *own = other->entry ? trieKeyOf(dict, other->entry->word) : NULL;
+                if(!own) return;
+                label = own + (child->label - dead);
+            }
+            for(TrieNode *n = child; labelIn(n, dead, len); n = n->children[0])
+            {
+                n->label = label;
+                label += n->labelLen;
+                if(!n->childCount) break;
+            }
+        }
+        node = child;
+        rest += child->labelLen;
+    }
+}
+
+// Hapus satu kata dari trie dan langsung pangkas cabang yang kosong, jadi
+// node mati tidak menumpuk dan kembali ke free list slab untuk dipakai ulang.
+// Pegangan trie pada kuncinya ikut dilepas. word = kata utama persis seperti
+// di entry. Mengembalikan 1 jika kata ada dan dihapus.
+int deleteFromTrie(Dictionary *dict, const char *word)
+{
+    if(word == NULL || word[0] == '\0' || dict->trie == NULL) return 0;
+
+    char *key = copyQueryKey(word);
+    if(!key) return 0;
+
+    trieWriteLock(dict);
+    if(unseedTrieKey(dict, word))
+    {
+        trieUnlock(dict);
+        free(key);
+        return 1;
+    }
+    const char *dead = internFind(dict, key);
+    int removed = deleteKey(dict, dict->trie, key, word);
+    if(removed) suffixRemove(dict, key);
+    if(removed && dead) moveLabelsOff(dict, dict->trie, dead);
+    trieUnlock(dict);
+
+    if(removed && dead) internRelease(dict, dead);
+    free(key);
+    return removed;
+}
+
+// Semua penelusuran memakai stack eksplisit, bukan rekursi: dalamnya trie
+// bisa sepanjang kata terpanjang (misalnya "a", "aa", "aaa", ...), dan
+// kunci dikumpulkan di buffer yang tumbuh sesuai kebutuhan.
+typedef struct TrieFrame
+{
+    const TrieNode *node;
+    size_t end;             // panjang kunci sampai akhir label node
+    unsigned int next;      // anak berikutnya yang dikunjungi
+    int bounded;            // dipakai walkTrie
+} TrieFrame;
+
+static int reserveKeyBuffer(char **buffer, size_t *cap, size_t needed)
+{
+    if(needed <= *cap) return 1;
+
+    size_t newCap = *cap ? *cap : 64;
+    while(newCap < needed) newCap *= 2;
+    char *grown = (char *)realloc(*buffer, newCap);
+    if(!grown) return 0;
+    *buffer = grown;
+    *cap = newCap;
+    return 1;
+}
+
+static int reserveFrames(void **frames, size_t *cap, size_t needed, size_t size)
+{
+    if(needed <= *cap) return 1;
+
+    size_t newCap = *cap ? *cap : 32;
+    while(newCap < needed) newCap *= 2;
+    void *grown = realloc(*frames, newCap * size);
+    if(!grown) return 0;
+    *frames = grown;
+    *cap = newCap;
+    return 1;
+}
+
+// initial = huruf pertama (kapital) dari kata terakhir yang dicetak. Huruf
+// pertama bisa lebih dari satu byte, jadi judul tidak bisa diambil dari
+// anak root: semua huruf é..ÿ misalnya berada di bawah byte 0xC3.
+static void printTrieWord(char *buffer, size_t len, char *initial)
+{
+    char first[5];
+    buffer[len] = '\0';
+    size_t n = upperFirst(buffer, first);
+    first[n] = '\0';
+    if(strcmp(first, initial) != 0)
+    {
+        printf("\n---%s---\n", first);
+        memcpy(initial, first, n + 1);
+    }
+    fwrite(first, 1, n, stdout);
+    fwrite(buffer + n, 1, len - n, stdout);
+    putchar('\n');
+}
+
+void printAllWordsTrie(Dictionary *dict)
+{
+    TrieNode *root = dict->trie;
+    if(!root) return;
+
+    char *buffer = NULL;
+    size_t cap = 0, stackCap = 0, top = 0;
+    TrieFrame *stack = NULL;
+    char initial[5] = "";
+
+    trieReady(dict);
+    trieReadLock(dict);
+    if(reserveFrames((void **)&stack, &stackCap, 1, sizeof(TrieFrame)))
+        stack[top++] = (TrieFrame){root, 0, 0, 0};
+    while(top)
+    {
+        TrieFrame *frame = &stack[top - 1];
+        if(frame->next == frame->node->childCount)
+        {
+            top--;
+            continue;
+        }
+
+        const TrieNode *node = frame->node->children[frame->next++];
+        size_t depth = frame->end, end = depth + node->labelLen;
+        if(!reserveKeyBuffer(&buffer, &cap, end + 1) ||
+           !reserveFrames((void **)&stack, &stackCap, top + 1, sizeof(TrieFrame)))
+        {
+            fprintf(stderr, "Failed to allocate memory in printAllWordsTrie.\n");
+            break;
+        }
+
+        memcpy(buffer + depth, node->label, node->labelLen);
+        if(node->entry) printTrieWord(buffer, end, initial);
+        if(node->childCount) stack[top++] = (TrieFrame){node, end, 0, 0};
+    }
+    trieUnlock(dict);
+
+    free(stack);
+    free(buffer);
+}
+
+// Iterator semua kata utama, terurut menurut kunci trie. Trie adalah index
+// terurut satu-satunya: node akhir kata menunjuk ke entry-nya, jadi tidak
+// ada salinan kata lain yang perlu disimpan atau diurutkan, dan kuncinya
+// tidak perlu disusun ulang. Dipanggil dengan dictWriteBegin dipegang (atau
+// tanpa penulis lain), seperti hashTableNext. Jika trie tidak memuat semua
+// kata (misalnya alokasi node pernah gagal), iterator memakai urutan
+// bucket supaya tidak ada kata yang hilang; it->sorted memberitahu yang mana.
+void wordIterInit(Dictionary *dict, WordIter *it)
+{
+    memset(it, 0, sizeof(*it));
+    hashTableIterInit(&it->bucket);
+    trieReady(dict);
+    it->sorted = dict->trie && dict->trieWords == dictionaryWordCount(dict);
+    if(it->sorted && !reserveFrames((void **)&it->stack, &it->cap, 1, sizeof(TrieNode *)))
+        it->sorted = 0;
+    if(it->sorted) it->stack[it->top++] = dict->trie;
+}
+
+// Kumpulkan entry berikutnya dalam urutan pre-order: kata di node sebelum
+// kata di anak-anaknya, anak didorong dari belakang supaya yang terkecil
+// keluar lebih dulu
+static void fillWordBatch(WordIter *it)
+{
+    it->batchNext = it->batchCount = 0;
+    while(it->top && it->batchCount < WORD_ITER_BATCH)
+    {
+        const TrieNode *node = it->stack[--it->top];
+        if(!reserveFrames((void **)&it->stack, &it->cap, it->top + node->childCount, sizeof(TrieNode *)))
+        {
+            it->failed = 1;
+            it->top = 0;
+            break;
+        }
+        for(unsigned int i = node->childCount; i-- > 0;)
+        {
+            it->stack[it->top++] = node->children[i];
+            __builtin_prefetch(node->children[i]);
+        }
+        if(node->entry)
+        {
+            it->batch[it->batchCount++] = node->entry;
+            __builtin_prefetch(node->entry);
+        }
+    }
+
+    // entry dan string kata tersebar di arena: miss-nya ditumpuk sekaligus
+    // seperti findWords, bukan ditunggu satu per satu oleh pemanggil
+    for(unsigned int i = 0; i < it->batchCount; i++)
+    {
+        __builtin_prefetch(it->batch[i]->word);
+        if(it->batch[i]->synonyms) __builtin_prefetch(it->batch[i]->synonyms);
+    }
+}
+
+WordEntry *wordIterNext(Dictionary *dict, WordIter *it)
+{
+    if(!it->sorted) return hashTableNext(dict, &it->bucket);
+    if(it->batchNext == it->batchCount) fillWordBatch(it);
+    return it->batchNext < it->batchCount ? it->batch[it->batchNext++] : NULL;
+}
+
+void wordIterFree(WordIter *it)
+{
+    free(it->stack);
+    it->stack = NULL;
+    it->top = it->cap = 0;
+}
+
+// Penelusuran terurut mulai dari batas bawah, dipakai oleh autocomplete
+// dan cursor range. Node di luar batas bawah dilewati tanpa dikunjungi,
+// jadi biayanya sebanding dengan panjang batas dan jumlah hasil, bukan
+// dengan ukuran kamus.
+typedef struct TrieWalk
+{
+    char *buffer;
+    size_t cap;
+    const char *lower;      // NULL = mulai dari awal
+    size_t lowerLen;
+    int inclusive;          // ikutkan kata yang sama dengan lower
+    const char *upper;      // NULL = tanpa batas atas
+    const char *prefix;     // NULL = tidak harus berawalan tertentu
+    size_t prefixLen;
+    size_t limit;
+    size_t count;
+    int stop;
+    int finished;           // sudah melewati batas atas / awalan
+    int (*visit)(const char *word, void *ctx);
+    void *ctx;
+} TrieWalk;
+
+static void emitWord(TrieWalk *walk, size_t len)
+{
+    walk->buffer[len] = '\0';
+    if((walk->prefix && strncmp(walk->buffer, walk->prefix, walk->prefixLen) != 0) ||
+       (walk->upper && strcmp(walk->buffer, walk->upper) > 0))
+    {
+        // kata terurut, jadi semua kata setelah ini juga di luar batas
+        walk->stop = 1;
+        walk->finished = 1;
+        return;
+    }
+
+    walk->count++;
+    if(walk->visit && !walk->visit(walk->buffer, walk->ctx)) walk->stop = 1;
+    if(walk->count >= walk->limit) walk->stop = 1;
+}
+
+// Salin label node ke buffer, cocokkan dengan batas bawah dan keluarkan
+// katanya. bounded = jalur node ini masih sama dengan awalan batas bawah,
+// diperbarui untuk anak-anaknya. Mengembalikan 0 jika anak-anaknya tidak
+// perlu dikunjungi.
+static int enterWalkNode(TrieWalk *walk, const TrieNode *node, size_t depth, int *bounded)
+{
+    if(!reserveKeyBuffer(&walk->buffer, &walk->cap, depth + node->labelLen + 1))
+    {
+        walk->stop = 1;
+        return 0;
+    }
+
+    memcpy(walk->buffer + depth, node->label, node->labelLen);
+    size_t end = depth + node->labelLen;
+    int emitSelf = node->entry != NULL;
+
+    if(*bounded)
+    {
+        const char *seg = walk->lower + depth;
+        size_t segLen = walk->lowerLen - depth;
+        size_t n = segLen < node->labelLen ? segLen : node->labelLen;
+        int cmp = memcmp(node->label, seg, n);
+
+        if(cmp < 0) return 0;            // seluruh subtree lebih kecil dari batas
+        if(cmp > 0 || segLen < node->labelLen)
+        {
+            *bounded = 0;                // seluruh subtree lebih besar dari batas
+        }
+        else if(segLen == node->labelLen)
+        {
+            emitSelf = emitSelf && walk->inclusive;
+            *bounded = 0;                // semua anak lebih panjang dari batas
+        }
+        else
+        {
+            emitSelf = 0;                // node ini awalan dari batas, masih lebih kecil
+        }
+    }
+
+    if(emitSelf) emitWord(walk, end);
+    return node->childCount && !walk->stop;
+}
+
+static void walkTrie(TrieWalk *walk, const TrieNode *root)
+{
+    TrieFrame *stack = NULL;
+    size_t stackCap = 0, top = 0;
+    int bounded = 1;
+
+    if(enterWalkNode(walk, root, 0, &bounded) &&
+       reserveFrames((void **)&stack, &stackCap, 1, sizeof(TrieFrame)))
+        stack[top++] = (TrieFrame){root, root->labelLen, 0, bounded};
+    while(top && !walk->stop)
+    {
+        TrieFrame *frame = &stack[top - 1];
+        if(frame->next == frame->node->childCount)
+        {
+            top--;
+            continue;
+        }
+
+        const TrieNode *parent = frame->node;
+        unsigned int i = frame->next++;
+        size_t end = frame->end;
+        bounded = frame->bounded;
+        if(bounded && end < walk->lowerLen &&
+           CHILD_KEYS(parent)[i] < (unsigned char)walk->lower[end])
+            continue;
+
+        const TrieNode *node = parent->children[i];
+        if(!enterWalkNode(walk, node, end, &bounded)) continue;
+        if(!reserveFrames((void **)&stack, &stackCap, top + 1, sizeof(TrieFrame)))
+        {
+            walk->stop = 1;
+            break;
+        }
+        stack[top++] = (TrieFrame){node, end + node->labelLen, 0, bounded};
+    }
+    free(stack);
+}
+
+// Panggil visit untuk paling banyak k kata berawalan prefix, terurut.
+// visit boleh mengembalikan 0 untuk berhenti. Mengembalikan jumlah kata.
+size_t trieComplete(Dictionary *dict, const char *prefix, size_t k,
+                    int (*visit)(const char *word, void *ctx), void *ctx)
+{
+    if(!dict->trie || k == 0) return 0;
+
+    char *key = copyQueryKey(prefix);
+    if(!key) return 0;
+
+    TrieWalk walk = {0};
+    walk.lower = key;
+    walk.lowerLen = strlen(key);
+    walk.inclusive = 1;
+    walk.prefix = key;
+    walk.prefixLen = walk.lowerLen;
+    walk.limit = k;
+    walk.visit = visit;
+    walk.ctx = ctx;
+    trieReady(dict);
+    trieReadLock(dict);
+    walkTrie(&walk, dict->trie);
+    trieUnlock(dict);
+
+    free(walk.buffer);
+    free(key);
+    return walk.count;
+}
+
+// Siapkan cursor untuk kata di antara from dan to (inklusif, NULL = tanpa batas)
+int trieCursorInit(TrieCursor *cursor, const char *from, const char *to)
+{
+    cursor->lastKey = copyQueryKey(from);
+    cursor->upperKey = to ? copyQueryKey(to) : NULL;
+    cursor->started = 0;
+    cursor->done = 0;
+    if(!cursor->lastKey || (to && !cursor->upperKey))
+    {
+        trieCursorFree(cursor);
+        return 0;
+    }
+    return 1;
+}
+
+static int rememberLastKey(const char *word, void *ctx)
+{
+    TrieCursor *cursor = (TrieCursor *)ctx;
+    char *copy = strdup(word);
+    if(!copy) return 0;
+    free(cursor->lastKey);
+    cursor->lastKey = copy;
+    if(cursor->visit && !cursor->visit(word, cursor->ctx)) return 0;
+    return 1;
+}
+
+// Ambil halaman berikutnya (paling banyak k kata). Cursor hanya menyimpan
+// kunci terakhir, jadi tetap sah walaupun trie berubah di antara halaman.
+size_t trieCursorNext(Dictionary *dict, TrieCursor *cursor, size_t k,
+                      int (*visit)(const char *word, void *ctx), void *ctx)
+{
+    if(!dict->trie || cursor->done || k == 0) return 0;
+
+    // batas bawah dipegang sendiri selama penelusuran, lastKey diisi ulang oleh rememberLastKey
+    char *lower = cursor->lastKey;
+    cursor->lastKey = NULL;
+
+    TrieWalk walk = {0};
+    walk.lower = lower;
+    walk.lowerLen = strlen(lower);
+    walk.inclusive = !cursor->started;
+    walk.upper = cursor->upperKey;
+    walk.limit = k;
+    walk.visit = rememberLastKey;
+    walk.ctx = cursor;
+    cursor->visit = visit;
+    cursor->ctx = ctx;
+    trieReady(dict);
+    trieReadLock(dict);
+    walkTrie(&walk, dict->trie);
+    trieUnlock(dict);
+    free(walk.buffer);
+
+    if(cursor->lastKey) free(lower);
+    else cursor->lastKey = lower;
+
+    if(walk.count) cursor->started = 1;
+    if(!walk.stop || walk.finished) cursor->done = 1;
+    return walk.count;
+}
+
+void trieCursorFree(TrieCursor *cursor)
+{
+    free(cursor->lastKey);
+    free(cursor->upperKey);
+    cursor->lastKey = NULL;
+    cursor->upperKey = NULL;
+    cursor->done = 1;
+}
+
+// Pencarian fuzzy: kata dengan jarak edit (Levenshtein) paling banyak
+// maxDistance dari kunci query. Satu baris DP dihitung per byte label
+// sepanjang jalur trie, jadi kata yang berawalan sama memakai baris yang
+// sama. Subtree dipangkas begitu semua isi baris melewati batasnya, dan
+// hanya sel dalam pita |baris - kolom| <= maxDistance yang dihitung.
+//
+// Pada jarak 2 hampir semua cabang dekat root masih lolos, jadi query
+// dipecah (pigeonhole): A = query tanpa TRIE_SUFFIX_BYTES byte terakhir,
+// B = sisanya. Setiap penjajaran dengan paling banyak maxDistance edit
+// memakai paling banyak maxDistance - 1 edit untuk A, atau tepat
+// maxDistance edit untuk A dan B cocok persis. Yang pertama dicari di trie
+// dengan kolom A dibatasi maxDistance - 1 (prefixDistance), sehingga bagian
+// dekat root dipangkas seperti jarak 1. Yang kedua berakhiran B, jadi
+// cukup diperiksa dari bucket B di indeks akhiran.
+typedef struct FuzzyMatch
+{
+    const char *word;       // kunci ter-intern dari indeks akhiran
+    int distance;
+} FuzzyMatch;
+
+typedef struct FuzzyWalk
+{
+    char *buffer;
+    size_t cap;
+    int *rows;              // baris ke-d = jarak awalan kunci sepanjang d ke awalan query (lihat fuzzyRow)
+    size_t rowCap;          // dalam jumlah baris
+    size_t width;           // sel per baris: 2 * maxDistance + 3
+    const char *query;
+    size_t queryLen;
+    int maxDistance;
+    size_t split;           // kolom 0..split dibatasi prefixDistance
+    int prefixDistance;     // = maxDistance jika query tidak dipecah
+    FuzzyMatch *pending;    // hasil indeks akhiran, terurut, digabung ke keluaran trie
+    size_t pendingCount, pendingNext;
+    size_t limit;
+    size_t count;
+    int stop;
+    int (*visit)(const char *word, int distance, void *ctx);
+    void *ctx;
+} FuzzyWalk;
+
+static int reserveFuzzyRows(FuzzyWalk *walk, size_t rows)
+{
+    if(rows <= walk->rowCap) return 1;
+
+    size_t cap = walk->rowCap ? walk->rowCap : 32;
+    while(cap < rows) cap *= 2;
+    int *grown = (int *)realloc(walk->rows, cap * walk->width * sizeof(int));
+    if(!grown) return 0;
+    walk->rows = grown;
+    walk->rowCap = cap;
+    return 1;
+}
+
+// Baris d hanya menyimpan pita kolom d - maxDistance - 1 .. d + maxDistance + 1,
+// jadi memori sebanding dengan panjang kata kali lebar pita, bukan kali
+// panjang query. Hasilnya tetap diindeks dengan nomor kolom query.
+static int *fuzzyRow(const FuzzyWalk *walk, size_t d)
+{
+    return walk->rows + d * walk->width + (size_t)walk->maxDistance + 1 - d;
+}
+
+// Jarak terbesar yang boleh dicapai sel di kolom j
+static int fuzzyCap(const FuzzyWalk *walk, size_t j)
+{
+    return j <= walk->split ? walk->prefixDistance : walk->maxDistance;
+}
+
+// Baris 0: jarak kunci kosong ke setiap awalan query di dalam pita
+static void fuzzyFirstRow(FuzzyWalk *walk)
+{
+    int *row = fuzzyRow(walk, 0);
+    for(size_t j = 0; j <= walk->queryLen && j <= (size_t)walk->maxDistance + 1; j++)
+        row[j] = (int)j <= fuzzyCap(walk, j) ? (int)j : walk->maxDistance + 1;
+}
+
+// Hitung baris depth+1 dari baris depth setelah menambah byte c. Sel yang
+// melewati batas kolomnya diganti maxDistance + 1, jadi jalur lewat sel
+// itu tidak pernah lolos. Mengembalikan nilai terkecil di baris baru.
+static int fuzzyStep(FuzzyWalk *walk, size_t depth, char c)
+{
+    const int *prev = fuzzyRow(walk, depth);
+    int *row = fuzzyRow(walk, depth + 1);
+    int limit = walk->maxDistance + 1;
+    size_t r = depth + 1;
+    size_t lo = r > (size_t)walk->maxDistance ? r - walk->maxDistance : 1;
+    size_t hi = r + walk->maxDistance < walk->queryLen ? r + walk->maxDistance : walk->queryLen;
+
+    int best = r <= (size_t)fuzzyCap(walk, 0) ? (int)r : limit;
+    if(r <= (size_t)limit) row[0] = best;   // kolom 0 masih di dalam pita
+    if(lo > hi) return best;
+    // sel tepat di luar pita dibaca oleh baris berikutnya
+    if(lo > 1) row[lo - 1] = limit;
+    for(size_t j = lo; j <= hi; j++)
+    {
+        int cost = prev[j - 1] + (walk->query[j - 1] != c);
+        if(prev[j] + 1 < cost) cost = prev[j] + 1;
+        if(row[j - 1] + 1 < cost) cost = row[j - 1] + 1;
+        if(cost > fuzzyCap(walk, j)) cost = limit;
+        row[j] = cost;
+        if(cost < best) best = cost;
+    }
+    if(hi < walk->queryLen) row[hi + 1] = limit;
+    return best;
+}
+
+// Himpunan byte berikutnya yang mungkin, satu bit per nilai byte
+typedef struct ByteSet
+{
+    uint64_t bits[4];
+} ByteSet;
+
+#define BYTESET_HAS(set, c) (((set)->bits[(c) >> 6] >> ((c) & 63)) & 1)
+
+// Byte yang bisa menjadi byte berikutnya tanpa melewati batas jarak. Jika
+// ada sel yang masih muat satu sisipan atau satu penggantian semua byte
+// lolos; selain itu hanya byte query yang cocok secara diagonal dengan sel
+// yang sudah di batasnya. Mengembalikan 0 jika tidak ada.
+static int fuzzyNextBytes(const FuzzyWalk *walk, size_t depth, ByteSet *next)
+{
+    memset(next->bits, 0, sizeof(next->bits));
+    const int *row = fuzzyRow(walk, depth);
+    size_t k = (size_t)walk->maxDistance;
+    size_t lo = depth > k ? depth - k : 0;
+    size_t hi = depth + k < walk->queryLen ? depth + k : walk->queryLen;
+    int any = 0;
+    for(size_t j = lo; j <= hi; j++)
+    {
+        int next1 = j < walk->queryLen ? fuzzyCap(walk, j + 1) : -1;
+        if(row[j] < fuzzyCap(walk, j) || row[j] < next1)
+        {
+            memset(next->bits, 0xFF, sizeof(next->bits));
+            return 1;
+        }
+        if(row[j] > next1) continue;
+        unsigned char c = (unsigned char)walk->query[j];
+        next->bits[c >> 6] |= 1ULL << (c & 63);
+        any = 1;
+    }
+    return any;
+}
+
+static void emitFuzzy(FuzzyWalk *walk, const char *word, int distance)
+{
+    walk->count++;
+    if(walk->visit && !walk->visit(word, distance, walk->ctx)) walk->stop = 1;
+    if(walk->count >= walk->limit) walk->stop = 1;
+}
+
+// Keluarkan hasil indeks akhiran yang urut sebelum word (NULL = semuanya)
+static void flushPending(FuzzyWalk *walk, const char *word)
+{
+    while(walk->pendingNext < walk->pendingCount && !walk->stop)
+    {
+        const FuzzyMatch *match = &walk->pending[walk->pendingNext];
+        if(word && strcmp(match->word, word) >= 0) break;
+        walk->pendingNext++;
+        emitFuzzy(walk, match->word, match->distance);
+    }
+}
+
+typedef struct FuzzyFrame
+{
+    const TrieNode *node;
+    size_t end;
+    unsigned int next;
+    ByteSet bytes;          // byte pertama anak yang masih mungkin
+} FuzzyFrame;
+
+// Hitung baris untuk sisa label node dan keluarkan katanya jika cukup dekat.
+// Baris untuk byte pertama label sudah dihitung induknya (best = nilai
+// terkecilnya), jadi anak yang langsung melewati batas jarak tidak pernah
+// dibaca dari memori. Mengembalikan 1 jika ada anak yang perlu dikunjungi;
+// frame->bytes berisi byte pertama mereka.
+static int enterFuzzyNode(FuzzyWalk *walk, const TrieNode *node, size_t depth, int best, FuzzyFrame *frame)
+{
+    size_t end = depth + node->labelLen;
+    if(!reserveKeyBuffer(&walk->buffer, &walk->cap, end + 2) || !reserveFuzzyRows(walk, end + 2))
+    {
+        walk->stop = 1;
+        return 0;
+    }
+
+    for(size_t i = 1; i < node->labelLen; i++)
+    {
+        walk->buffer[depth + i] = node->label[i];
+        if((best = fuzzyStep(walk, depth + i, node->label[i])) > walk->maxDistance) return 0;
+    }
+
+    // kolom terakhir di luar pita berarti kata terlalu pendek (isinya sisa cabang lain)
+    int distance = end + walk->maxDistance >= walk->queryLen
+                 ? fuzzyRow(walk, end)[walk->queryLen] : walk->maxDistance + 1;
+    if(node->entry && distance <= walk->maxDistance)
+    {
+        walk->buffer[end] = '\0';
+        flushPending(walk, walk->buffer);
+        if(!walk->stop) emitFuzzy(walk, walk->buffer, distance);
+    }
+
+    if(!node->childCount || walk->stop || !fuzzyNextBytes(walk, end, &frame->bytes)) return 0;
+
+    // node anak tersebar di arena: ambil semua calon sekaligus
+    const unsigned char *keys = CHILD_KEYS(node);
+    for(unsigned int i = 0; i < node->childCount; i++)
+        if(BYTESET_HAS(&frame->bytes, keys[i])) __builtin_prefetch(node->children[i]);
+
+    frame->node = node;
+    frame->end = end;
+    frame->next = 0;
+    return 1;
+}
+
+static void fuzzyTrie(FuzzyWalk *walk, const TrieNode *root)
+{
+    FuzzyFrame *stack = NULL;
+    size_t stackCap = 0, top = 0;
+
+    // frame anak langsung diisi di puncak stack, jadi stack selalu disiapkan satu tempat lebih
+    if(!reserveFrames((void **)&stack, &stackCap, 2, sizeof(FuzzyFrame))) return;
+    if(enterFuzzyNode(walk, root, 0, 0, &stack[top])) top++;
+    while(top && !walk->stop)
+    {
+        FuzzyFrame *parent = &stack[top - 1];
+        const TrieNode *node = parent->node;
+        const unsigned char *keys = CHILD_KEYS(node);
+        unsigned int i = parent->next;
+        while(i < node->childCount && !BYTESET_HAS(&parent->bytes, keys[i])) i++;
+        if(i == node->childCount)
+        {
+            top--;
+            continue;
+        }
+        parent->next = i + 1;
+
+        // label dan array anak milik calon berikutnya diambil selagi calon ini diproses
+        for(unsigned int after = i + 1; after < node->childCount; after++)
+        {
+            if(!BYTESET_HAS(&parent->bytes, keys[after])) continue;
+            __builtin_prefetch(node->children[after]->label + 1);
+            __builtin_prefetch(node->children[after]->children);
+            break;
+        }
+
+        size_t end = parent->end;
+        int childBest = fuzzyStep(walk, end, (char)keys[i]);
+        if(childBest > walk->maxDistance) continue;
+        walk->buffer[end] = (char)keys[i];
+        if(!enterFuzzyNode(walk, node->children[i], end, childBest, &stack[top])) continue;
+        if(!reserveFrames((void **)&stack, &stackCap, ++top + 1, sizeof(FuzzyFrame))) walk->stop = 1;
+    }
+    free(stack);
+}
+
+// Jarak key ke query dengan batas kolom walk saat ini, atau maxDistance + 1
+static int fuzzyKeyDistance(FuzzyWalk *walk, const char *key, size_t len)
+{
+    int over = walk->maxDistance + 1;
+    if(!reserveFuzzyRows(walk, len + 1))
+    {
+        walk->stop = 1;
+        return over;
+    }
+
+    fuzzyFirstRow(walk);
+    for(size_t d = 0; d < len; d++)
+        if(fuzzyStep(walk, d, key[d]) > walk->maxDistance) return over;
+    return len + walk->maxDistance >= walk->queryLen ? fuzzyRow(walk, len)[walk->queryLen] : over;
+}
+
+static int compareFuzzyMatch(const void *a, const void *b)
+{
+    return strcmp(((const FuzzyMatch *)a)->word, ((const FuzzyMatch *)b)->word);
+}
+
+// Kata yang memakai semua edit di A (lihat FuzzyWalk) berakhiran B, jadi
+// ada di bucket akhiran query. Kata yang juga lolos dengan batas A sudah
+// dikeluarkan penelusuran trie dan dilewati di sini.
+static void fuzzySuffixMatches(FuzzyWalk *walk, const SuffixIndex *index)
+{
+    const char *tail = walk->query + walk->queryLen - TRIE_SUFFIX_BYTES;
+    const SuffixBucket *bucket = suffixBucket(index, walk->query, walk->queryLen);
+    size_t cap = 0;
+    int prefixDistance = walk->prefixDistance;
+    for(uint32_t i = 0; i < bucket->count && !walk->stop; i++)
+    {
+        const char *key = bucket->keys[i];
+        size_t len = strlen(key);
+        if(memcmp(key + len - TRIE_SUFFIX_BYTES, tail, TRIE_SUFFIX_BYTES) != 0) continue;
+
+        walk->prefixDistance = walk->maxDistance;
+        int distance = fuzzyKeyDistance(walk, key, len);
+        walk->prefixDistance = prefixDistance;
+        if(distance > walk->maxDistance || fuzzyKeyDistance(walk, key, len) <= walk->maxDistance) continue;
+
+        if(!reserveFrames((void **)&walk->pending, &cap, walk->pendingCount + 1, sizeof(FuzzyMatch)))
+        {
+            walk->stop = 1;
+            break;
+        }
+        walk->pending[walk->pendingCount++] = (FuzzyMatch){key, distance};
+    }
+    if(walk->pendingCount) qsort(walk->pending, walk->pendingCount, sizeof(FuzzyMatch), compareFuzzyMatch);
+}
+
+// Bangun indeks akhiran dari semua kata di trie. Kunci diambil lewat
+// internFind, jadi penulis lain ditahan dengan dictWriteBegin selama itu.
+static void suffixReady(Dictionary *dict)
+{
+    if(LOAD_ACQUIRE(&dict->trieSuffixes.buckets)) return;
+
+    trieReady(dict);
+    dictWriteBegin(dict);
+    trieWriteLock(dict);
+    size_t buckets = 16;
+    while(buckets * SUFFIX_LOAD < dict->trieWords) buckets *= 2;
+
+    SuffixIndex index;
+    TrieFrame *stack = NULL;
+    char *buffer = NULL;
+    size_t stackCap = 0, cap = 0, top = 0;
+    int ok = !dict->trieSuffixes.buckets && suffixInit(&index, buckets) &&
+             reserveFrames((void **)&stack, &stackCap, 1, sizeof(TrieFrame));
+    if(ok) stack[top++] = (TrieFrame){dict->trie, 0, 0, 0};
+    while(ok && top)
+    {
+        // end = panjang kunci sebelum label node; buffer di depannya sudah
+        // berisi jalur ke node karena saudara dan turunannya hanya menulis
+        // dari end ke belakang
+        TrieFrame frame = stack[--top];
+        const TrieNode *node = frame.node;
+        size_t end = frame.end + node->labelLen;
+        ok = reserveKeyBuffer(&buffer, &cap, end + 1) &&
+             reserveFrames((void **)&stack, &stackCap, top + node->childCount, sizeof(TrieFrame));
+        if(!ok) break;
+
+        memcpy(buffer + frame.end, node->label, node->labelLen);
+        buffer[end] = '\0';
+        // label menunjuk ke kunci di offset frame.end; jika kunci itu
+        // berakhir di node ini, itulah kunci kata node ini
+        const char *key = node->label - frame.end;
+        if(node->entry && key[end] != '\0') key = internFind(dict, buffer);
+        if(node->entry && key && !suffixPut(&index, key)) ok = 0;
+        for(unsigned int i = 0; i < node->childCount; i++)
+            stack[top++] = (TrieFrame){node->children[i], end, 0, 0};
+    }
+
+    if(ok)
+    {
+        dict->trieSuffixes.mask = index.mask;
+        dict->trieSuffixes.count = index.count;
+        STORE_RELEASE(&dict->trieSuffixes.buckets, index.buckets);
+    }
+    else if(!dict->trieSuffixes.buckets)
+    {
+        fprintf(stderr, "Failed to build the trie suffix index.\n");
+        if(index.buckets) suffixFree(&index);
+    }
+    trieUnlock(dict);
+    dictWriteEnd(dict);
+    free(stack);
+    free(buffer);
+}
+
+// Panggil visit untuk paling banyak k kata (terurut) yang jarak editnya
+// dari word paling banyak maxDistance, beserta jaraknya. Jarak dihitung
+// per byte pada kunci trie, jadi mengganti huruf beraksen dua byte dengan
+// huruf ASCII ("cafe" dan "café") berjarak 2. visit boleh mengembalikan 0
+// untuk berhenti. Mengembalikan jumlah kata, atau TRIE_FUZZY_ERROR jika
+// maxDistance di luar 0..TRIE_FUZZY_DISTANCE. Pencarian jarak 2 pertama
+// membangun indeks akhiran, dan tidak boleh dipanggil sambil memegang
+// dictWriteBegin.
+size_t trieFuzzy(Dictionary *dict, const char *word, int maxDistance, size_t k,
+                 int (*visit)(const char *word, int distance, void *ctx), void *ctx)
+{
+    if(maxDistance < 0 || maxDistance > TRIE_FUZZY_DISTANCE)
+    {
+        fprintf(stderr, "Edit distance %d is not supported by trieFuzzy (0 to %d).\n",
+                maxDistance, TRIE_FUZZY_DISTANCE);
+        return TRIE_FUZZY_ERROR;
+    }
+    if(!dict->trie || k == 0) return 0;
+
+    char *key = copyQueryKey(word);
+    if(!key) return 0;
+
+    FuzzyWalk walk = {0};
+    walk.query = key;
+    walk.queryLen = strlen(key);
+    walk.maxDistance = maxDistance;
+    walk.prefixDistance = maxDistance;
+    walk.width = 2 * (size_t)maxDistance + 3;
+    walk.limit = k;
+    walk.visit = visit;
+    walk.ctx = ctx;
+    int split = maxDistance >= 2 && walk.queryLen >= TRIE_SUFFIX_BYTES;
+    if(reserveFuzzyRows(&walk, 1))
+    {
+        if(split) suffixReady(dict);
+        trieReady(dict);
+        trieReadLock(dict);
+        // tanpa indeks (alokasi gagal) seluruh query dicari di trie
+        if(split && dict->trieSuffixes.buckets)
+        {
+            walk.split = walk.queryLen - TRIE_SUFFIX_BYTES;
+            walk.prefixDistance = maxDistance - 1;
+            fuzzySuffixMatches(&walk, &dict->trieSuffixes);
+        }
+        if(!walk.stop)
+        {
+            fuzzyFirstRow(&walk);
+            fuzzyTrie(&walk, dict->trie);
+        }
+        flushPending(&walk, NULL);
+        trieUnlock(dict);
+    }
+
+    free(walk.pending);
+    free(walk.rows);
+    free(walk.buffer);
+    free(key);
+    return walk.count;
+}
+
+// Hitung node dan array anak; dipanggil dengan dictWriteBegin dipegang
+void trieStats(Dictionary *dict, TrieStats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if(!dict->trie) return;
+
+    TrieFrame *stack = NULL;
+    size_t stackCap = 0, top = 0;
+    trieReady(dict);
+    trieReadLock(dict);
+    if(reserveFrames((void **)&stack, &stackCap, 1, sizeof(TrieFrame)))
+        stack[top++] = (TrieFrame){dict->trie, 0, 0, 0};
+    while(top)
+    {
+        // end = kedalaman node dalam jumlah node
+        TrieFrame frame = stack[--top];
+        const TrieNode *node = frame.node;
+        stats->nodes++;
+        stats->words += node->entry != NULL;
+        stats->childSlots += node->childCap;
+        stats->children += node->childCount;
+        stats->labelBytes += node->labelLen;
+        stats->bytes += sizeof(TrieNode) + (size_t)node->childCap * (sizeof(TrieNode *) + 1);
+        if(frame.end > stats->maxDepth) stats->maxDepth = frame.end;
+        if(!reserveFrames((void **)&stack, &stackCap, top + node->childCount, sizeof(TrieFrame)))
+        {
+            memset(stats, 0, sizeof(*stats));
+            break;
+        }
+        for(unsigned int i = 0; i < node->childCount; i++)
+            stack[top++] = (TrieFrame){node->children[i], frame.end + 1, 0, 0};
+    }
+    trieUnlock(dict);
+    free(stack);
+    stats->arenaBytes = dict->trieArena.reserved;
+}
+
+// Semua TrieNode dan array anak berasal dari trieArena, jadi seluruh trie dilepas sekaligus
+void freeTrieNode(Dictionary *dict)
+{
+    suffixFree(&dict->trieSuffixes);
+    free(dict->trieSeeds);
+    dict->trieSeeds = NULL;
+    dict->trieSeedCount = dict->trieSeedCap = 0;
+    dict->triePending = 0;
+    if(dict->trie == NULL) return;
+    arenaFree(&dict->trieArena);
+    slabReset(&dict->trieSlab);
+    for(int k = 0; k < TRIE_CHILD_CLASSES; k++) slabReset(&dict->childSlabs[k]);
+    dict->trie = NULL;
+    dict->trieWords = 0;
+}
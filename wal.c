@@ -0,0 +1,605 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dictionary_private.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <time.h>
+#endif
+
+// Write-ahead log: setiap perubahan kamus dan setiap riwayat ditambahkan ke
+// log (dict->walFile), jadi sesi yang crash tidak kehilangan apa pun yang
+// sudah di-sync. File dasar (file teks, snapshot, dan riwayat) hanya ditulis
+// ulang saat log dipadatkan, bukan setiap keluar.
+//
+// Record: [u32 panjang isi][isi: 1 byte op, tiap string u32 panjang + byte]
+// [u32 checksum isi], semua angka little-endian. Record yang terpotong atau
+// rusak di ujung log (crash saat menulis) diabaikan dan dibuang.
+//
+// Pemadatan: log sekarang dipindah ke dict->walOldFile dan log baru dibuka;
+// hanya itu yang ditunggu penulis. Thread pemadat lalu memuat file dasar ke
+// kamus terpisah, memutar log lama di atasnya, menulis file dasar baru dari
+// kamus itu, dan menghapus log lama. Saat startup log lama (jika ada) lalu
+// log sekarang diputar ulang di atas file dasar.
+//
+// Generasi: setiap log baru diawali record WAL_OP_GENERATION dengan nomor
+// yang naik setiap pemadatan (log tanpa record itu dianggap generasi 1).
+// Snapshot dan file riwayat menyimpan generasi terakhir yang sudah masuk ke
+// dalamnya, dan record dari generasi itu atau sebelumnya dilewati saat
+// diputar ulang. Jadi crash di antara penggantian file dasar dan penghapusan
+// log lama tidak menggandakan riwayat. Kamus yang dimuat dari file teks
+// tidak tahu generasinya dan memutar ulang semua record kata; itu aman
+// karena record kata hanya ditulis jika operasinya benar-benar mengubah
+// kamus, jadi memutarnya lagi di atas kamus yang sudah memuatnya tidak
+// mengubah hasilnya.
+//
+// State log ada di kamus (dict->wal), dan nama log diturunkan dari file dasar
+// kamus (lihat dictionaryCreate), jadi kamus dengan file dasar berbeda
+// masing-masing punya log sendiri.
+
+typedef struct WalState
+{
+    FILE *file;
+    const char *path;       // dict->walFile
+    const char *oldPath;    // dict->walOldFile
+    char *buffer;           // record yang belum ditulis ke file
+    size_t length, cap;
+    char *spare;            // buffer kedua untuk thread flusher
+    size_t spareCap;
+    size_t fileBytes;       // ukuran log termasuk isi buffer
+    int syncMs;             // 0 = tulis dan fsync setiap operasi
+    uint64_t generation;    // generasi log yang sedang ditulis
+#ifndef _WIN32
+    pthread_mutex_t lock;   // buffer dan fileBytes
+    pthread_mutex_t io;     // file; selalu diambil setelah lock
+    pthread_cond_t wake;
+    pthread_t flusher;
+    int flusherRunning;
+    int stop;
+    pthread_t compactor;    // thread pemadat
+    int compacting;         // 1 sampai compactor di-join
+    int compactDone;        // diisi compactor saat selesai (atomik)
+    int compactOk;
+#endif
+} WalState;
+
+// Pemadatan yang sedang berjalan: generasi terakhir di log lama
+typedef struct Compaction
+{
+    Dictionary *dict;       // hanya nama filenya yang dibaca
+    uint64_t generation;
+} Compaction;
+
+#ifndef _WIN32
+#define WAL_LOCK() pthread_mutex_lock(&wal->lock)
+#define WAL_UNLOCK() pthread_mutex_unlock(&wal->lock)
+#define WAL_IO_LOCK() pthread_mutex_lock(&wal->io)
+#define WAL_IO_UNLOCK() pthread_mutex_unlock(&wal->io)
+#else
+#define WAL_LOCK()
+#define WAL_UNLOCK()
+#define WAL_IO_LOCK()
+#define WAL_IO_UNLOCK()
+#endif
+
+static uint32_t walChecksum(const unsigned char *data, size_t size)
+{
+    uint32_t h = 2166136261u;
+    for(size_t i = 0; i < size; i++) h = (h ^ data[i]) * 16777619u;
+    return h;
+}
+
+static void putU32(unsigned char *p, uint32_t v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static uint32_t getU32(const unsigned char *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static int reserveBuffer(char **buffer, size_t *cap, size_t needed)
+{
+    if(needed <= *cap) return 1;
+
+    size_t newCap = *cap ? *cap : 4096;
+    while(newCap < needed) newCap *= 2;
+    char *grown = (char *)realloc(*buffer, newCap);
+    if(!grown) return 0;
+    *buffer = grown;
+    *cap = newCap;
+    return 1;
+}
+
+// Tulis data ke log dan paksa ke disk; dipanggil dengan io terkunci
+static int writeLog(WalState *wal, const char *data, size_t size)
+{
+    if(!wal->file) return 0;
+    if(size && fwrite(data, 1, size, wal->file) != size) return 0;
+    return fflush(wal->file) == 0 && syncFile(wal->file);
+}
+
+// Tulis semua record di buffer; dipanggil dengan lock dan io terkunci
+static int flushBuffer(WalState *wal)
+{
+    int ok = writeLog(wal, wal->buffer, wal->length);
+    wal->length = 0;
+    return ok;
+}
+
+#ifndef _WIN32
+// Group commit: semua record dalam satu interval ditulis dengan satu fsync.
+// Buffer ditukar dengan buffer cadangan, jadi walAppend tidak menunggu disk.
+static void *flushWorker(void *arg)
+{
+    WalState *wal = (WalState *)arg;
+    pthread_mutex_lock(&wal->lock);
+    while(!wal->stop)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += wal->syncMs / 1000;
+        deadline.tv_nsec += (long)(wal->syncMs % 1000) * 1000000L;
+        if(deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while(!wal->stop && pthread_cond_timedwait(&wal->wake, &wal->lock, &deadline) == 0);
+        if(!wal->length) continue;
+
+        char *data = wal->buffer;
+        size_t size = wal->length;
+        size_t cap = wal->cap;
+        wal->buffer = wal->spare;
+        wal->cap = wal->spareCap;
+        wal->length = 0;
+        wal->spare = data;
+        wal->spareCap = cap;
+
+        pthread_mutex_lock(&wal->io);
+        pthread_mutex_unlock(&wal->lock);
+        if(!writeLog(wal, data, size)) fprintf(stderr, "Failed to write %s.\n", wal->path);
+        pthread_mutex_unlock(&wal->io);
+        pthread_mutex_lock(&wal->lock);
+    }
+    pthread_mutex_unlock(&wal->lock);
+    return NULL;
+}
+#endif
+
+// Ukuran record dengan argumen a dan b (b boleh NULL)
+static size_t recordSize(const char *a, const char *b)
+{
+    return 4 + 1 + 4 + (a ? strlen(a) : 0) + (b ? 4 + strlen(b) : 0) + 4;
+}
+
+// Susun satu record di out (minimal recordSize byte); mengembalikan ukurannya
+static size_t encodeRecord(unsigned char *out, char op, const char *a, const char *b)
+{
+    size_t lenA = a ? strlen(a) : 0, lenB = b ? strlen(b) : 0;
+    size_t body = 1 + 4 + lenA + (b ? 4 + lenB : 0);
+    unsigned char *start = out + 4, *p = start;
+    putU32(out, (uint32_t)body);
+    *p++ = (unsigned char)op;
+    putU32(p, (uint32_t)lenA);
+    memcpy(p + 4, a, lenA);
+    p += 4 + lenA;
+    if(b)
+    {
+        putU32(p, (uint32_t)lenB);
+        memcpy(p + 4, b, lenB);
+        p += 4 + lenB;
+    }
+    putU32(p, walChecksum(start, body));
+    return 4 + body + 4;
+}
+
+// Tulis record generasi di awal log yang baru dibuka, langsung ke disk
+// supaya tidak ada record lain yang mendahuluinya; dipanggil dengan io
+// terkunci dan buffer kosong
+static int writeGeneration(WalState *wal)
+{
+    char text[24];
+    unsigned char record[64];
+    snprintf(text, sizeof(text), "%llu", (unsigned long long)wal->generation);
+    size_t size = encodeRecord(record, WAL_OP_GENERATION, text, NULL);
+    wal->fileBytes += size;
+    return writeLog(wal, (const char *)record, size);
+}
+
+static size_t replayLog(Dictionary *dict, const char *filename, size_t *fileSize, uint64_t *generation);
+
+static int baseExists(const char *filename)
+{
+    FILE *fp = fopen(filename, "rb");
+    if(fp) fclose(fp);
+    return fp != NULL;
+}
+
+// Bangun file dasar baru dari file dasar lama ditambah log lama di kamus
+// terpisah, lalu buang log yang sudah masuk. Dari kamus yang sedang dipakai
+// hanya nama filenya yang dibaca, jadi penulis tidak perlu ditahan dan isinya
+// tepat sama dengan keadaan saat log dipindah.
+static int writeBase(Dictionary *dict, uint64_t generation)
+{
+    // file yang belum ada dilewati supaya thread ini tidak mencetak apa pun
+    int synonyms = baseExists(dict->synonymFile) || baseExists(dict->snapshotFile);
+    int history = dict->historyFile && baseExists(dict->historyFile);
+    Dictionary *base = dictionaryCreate(synonyms ? dict->synonymFile : NULL, history ? dict->historyFile : NULL);
+    if(!base) return 0;
+    loadDictionary(base);
+    size_t oldSize;
+    uint64_t last;
+    replayLog(base, dict->walOldFile, &oldSize, &last);
+
+    size_t snapshotSize = 0, historySize = 0;
+    char *snapshot = snapshotImage(base, generation, &snapshotSize);
+    char *historyData = historyText(base, generation, &historySize);
+    dictionaryFree(base);
+
+    int ok = snapshot && historyData &&
+             saveSnapshotText(snapshot, dict->synonymFile) &&
+             writeReplacement(dict->snapshotFile, snapshot, snapshotSize) &&  // setelah teks supaya lebih baru
+             (!dict->historyFile || writeReplacement(dict->historyFile, historyData, historySize));
+    if(ok) remove(dict->walOldFile);
+    free(snapshot);
+    free(historyData);
+    return ok;
+}
+
+// Pindahkan log sekarang ke log lama. Jika pemadatan sebelumnya gagal dan
+// log lama masih ada, log sekarang disambung ke belakangnya.
+static int rotateLog(WalState *wal)
+{
+    FILE *old = fopen(wal->oldPath, "rb");
+    if(!old) return rename(wal->path, wal->oldPath) == 0;
+    fclose(old);
+
+    MappedFile current;
+    if(!mapFile(wal->path, &current)) return 0;
+    old = fopen(wal->oldPath, "ab");
+    int ok = old != NULL;
+    if(ok)
+    {
+        if(current.size) ok = fwrite(current.data, 1, current.size, old) == current.size;
+        ok = ok && fflush(old) == 0 && syncFile(old);
+        ok = fclose(old) == 0 && ok;
+    }
+    unmapFile(&current);
+    return ok && remove(wal->path) == 0;
+}
+
+#ifndef _WIN32
+static void *compactWorker(void *arg)
+{
+    Compaction *job = (Compaction *)arg;
+    WalState *wal = job->dict->wal;
+    wal->compactOk = writeBase(job->dict, job->generation);
+    free(job);
+    __atomic_store_n(&wal->compactDone, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// Periksa thread pemadat; block = 1 menunggu sampai selesai
+static void reapCompaction(WalState *wal, int block)
+{
+    if(!wal->compacting) return;
+    if(!block && !__atomic_load_n(&wal->compactDone, __ATOMIC_ACQUIRE)) return;
+
+    pthread_join(wal->compactor, NULL);
+    wal->compacting = 0;
+    if(!wal->compactOk)
+        fprintf(stderr, "Log compaction failed; %s is kept and replayed on next start.\n", wal->oldPath);
+}
+#endif
+
+// Pindahkan log lalu tulis file dasar di thread pemadat. Penulis hanya
+// menunggu log dipindah; dictWriteBegin dipegang pemanggil supaya pemadatan
+// tidak dimulai dua kali.
+static void startCompaction(Dictionary *dict)
+{
+    WalState *wal = dict->wal;
+#ifndef _WIN32
+    if(wal->compacting) return;
+#endif
+
+    // log lama berisi generasi sampai folded, log baru mulai dari folded + 1
+    uint64_t folded = wal->generation;
+    WAL_LOCK();
+    WAL_IO_LOCK();
+    int ok = flushBuffer(wal);
+    fclose(wal->file);
+    ok = ok && rotateLog(wal);
+    wal->file = fopen(wal->path, "ab");
+    if(wal->file && ok)
+    {
+        wal->generation++;
+        wal->fileBytes = 0;
+        if(!writeGeneration(wal))
+        {
+            // record tanpa generasi akan dianggap sudah masuk file dasar
+            fclose(wal->file);
+            wal->file = NULL;
+        }
+    }
+    WAL_IO_UNLOCK();
+    WAL_UNLOCK();
+
+    if(!wal->file) fprintf(stderr, "Failed to reopen %s.\n", wal->path);
+    if(!ok) return;
+
+#ifndef _WIN32
+    Compaction *job = (Compaction *)malloc(sizeof(Compaction));
+    if(job)
+    {
+        job->dict = dict;
+        job->generation = folded;
+        wal->compactDone = 0;
+        if(pthread_create(&wal->compactor, NULL, compactWorker, job) == 0)
+        {
+            wal->compacting = 1;
+            return;
+        }
+        free(job);
+    }
+#endif
+    if(!writeBase(dict, folded))
+        fprintf(stderr, "Log compaction failed; %s is kept and replayed on next start.\n", wal->oldPath);
+}
+
+// Tambahkan satu record. Di mode sinkron (syncMs 0) record sudah di disk
+// saat fungsi ini kembali; selain itu paling lambat syncMs kemudian.
+void walAppend(Dictionary *dict, char op, const char *a, const char *b)
+{
+    WalState *wal = dict->wal;
+    if(!wal || !wal->file) return;
+
+    size_t record = recordSize(a, b);
+    WAL_LOCK();
+    if(!reserveBuffer(&wal->buffer, &wal->cap, wal->length + record))
+    {
+        WAL_UNLOCK();
+        fprintf(stderr, "Failed to allocate memory for %s.\n", wal->path);
+        return;
+    }
+    encodeRecord((unsigned char *)wal->buffer + wal->length, op, a, b);
+    wal->length += record;
+    wal->fileBytes += record;
+
+    if(wal->syncMs == 0)
+    {
+        WAL_IO_LOCK();
+        if(!flushBuffer(wal)) fprintf(stderr, "Failed to write %s.\n", wal->path);
+        WAL_IO_UNLOCK();
+    }
+    int full = wal->fileBytes > WAL_COMPACT_BYTES;
+    WAL_UNLOCK();
+
+#ifndef _WIN32
+    reapCompaction(wal, 0);
+#endif
+    if(full) startCompaction(dict);
+}
+
+// Tulis dan fsync semua record yang masih di buffer
+int walSync(Dictionary *dict)
+{
+    WalState *wal = dict->wal;
+    if(!wal || !wal->file) return 1;
+
+    WAL_LOCK();
+    WAL_IO_LOCK();
+    int ok = flushBuffer(wal);
+    WAL_IO_UNLOCK();
+    WAL_UNLOCK();
+    return ok;
+}
+
+static void applyRecord(Dictionary *dict, char op, const char *a, const char *b)
+{
+    WordEntry *entry;
+    switch(op)
+    {
+    case WAL_OP_ADD_WORD:
+        if(!findWord(dict, a)) insertWordEntry(dict, a);
+        break;
+    case WAL_OP_ADD_SYNONYM:
+        if((entry = findWord(dict, a))) appendSynonym(dict, entry, internString(dict, b));
+        break;
+    case WAL_OP_DELETE_WORD:
+        removeWordEntry(dict, a);
+        break;
+    case WAL_OP_DELETE_SYNONYM:
+        if((entry = findWord(dict, a))) removeSynonym(dict, entry, b);
+        break;
+    case WAL_OP_HISTORY:
+        pushLoadedHistory(dict, a, b);
+        break;
+    }
+}
+
+// Baca satu string "u32 panjang + byte" ke scratch (diakhiri '\0')
+static const unsigned char *readString(const unsigned char *p, const unsigned char *end,
+                                       char **scratch, size_t *cap, size_t at, size_t *len)
+{
+    if(end - p < 4) return NULL;
+    *len = getU32(p);
+    p += 4;
+    if((size_t)(end - p) < *len || !reserveBuffer(scratch, cap, at + *len + 1)) return NULL;
+    memcpy(*scratch + at, p, *len);
+    (*scratch)[at + *len] = '\0';
+    return p + *len;
+}
+
+// Putar ulang log di atas kamus yang sudah dimuat, kecuali record dari
+// generasi yang sudah ada di file dasar. Mengembalikan panjang bagian log
+// yang sah; sisanya (record terpotong) diabaikan. *generation diisi
+// generasi record terakhir, 0 jika log kosong.
+static size_t replayLog(Dictionary *dict, const char *filename, size_t *fileSize, uint64_t *generation)
+{
+    uint64_t current = 1;
+    *generation = 0;
+    MappedFile file;
+    *fileSize = 0;
+    if(!mapFile(filename, &file)) return 0;
+    *fileSize = file.size;
+
+    const unsigned char *data = (const unsigned char *)file.data;
+    size_t pos = 0;
+    char *scratch = NULL;
+    size_t cap = 0;
+    while(file.size - pos >= 8)
+    {
+        size_t body = getU32(data + pos);
+        if(body < 5 || body > file.size - pos - 8) break;
+
+        const unsigned char *start = data + pos + 4, *end = start + body;
+        if(getU32(end) != walChecksum(start, body)) break;
+
+        char op = (char)start[0];
+        int twoArgs = op != WAL_OP_ADD_WORD && op != WAL_OP_DELETE_WORD && op != WAL_OP_GENERATION;
+        size_t lenA, lenB = 0;
+        const unsigned char *p = readString(start + 1, end, &scratch, &cap, 0, &lenA);
+        if(p && twoArgs) p = readString(p, end, &scratch, &cap, lenA + 1, &lenB);
+        if(!p || p != end) break;
+
+        uint64_t folded = op == WAL_OP_HISTORY ? dict->historyGeneration : dict->wordGeneration;
+        if(op == WAL_OP_GENERATION) current = strtoull(scratch, NULL, 10);
+        else if(current > folded) applyRecord(dict, op, scratch, twoArgs ? scratch + lenA + 1 : NULL);
+        pos += 4 + body + 4;
+        *generation = current;
+    }
+
+    free(scratch);
+    unmapFile(&file);
+    return pos;
+}
+
+// Buang ekor log yang rusak supaya record baru tidak tertulis di belakangnya
+static void truncateLog(const char *filename, size_t validBytes)
+{
+    MappedFile file;
+    if(!mapFile(filename, &file)) return;
+
+    char *tmpName;
+    FILE *fp = openReplacement(filename, &tmpName);
+    if(fp)
+    {
+        int ok = validBytes == 0 || fwrite(file.data, 1, validBytes, fp) == validBytes;
+        commitReplacement(fp, tmpName, filename, ok);
+    }
+    unmapFile(&file);
+}
+
+// Putar ulang log yang tersisa dari sesi sebelumnya dan buka log untuk
+// sesi ini. Dipanggil setelah loadDictionary; kamus tanpa file dasar tidak
+// punya log.
+void walOpen(Dictionary *dict)
+{
+    if(dict->wal || !dict->synonymFile) return;
+
+    size_t oldSize, size;
+    uint64_t oldGeneration, generation;
+    replayLog(dict, dict->walOldFile, &oldSize, &oldGeneration);
+    size_t valid = replayLog(dict, dict->walFile, &size, &generation);
+    if(valid < size)
+    {
+        fprintf(stderr, "Dropping %zu damaged bytes at the end of %s.\n", size - valid, dict->walFile);
+        truncateLog(dict->walFile, valid);
+    }
+
+    WalState *wal = (WalState *)calloc(1, sizeof(WalState));
+    if(wal) wal->file = fopen(dict->walFile, "ab");
+    if(!wal || !wal->file)
+    {
+        printf("Failed to open %s; changes will not be saved.\n", dict->walFile);
+        free(wal);
+        return;
+    }
+    wal->path = dict->walFile;
+    wal->oldPath = dict->walOldFile;
+    wal->fileBytes = valid;
+    wal->generation = generation;
+    if(!valid)
+    {
+        // log baru: generasinya lebih besar dari semua yang sudah ada
+        if(oldGeneration > generation) generation = oldGeneration;
+        if(dict->wordGeneration > generation) generation = dict->wordGeneration;
+        if(dict->historyGeneration > generation) generation = dict->historyGeneration;
+        wal->generation = generation + 1;
+        if(!writeGeneration(wal))
+        {
+            printf("Failed to write %s; changes will not be saved.\n", dict->walFile);
+            fclose(wal->file);
+            free(wal);
+            return;
+        }
+    }
+    wal->syncMs = WAL_SYNC_MS;
+    const char *env = getenv("SYNONYM_WAL_SYNC_MS");
+    if(env && atoi(env) >= 0) wal->syncMs = atoi(env);
+    dict->wal = wal;
+
+#ifndef _WIN32
+    pthread_mutex_init(&wal->lock, NULL);
+    pthread_mutex_init(&wal->io, NULL);
+    pthread_cond_init(&wal->wake, NULL);
+    wal->stop = 0;
+    if(wal->syncMs > 0)
+        wal->flusherRunning = pthread_create(&wal->flusher, NULL, flushWorker, wal) == 0;
+    if(!wal->flusherRunning) wal->syncMs = 0;
+#else
+    wal->syncMs = 0;
+#endif
+
+    // sisa pemadatan yang gagal atau log yang sudah besar langsung dipadatkan
+    FILE *old = fopen(dict->walOldFile, "rb");
+    int leftover = old != NULL;
+    if(old) fclose(old);
+    if(leftover || wal->fileBytes > WAL_COMPACT_BYTES)
+    {
+        dictWriteBegin(dict);
+        startCompaction(dict);
+        dictWriteEnd(dict);
+    }
+}
+
+// Sync log terakhir kali, hentikan flusher dan tunggu pemadatan yang berjalan
+void walClose(Dictionary *dict)
+{
+    WalState *wal = dict->wal;
+    if(!wal) return;
+
+#ifndef _WIN32
+    if(wal->flusherRunning)
+    {
+        pthread_mutex_lock(&wal->lock);
+        wal->stop = 1;
+        pthread_cond_signal(&wal->wake);
+        pthread_mutex_unlock(&wal->lock);
+        pthread_join(wal->flusher, NULL);
+        wal->flusherRunning = 0;
+    }
+#endif
+
+    if(!walSync(dict)) fprintf(stderr, "Failed to write %s.\n", wal->path);
+
+#ifndef _WIN32
+    reapCompaction(wal, 1);
+    pthread_mutex_destroy(&wal->lock);
+    pthread_mutex_destroy(&wal->io);
+    pthread_cond_destroy(&wal->wake);
+#endif
+
+    fclose(wal->file);
+    free(wal->buffer);
+    free(wal->spare);
+    free(wal);
+    dict->wal = NULL;
+}